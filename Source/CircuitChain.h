@@ -0,0 +1,131 @@
+/*
+  ==============================================================================
+
+    CircuitChain.h
+    Created: 18 Oct 2026 5:02:47pm
+    Author:  Richie Haynes
+
+    The plug-in's signal path for both channels: pre-gain input stage
+    (optional) into the post-gain tone/volume stage. This is the unit that
+    CircuitSwap rebuilds and crossfades when the topology changes. build( )
+    also analyses the chain's tail, so it runs on the builder thread and the
+    result arrives with the chain's atomic hand-over.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include "FilterObjects.h"
+#include "WdfAnalysis.h"
+
+/**
+\struct CircuitChain
+\brief
+Per-channel circuits plus the topology switch.
+*/
+struct CircuitChain
+{
+    static const int numChannels = 2;
+
+    WDFPreGainDistortionCircuit preGainCircuit[numChannels];
+    WDFPostGainDistortionCircuit postGainCircuit[numChannels];
+    bool preGainEnabled = true;     ///< false bypasses the input stage
+    double tone = 0.0;              ///< values the post-gain circuits were last built/updated with
+    double volume = 0.0;
+    double tailSeconds = 0.0;       ///< analysis of the chain as built
+    double outputGain = 0.0;
+
+    /** build and initialise every circuit and analyse the chain; not for the audio thread */
+    void build(double sampleRate, double _tone, double _volume, bool _preGainEnabled)
+    {
+        preGainEnabled = _preGainEnabled;
+        tone = _tone;
+        volume = _volume;
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            preGainCircuit[channel].createWDF();
+            preGainCircuit[channel].reset(sampleRate);
+
+            postGainCircuit[channel].setTone(tone);
+            postGainCircuit[channel].setVolume(volume);
+            postGainCircuit[channel].createWDF();
+            postGainCircuit[channel].reset(sampleRate);
+        }
+
+        // --- both channels share component values, so channel 0 stands for the pair
+        IAudioSignalProcessor* chain[2];
+        const int numCircuits = getCircuits(0, chain);
+        WdfAnalysis analysis;
+        WdfTailAnalysis result;
+        analysis.prepare(preGainCircuit[0].getNumStateRegisters() + postGainCircuit[0].getNumStateRegisters());
+        analysis.analyse(chain, numCircuits, sampleRate, result);
+        tailSeconds = result.tailSeconds;
+        outputGain = result.outputGain;
+    }
+
+    /** move to new tone/volume in place, keeping the state (no allocation) */
+    void setParameters(double _tone, double _volume)
+    {
+        tone = _tone;
+        volume = _volume;
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            postGainCircuit[channel].setTone(tone);
+            postGainCircuit[channel].setVolume(volume);
+            postGainCircuit[channel].updateComponents();
+        }
+    }
+
+    /** install precomputed coefficients (PresetBank) on every channel; no chain initialisation,
+        state kept. tone/volume record the values the coefficients stand for. */
+    void setCoefficients(const double* preGainCoefficients, const double* postGainCoefficients, double _tone, double _volume)
+    {
+        tone = _tone;
+        volume = _volume;
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            preGainCircuit[channel].setCoefficients(preGainCoefficients);
+            postGainCircuit[channel].setCoefficients(postGainCoefficients);
+            postGainCircuit[channel].setTone(tone);
+            postGainCircuit[channel].setVolume(volume);
+        }
+    }
+
+    /** install post-gain coefficients only (CoefficientCache hit); the input stage does not depend
+        on tone/volume. State kept. */
+    void setPostGainCoefficients(const double* postGainCoefficients, double _tone, double _volume)
+    {
+        tone = _tone;
+        volume = _volume;
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            postGainCircuit[channel].setCoefficients(postGainCoefficients);
+            postGainCircuit[channel].setTone(tone);
+            postGainCircuit[channel].setVolume(volume);
+        }
+    }
+
+    /** run one sample of a channel through the chain */
+    double processAudioSample(int channel, double xn)
+    {
+        if (preGainEnabled)
+            xn = preGainCircuit[channel].processAudioSample(xn);
+
+        return postGainCircuit[channel].processAudioSample(xn);
+    }
+
+    /** the circuits a channel's signal passes through, in order; returns how many */
+    int getCircuits(int channel, IAudioSignalProcessor** circuits)
+    {
+        int count = 0;
+        if (preGainEnabled)
+            circuits[count++] = &preGainCircuit[channel];
+
+        circuits[count++] = &postGainCircuit[channel];
+        return count;
+    }
+};
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    CircuitCheckpoint.h
+    Created: 18 Oct 2026 1:02:11pm
+    Author:  Richie Haynes
+
+    Compact binary checkpoint of an offline render: the input position, the
+    circuit parameters and every channel's WDF state registers. Registers are
+    stored as raw IEEE doubles so a resumed render is bit-identical to an
+    uninterrupted one.
+
+    Layout (host byte order, little-endian on every target we build for):
+        char[4] 'WDFK' | uint32 version | uint64 frame | uint64 totalFrames
+        float64 sampleRate | float64 tone | float64 volume | uint32 channels
+        per channel: uint32 count | float64 registers[count]
+        uint32 FNV-1a checksum of everything before it
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+\struct CircuitCheckpoint
+\brief
+In-memory form of a render checkpoint plus save/load to the binary format above.
+*/
+struct CircuitCheckpoint
+{
+    static const uint32_t version = 1;
+
+    uint64_t framePosition = 0;     ///< next input frame to render
+    uint64_t totalFrames = 0;       ///< input length, to reject checkpoints of other files
+    double sampleRate = 0.0;
+    double tone = 0.0;
+    double volume = 0.0;
+    std::vector<std::vector<double>> channelRegisters;  ///< per channel: pre-gain then post-gain registers
+
+    /** write atomically (temp file + rename) so a crash never leaves a torn checkpoint */
+    bool save(const std::string& path, std::string& error) const
+    {
+        std::vector<uint8_t> bytes;
+        bytes.insert(bytes.end(), { 'W', 'D', 'F', 'K' });
+        put(bytes, version);
+        put(bytes, framePosition);
+        put(bytes, totalFrames);
+        put(bytes, sampleRate);
+        put(bytes, tone);
+        put(bytes, volume);
+        put(bytes, (uint32_t)channelRegisters.size());
+
+        for (auto& registers : channelRegisters)
+        {
+            put(bytes, (uint32_t)registers.size());
+            for (double value : registers)
+                put(bytes, value);
+        }
+        put(bytes, checksum(bytes.data(), bytes.size()));
+
+        std::string temporaryPath = path + ".tmp";
+        FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+        if (file == nullptr)
+        {
+            error = "cannot write " + temporaryPath;
+            return false;
+        }
+
+        bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        written = std::fflush(file) == 0 && written;
+        written = fsync(fileno(file)) == 0 && written;
+        std::fclose(file);
+
+        if (!written || std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        {
+            error = "cannot write " + path;
+            return false;
+        }
+        return true;
+    }
+
+    /** read and validate; returns false on a missing, truncated or corrupt file */
+    bool load(const std::string& path, std::string& error)
+    {
+        std::vector<uint8_t> bytes;
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr)
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+
+        uint8_t chunk[4096];
+        size_t count;
+        while ((count = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+            bytes.insert(bytes.end(), chunk, chunk + count);
+        std::fclose(file);
+
+        error = "corrupt checkpoint " + path;
+        if (bytes.size() < 8 || std::memcmp(bytes.data(), "WDFK", 4) != 0)
+            return false;
+
+        size_t bodySize = bytes.size() - sizeof(uint32_t);
+        size_t position = bodySize;
+        uint32_t storedChecksum;
+        if (!get(bytes, position, storedChecksum) || storedChecksum != checksum(bytes.data(), bodySize))
+            return false;
+
+        bytes.resize(bodySize);
+        position = 4;
+        uint32_t storedVersion, numChannels;
+        if (!get(bytes, position, storedVersion) || storedVersion != version
+            || !get(bytes, position, framePosition) || !get(bytes, position, totalFrames)
+            || !get(bytes, position, sampleRate) || !get(bytes, position, tone) || !get(bytes, position, volume)
+            || !get(bytes, position, numChannels))
+            return false;
+
+        channelRegisters.assign(numChannels, {});
+        for (auto& registers : channelRegisters)
+        {
+            uint32_t numRegisters;
+            if (!get(bytes, position, numRegisters) || numRegisters > (bytes.size() - position) / sizeof(double))
+                return false;
+
+            registers.resize(numRegisters);
+            for (double& value : registers)
+                get(bytes, position, value);
+        }
+
+        error.clear();
+        return position == bytes.size();
+    }
+
+private:
+    template <typename T>
+    static void put(std::vector<uint8_t>& bytes, T value)
+    {
+        uint8_t raw[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        bytes.insert(bytes.end(), raw, raw + sizeof(T));
+    }
+
+    template <typename T>
+    static bool get(const std::vector<uint8_t>& bytes, size_t& position, T& value)
+    {
+        if (position + sizeof(T) > bytes.size())
+            return false;
+
+        std::memcpy(&value, bytes.data() + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    static uint32_t checksum(const uint8_t* data, size_t size)
+    {
+        uint32_t hash = 2166136261u;
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ data[i]) * 16777619u;
+        return hash;
+    }
+};
@@ -0,0 +1,204 @@
+/*
+  ==============================================================================
+
+    CircuitSwap.h
+    Created: 18 Oct 2026 4:48:19pm
+    Author:  Richie Haynes
+
+    Double-buffered holder for the running circuit. A replacement is built
+    and initialised on a background thread and published through an atomic
+    pointer; the audio thread adopts it at the start of a block and runs old
+    and new side by side through a short equal-power crossfade. The outgoing
+    instance is handed back through a second atomic slot and deleted on the
+    builder thread. The audio thread only ever exchanges pointers: it never
+    locks, waits or allocates.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+\class CircuitSwap
+\brief
+Owns the active circuit (any default-constructible type) and swaps in rebuilt
+ones with a crossfade.
+*/
+template <typename Circuit>
+class CircuitSwap
+{
+public:
+    /** configures and initialises a freshly constructed circuit; runs on the builder thread */
+    using Builder = std::function<void(Circuit&)>;
+
+    ~CircuitSwap() { stop(); }
+
+    /** set the crossfade length and install a first circuit built synchronously;
+        call while the audio thread is stopped */
+    void prepare(double sampleRate, double fadeSeconds, const Builder& build)
+    {
+        stop();
+
+        fadeGainsOld.resize((size_t)std::max(1, (int)(sampleRate * fadeSeconds)));
+        fadeGainsNew.resize(fadeGainsOld.size());
+        for (size_t i = 0; i < fadeGainsOld.size(); i++)
+        {
+            // --- equal power: gOld^2 + gNew^2 = 1
+            double phase = 0.5 * kPi * (double)(i + 1) / (double)fadeGainsOld.size();
+            fadeGainsOld[i] = (float)std::cos(phase);
+            fadeGainsNew[i] = (float)std::sin(phase);
+        }
+
+        active.reset(new Circuit);
+        build(*active);
+
+        quit = false;
+        worker = std::thread([this] { run(); });
+    }
+
+    /** stop the builder thread and free every circuit but the active one: published, retired or
+        still fading out; call while the audio thread is stopped */
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+            requested = nullptr;
+        }
+        wakeup.notify_one();
+
+        if (worker.joinable())
+            worker.join();
+
+        delete pending.exchange(nullptr);
+        delete retired.exchange(nullptr);
+        delete fadingOut;
+        fadingOut = nullptr;
+        fadePosition = 0;
+    }
+
+    /** ask for a replacement built by build (message thread); a newer request replaces an unstarted one */
+    void requestSwap(Builder build)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requested = std::move(build);
+        }
+        wakeup.notify_one();
+    }
+
+    /** audio thread, start of block: adopt a published replacement unless a crossfade is still running.
+        Returns the newly adopted circuit (so the caller can bring it up to date) or nullptr. */
+    Circuit* beginBlock()
+    {
+        if (fadingOut != nullptr)
+            return nullptr;
+
+        Circuit* next = pending.exchange(nullptr, std::memory_order_acquire);
+        if (next == nullptr)
+            return nullptr;
+
+        fadingOut = active.release();
+        active.reset(next);
+        fadePosition = 0;
+        return next;
+    }
+
+    /** audio thread, end of block: once the crossfade has finished, hand the old circuit back for deletion */
+    void endBlock()
+    {
+        if (fadingOut == nullptr || fadePosition < (int)fadeGainsOld.size())
+            return;
+
+        // --- if the builder has not collected the previous one yet, try again next block
+        Circuit* expected = nullptr;
+        if (retired.compare_exchange_strong(expected, fadingOut, std::memory_order_release))
+            fadingOut = nullptr;
+    }
+
+    /** the circuit whose output is (or is fading towards) the result */
+    Circuit& getActive() { return *active; }
+
+    /** the circuit being faded out, or nullptr */
+    Circuit* getFadingOut() { return fadePosition < (int)fadeGainsOld.size() ? fadingOut : nullptr; }
+
+    /** true while old and new must both be processed */
+    bool isCrossfading() const { return fadingOut != nullptr && fadePosition < (int)fadeGainsOld.size(); }
+
+    /** crossfade gains for sample offset i of the current block; both 0/1 outside the fade */
+    void getFadeGains(int i, float& oldGain, float& newGain) const
+    {
+        int position = fadePosition + i;
+        if (position >= (int)fadeGainsOld.size())
+        {
+            oldGain = 0.0f;
+            newGain = 1.0f;
+            return;
+        }
+        oldGain = fadeGainsOld[position];
+        newGain = fadeGainsNew[position];
+    }
+
+    /** advance the crossfade after processing numSamples */
+    void advance(int numSamples)
+    {
+        if (fadingOut != nullptr)
+            fadePosition = std::min(fadePosition + numSamples, (int)fadeGainsOld.size());
+    }
+
+private:
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (!quit)
+        {
+            // --- the audio thread never signals; retired circuits are collected on this poll
+            delete retired.exchange(nullptr, std::memory_order_acquire);
+
+            if (requested)
+            {
+                Builder build = std::move(requested);
+                requested = nullptr;
+                lock.unlock();
+
+                // --- allocation and initialisation happen here, never on the audio thread
+                Circuit* next = new Circuit;
+                build(*next);
+                delete pending.exchange(next, std::memory_order_release);   // drop an unadopted predecessor
+
+                lock.lock();
+                continue;
+            }
+
+            wakeup.wait_for(lock, std::chrono::milliseconds(50));
+        }
+    }
+
+    static constexpr double kPi = 3.14159265358979323846;
+
+    std::unique_ptr<Circuit> active;
+    Circuit* fadingOut = nullptr;           ///< audio thread only
+    int fadePosition = 0;                   ///< audio thread only
+    std::vector<float> fadeGainsOld;
+    std::vector<float> fadeGainsNew;
+
+    std::atomic<Circuit*> pending { nullptr };  ///< builder -> audio thread
+    std::atomic<Circuit*> retired { nullptr };  ///< audio thread -> builder
+
+    Builder requested;
+    bool quit = false;
+    std::mutex mutex;                       ///< message and builder threads only
+    std::condition_variable wakeup;
+    std::thread worker;
+};
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    CoefficientCache.h
+    Created: 18 Oct 2026 5:41:09pm
+    Author:  Richie Haynes
+
+    Small fixed-capacity cache of post-gain coefficient sets, keyed by the
+    quantised tone/volume resistances and the sample rate. A hit copies the
+    stored set into the circuit with setCoefficients( ) and skips the
+    initialize( ) cascade entirely; automation sweeps and batch renders keep
+    returning to the same positions. Each set carries the tail length and
+    output gain of the chain it was analysed in, so a hit costs a copy and
+    no re-analysis; the key's variant tells chain topologies apart.
+
+    Lock-free for any number of readers and writers: every slot is a
+    seqlock. Readers copy the slot and treat it as a miss if the sequence
+    moved meanwhile; writers claim a slot with a compare-and-swap and simply
+    skip the insert if another writer holds it. Payload words are relaxed
+    atomics, so the copies are race-free under the C++ memory model.
+    Eviction is least-recently-used by a global use stamp.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+/**
+\class CoefficientCache
+\brief
+Lock-free LRU cache of coefficient sets with hit/miss counters.
+*/
+class CoefficientCache
+{
+public:
+    static const int capacity = 64;             ///< slots
+    static const int maxCoefficients = 64;      ///< per set
+    static constexpr double resolution = 0.01;  ///< key quantum for resistances (ohms)
+
+    /** quantised lookup key */
+    struct Key
+    {
+        uint64_t resistances = 0;   ///< tone and volume in units of resolution, 32 bits each
+        uint64_t sampleRate = 0;    ///< bit pattern of the sample rate
+        uint32_t variant = 0;       ///< caller-defined, e.g. the chain topology of the stored analysis
+
+        bool operator==(const Key& other) const { return resistances == other.resistances && sampleRate == other.sampleRate && variant == other.variant; }
+    };
+
+    /** analysis stored with a set */
+    struct Analysis
+    {
+        double tailSeconds = 0.0;   ///< -120 dB tail of the chain the set was analysed in
+        double outputGain = 0.0;    ///< that chain's state-to-output gain bound
+    };
+
+    /** build the key for a parameter position */
+    static Key makeKey(double tone, double volume, double sampleRate, uint32_t variant = 0)
+    {
+        Key key;
+        key.resistances = ((uint64_t)quantise(tone) << 32) | (uint64_t)quantise(volume);
+        std::memcpy(&key.sampleRate, &sampleRate, sizeof(double));
+        key.variant = variant;
+        return key;
+    }
+
+    /** copy the set stored for key into coefficients, and its analysis into analysis if given;
+        returns false on a miss (including a slot caught mid-update) */
+    bool lookup(const Key& key, double* coefficients, int& numCoefficients, Analysis* analysis = nullptr)
+    {
+        for (Slot& slot : slots)
+        {
+            uint32_t before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0 || !slot.used.load(std::memory_order_relaxed) || !matches(slot, key))
+                continue;
+
+            int count = slot.numCoefficients.load(std::memory_order_relaxed);
+            for (int i = 0; i < count; i++)
+                coefficients[i] = slot.coefficients[i].load(std::memory_order_relaxed);
+
+            Analysis stored;
+            stored.tailSeconds = slot.tailSeconds.load(std::memory_order_relaxed);
+            stored.outputGain = slot.outputGain.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != before)
+                break;
+
+            numCoefficients = count;
+            if (analysis != nullptr)
+                *analysis = stored;
+            slot.lastUse.store(++useClock, std::memory_order_relaxed);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /** store a set in the slot already holding key, else the least recently used one; returns false
+        if the set is too large or the slot was being written by another thread (the insert is then
+        simply dropped) */
+    bool insert(const Key& key, const double* coefficients, int numCoefficients)
+    {
+        return insert(key, coefficients, numCoefficients, Analysis());
+    }
+
+    /** as above, storing the analysis of the chain the set came from alongside it */
+    bool insert(const Key& key, const double* coefficients, int numCoefficients, const Analysis& analysis)
+    {
+        if (numCoefficients > maxCoefficients)
+            return false;
+
+        Slot* victim = &slots[0];
+        uint64_t oldest = UINT64_MAX;
+        for (Slot& slot : slots)
+        {
+            if (!slot.used.load(std::memory_order_relaxed))
+            {
+                victim = &slot;
+                oldest = 0;
+                continue;
+            }
+
+            if (matches(slot, key))
+            {
+                victim = &slot;
+                break;
+            }
+
+            uint64_t lastUse = slot.lastUse.load(std::memory_order_relaxed);
+            if (lastUse < oldest)
+            {
+                oldest = lastUse;
+                victim = &slot;
+            }
+        }
+
+        uint32_t sequence = victim->sequence.load(std::memory_order_relaxed);
+        if ((sequence & 1) != 0 || !victim->sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_acquire))
+            return false;
+        std::atomic_thread_fence(std::memory_order_release);
+
+        victim->resistances.store(key.resistances, std::memory_order_relaxed);
+        victim->sampleRate.store(key.sampleRate, std::memory_order_relaxed);
+        victim->variant.store(key.variant, std::memory_order_relaxed);
+        victim->tailSeconds.store(analysis.tailSeconds, std::memory_order_relaxed);
+        victim->outputGain.store(analysis.outputGain, std::memory_order_relaxed);
+        victim->numCoefficients.store(numCoefficients, std::memory_order_relaxed);
+        for (int i = 0; i < numCoefficients; i++)
+            victim->coefficients[i].store(coefficients[i], std::memory_order_relaxed);
+        victim->lastUse.store(++useClock, std::memory_order_relaxed);
+        victim->used.store(true, std::memory_order_relaxed);
+
+        victim->sequence.store(sequence + 2, std::memory_order_release);
+        return true;
+    }
+
+    /** drop every entry (not concurrently with lookup/insert) and zero the counters */
+    void clear()
+    {
+        for (Slot& slot : slots)
+            slot.used.store(false);
+
+        hits = 0;
+        misses = 0;
+    }
+
+    uint64_t getHits() const { return hits.load(); }
+    uint64_t getMisses() const { return misses.load(); }
+
+    /** fraction of lookups that hit, 0 before the first lookup */
+    double getHitRate() const
+    {
+        uint64_t total = getHits() + getMisses();
+        return total > 0 ? (double)getHits() / (double)total : 0.0;
+    }
+
+private:
+    static uint32_t quantise(double resistance)
+    {
+        return (uint32_t)std::fmin(std::fmax(std::round(resistance / resolution), 0.0), 4294967295.0);
+    }
+
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence { 0 };   ///< odd while a writer owns the slot
+        std::atomic<bool> used { false };
+        std::atomic<uint64_t> resistances { 0 };
+        std::atomic<uint64_t> sampleRate { 0 };
+        std::atomic<uint32_t> variant { 0 };
+        std::atomic<uint64_t> lastUse { 0 };
+        std::atomic<double> tailSeconds { 0.0 };
+        std::atomic<double> outputGain { 0.0 };
+        std::atomic<int> numCoefficients { 0 };
+        std::atomic<double> coefficients[maxCoefficients];
+    };
+
+    static bool matches(const Slot& slot, const Key& key)
+    {
+        return slot.resistances.load(std::memory_order_relaxed) == key.resistances
+            && slot.sampleRate.load(std::memory_order_relaxed) == key.sampleRate
+            && slot.variant.load(std::memory_order_relaxed) == key.variant;
+    }
+
+    Slot slots[capacity];
+    std::atomic<uint64_t> useClock { 0 };
+    std::atomic<uint64_t> hits { 0 };
+    std::atomic<uint64_t> misses { 0 };
+};
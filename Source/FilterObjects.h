@@ -9,6 +9,44 @@
 */
 #pragma once
 
+#include <cmath>
+#include <cstdint>
+
+// --- what the reactive components do to a value before storing it in a state register, so a
+//     decaying tail never reaches the (very slow) denormal range, whatever the host's FTZ/DAZ mode:
+//     0 = nothing, 1 = flush magnitudes below WdfDenormalGuard::threshold to zero (default),
+//     2 = move the value towards zero by an offset far below audibility, so a tail settles into a
+//         +-offset hover instead of decaying; the sign comes from the value, so no DC builds up
+#ifndef WDF_DENORMAL_POLICY
+ #define WDF_DENORMAL_POLICY 1
+#endif
+
+/**
+\class WdfDenormalGuard
+\ingroup WDF-Objects
+\brief
+Conditions values written to a component's state register according to WDF_DENORMAL_POLICY.
+Components hold one guard per register. The guard is stateless under every policy, so a reset
+circuit and a restored snapshot (getStateRegisters( )) replay bit for bit.
+*/
+struct WdfDenormalGuard
+{
+    static constexpr double threshold = 1.0e-30;    ///< policy 1: ~600 dB below full scale, far above the denormal range
+    static constexpr double offset = 1.0e-25;       ///< policy 2; results are 0 or at least ulp(offset), never denormal
+
+    /** the value to store in place of x */
+    double operator()(double x)
+    {
+       #if WDF_DENORMAL_POLICY == 1
+        return std::fabs(x) < threshold ? 0.0 : x;
+       #elif WDF_DENORMAL_POLICY == 2
+        return x - std::copysign(offset, x);
+       #else
+        return x;
+       #endif
+    }
+};
+
 
 class IAudioSignalProcessor
 {
@@ -54,6 +92,25 @@ public:
         // --- do nothing
         return false; // NOT handled
     }
+
+    /** number of state registers held by the object; see getStateRegisters( ) */
+    virtual int getNumStateRegisters() { return 0; }
+
+    /** copy the object's state registers into registers[0 .. getNumStateRegisters( )) for snapshots/checkpoints */
+    virtual void getStateRegisters(double* registers) {}
+
+    /** restore state registers previously captured with getStateRegisters( ); the object must be configured identically */
+    virtual void setStateRegisters(const double* registers) {}
+
+    /** number of precomputed coefficients (component values, port resistances, scattering coefficients) */
+    virtual int getNumCoefficients() { return 0; }
+
+    /** copy coefficients into coefficients[0 .. getNumCoefficients( )) */
+    virtual void getCoefficients(double* coefficients) {}
+
+    /** install coefficients captured with getCoefficients( ) from an identically built object; nothing is recalculated */
+    virtual void setCoefficients(const double* coefficients) {}
+
     virtual ~IAudioSignalProcessor() {}
 
 };
@@ -133,6 +190,24 @@ public:
 
     /** get a component value */
     virtual double getComponentValue() { return 0.0; }
+
+    /** number of state registers (z^-1 storage and stored port values) held by the object */
+    virtual int getNumStateRegisters() { return 0; }
+
+    /** copy state registers into registers[0 .. getNumStateRegisters( )) */
+    virtual void getStateRegisters(double* registers) {}
+
+    /** restore state registers captured with getStateRegisters( ) */
+    virtual void setStateRegisters(const double* registers) {}
+
+    /** number of precomputed coefficients (component values, port resistances, scattering coefficients) */
+    virtual int getNumCoefficients() { return 0; }
+
+    /** copy coefficients into coefficients[0 .. getNumCoefficients( )) */
+    virtual void getCoefficients(double* coefficients) {}
+
+    /** install coefficients captured with getCoefficients( ) from an identically built object; nothing is recalculated */
+    virtual void setCoefficients(const double* coefficients) {}
     
     virtual ~IComponentAdaptor() {}
 
@@ -213,6 +288,15 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** coefficients: component value and simulated resistance */
+    virtual int getNumCoefficients() { return 2; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue; coefficients[1] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue = coefficients[0]; componentResistance = coefficients[1]; }
+
 protected:
     double zRegister = 0.0;            ///< storage register (not used with resistor)
     double componentValue = 0.0;    ///< component value in electronic form (ohm, farad, henry)
@@ -224,6 +308,8 @@ protected:
 \class WdfDiode
 \ingroup WDF-Objects
 \brief
+Experimental GZ34 diode as a port 3 component; not wave-correct. WdfDiodeRoot (WdfDiode.h)
+solves the same diode explicitly as the root of a tree.
 */
 
 class WdfGZ34Diode : public IComponentAdaptor
@@ -290,7 +376,7 @@ public:
     /** set input value into component; NOTE: diode is dead-end energy sink so this function does nothing */
     virtual void setInput(double in) {
         
-        zRegister = in;
+        zRegister = guardState(in);
     }
     
 
@@ -299,8 +385,28 @@ public:
 
     
     
+
+    /** state: incident wave register and last reflected output */
+    virtual int getNumStateRegisters() { return 2; }
+
+    /** copy the registers out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister; registers[1] = outValue; }
+
+    /** restore the registers */
+    virtual void setStateRegisters(const double* registers) { zRegister = registers[0]; outValue = registers[1]; }
+
+    /** coefficients: component value and simulated resistance */
+    virtual int getNumCoefficients() { return 2; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue; coefficients[1] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue = coefficients[0]; componentResistance = coefficients[1]; }
+
 protected:
     double zRegister = 0.0;            ///< storage register (not used with resistor)
+    WdfDenormalGuard guardState;    ///< conditions zRegister writes
     double nextRegister = 0.0;
     double outValue;
     double componentValue = 0.0;    ///< component value in electronic form (ohm, farad, henry)
@@ -373,7 +479,7 @@ public:
     virtual void reset(double _sampleRate) { setSampleRate(_sampleRate); zRegister = 0.0; }
 
     /** set input value into component; NOTE: capacitor sets value into register*/
-    virtual void setInput(double in) { zRegister = in; }
+    virtual void setInput(double in) { zRegister = guardState(in); }
 
     /** get output value; NOTE: capacitor produces reflected output */
     virtual double getOutput() { return zRegister; }    // z^-1
@@ -396,8 +502,27 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the z^-1 storage register */
+    virtual int getNumStateRegisters() { return 1; }
+
+    /** copy the storage register out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister; }
+
+    /** restore the storage register */
+    virtual void setStateRegisters(const double* registers) { zRegister = registers[0]; }
+
+    /** coefficients: component value and simulated resistance */
+    virtual int getNumCoefficients() { return 2; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue; coefficients[1] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue = coefficients[0]; componentResistance = coefficients[1]; }
+
 protected:
     double zRegister = 0.0;            ///< storage register (not used with resistor)
+    WdfDenormalGuard guardState;    ///< conditions zRegister writes
     double componentValue = 0.0;    ///< component value in electronic form (ohm, farad, henry)
     double componentResistance = 0.0;///< simulated resistance
     double sampleRate = 0.0;        ///< sample rate
@@ -459,7 +584,7 @@ public:
     virtual void reset(double _sampleRate) { setSampleRate(_sampleRate); zRegister = 0.0; }
 
     /** set input value into component; NOTE: inductor sets value into storage register */
-    virtual void setInput(double in) { zRegister = in; }
+    virtual void setInput(double in) { zRegister = guardState(in); }
 
     /** get output value; NOTE: a WDF inductor produces reflected output that is inverted */
     virtual double getOutput() { return -zRegister; } // -z^-1
@@ -482,8 +607,27 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the z^-1 storage register */
+    virtual int getNumStateRegisters() { return 1; }
+
+    /** copy the storage register out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister; }
+
+    /** restore the storage register */
+    virtual void setStateRegisters(const double* registers) { zRegister = registers[0]; }
+
+    /** coefficients: component value and simulated resistance */
+    virtual int getNumCoefficients() { return 2; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue; coefficients[1] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue = coefficients[0]; componentResistance = coefficients[1]; }
+
 protected:
     double zRegister = 0.0;            ///< storage register (not used with resistor)
+    WdfDenormalGuard guardState;    ///< conditions zRegister writes
     double componentValue = 0.0;    ///< component value in electronic form (ohm, farad, henry)
     double componentResistance = 0.0;///< simulated resistance
     double sampleRate = 0.0;        ///< sample rate
@@ -572,8 +716,8 @@ public:
         double YC = 1.0 / RC;
         double K = (1.0 - RL*YC) / (1.0 + RL*YC);
         double N1 = K*(in - zRegister_L);
-        zRegister_L = N1 + zRegister_C;
-        zRegister_C = in;
+        zRegister_L = guardState_L(N1 + zRegister_C);
+        zRegister_C = guardState_C(in);
     }
 
     /** get output value; NOTE: utput is located in zReg_L */
@@ -597,9 +741,29 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the L and C storage registers */
+    virtual int getNumStateRegisters() { return 2; }
+
+    /** copy the storage registers out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister_L; registers[1] = zRegister_C; }
+
+    /** restore the storage registers */
+    virtual void setStateRegisters(const double* registers) { zRegister_L = registers[0]; zRegister_C = registers[1]; }
+
+    /** coefficients: component values, simulated resistances */
+    virtual int getNumCoefficients() { return 5; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue_L; coefficients[1] = componentValue_C; coefficients[2] = RL; coefficients[3] = RC; coefficients[4] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue_L = coefficients[0]; componentValue_C = coefficients[1]; RL = coefficients[2]; RC = coefficients[3]; componentResistance = coefficients[4]; }
+
 protected:
     double zRegister_L = 0.0; ///< storage register for L
     double zRegister_C = 0.0; ///< storage register for C
+    WdfDenormalGuard guardState_L;  ///< conditions zRegister_L writes
+    WdfDenormalGuard guardState_C;  ///< conditions zRegister_C writes
 
     double componentValue_L = 0.0; ///< component value L
     double componentValue_C = 0.0; ///< component value C
@@ -692,8 +856,8 @@ public:
         double YL = 1.0 / RL;
         double K = (YL*RC - 1.0) / (YL*RC + 1.0);
         double N1 = K*(in - zRegister_L);
-        zRegister_L = N1 + zRegister_C;
-        zRegister_C = in;
+        zRegister_L = guardState_L(N1 + zRegister_C);
+        zRegister_C = guardState_C(in);
     }
 
     /** get output value; NOTE: output is located in -zReg_L */
@@ -717,9 +881,29 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the L and C storage registers */
+    virtual int getNumStateRegisters() { return 2; }
+
+    /** copy the storage registers out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister_L; registers[1] = zRegister_C; }
+
+    /** restore the storage registers */
+    virtual void setStateRegisters(const double* registers) { zRegister_L = registers[0]; zRegister_C = registers[1]; }
+
+    /** coefficients: component values, simulated resistances */
+    virtual int getNumCoefficients() { return 5; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue_L; coefficients[1] = componentValue_C; coefficients[2] = RL; coefficients[3] = RC; coefficients[4] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue_L = coefficients[0]; componentValue_C = coefficients[1]; RL = coefficients[2]; RC = coefficients[3]; componentResistance = coefficients[4]; }
+
 protected:
     double zRegister_L = 0.0; ///< storage register for L
     double zRegister_C = 0.0; ///< storage register for C
+    WdfDenormalGuard guardState_L;  ///< conditions zRegister_L writes
+    WdfDenormalGuard guardState_C;  ///< conditions zRegister_C writes
 
     double componentValue_L = 0.0; ///< component value L
     double componentValue_C = 0.0; ///< component value C
@@ -809,14 +993,14 @@ public:
     virtual void reset(double _sampleRate) { setSampleRate(_sampleRate); zRegister_L = 0.0; zRegister_C = 0.0; }
 
     /** set input value into component */
-    virtual void setInput(double in){ zRegister_L = in; }
+    virtual void setInput(double in){ zRegister_L = guardState_L(in); }
 
     /** get output value; NOTE: see FX book for details */
     virtual double getOutput()
     {
         double NL = -zRegister_L;
         double out = NL*(1.0 - K) - K*zRegister_C;
-        zRegister_C = out;
+        zRegister_C = guardState_C(out);
 
         return out;
     }
@@ -839,9 +1023,29 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the L and C storage registers */
+    virtual int getNumStateRegisters() { return 2; }
+
+    /** copy the storage registers out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister_L; registers[1] = zRegister_C; }
+
+    /** restore the storage registers */
+    virtual void setStateRegisters(const double* registers) { zRegister_L = registers[0]; zRegister_C = registers[1]; }
+
+    /** coefficients: component values, simulated resistances and K */
+    virtual int getNumCoefficients() { return 7; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue_R; coefficients[1] = componentValue_L; coefficients[2] = RL; coefficients[3] = RC; coefficients[4] = RR; coefficients[5] = K; coefficients[6] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue_R = coefficients[0]; componentValue_L = coefficients[1]; RL = coefficients[2]; RC = coefficients[3]; RR = coefficients[4]; K = coefficients[5]; componentResistance = coefficients[6]; }
+
 protected:
     double zRegister_L = 0.0; ///< storage register for L
     double zRegister_C = 0.0;///< storage register for C (not used)
+    WdfDenormalGuard guardState_L;  ///< conditions zRegister_L writes
+    WdfDenormalGuard guardState_C;  ///< conditions zRegister_C writes
     double K = 0.0;
 
     double componentValue_L = 0.0;///< component value L
@@ -933,14 +1137,14 @@ public:
     virtual void reset(double _sampleRate) { setSampleRate(_sampleRate); zRegister_L = 0.0; zRegister_C = 0.0; }
 
     /** set input value into component */
-    virtual void setInput(double in){ zRegister_L = in; }
+    virtual void setInput(double in){ zRegister_L = guardState_L(in); }
 
     /** get output value; NOTE: see FX book for details */
     virtual double getOutput()
     {
         double NL = -zRegister_L;
         double out = NL*(1.0 - K) + K*zRegister_C;
-        zRegister_C = out;
+        zRegister_C = guardState_C(out);
         return out;
     }
 
@@ -962,9 +1166,29 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the L and C storage registers */
+    virtual int getNumStateRegisters() { return 2; }
+
+    /** copy the storage registers out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister_L; registers[1] = zRegister_C; }
+
+    /** restore the storage registers */
+    virtual void setStateRegisters(const double* registers) { zRegister_L = registers[0]; zRegister_C = registers[1]; }
+
+    /** coefficients: component values, simulated resistances and K */
+    virtual int getNumCoefficients() { return 7; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue_R; coefficients[1] = componentValue_L; coefficients[2] = RL; coefficients[3] = RC; coefficients[4] = RR; coefficients[5] = K; coefficients[6] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue_R = coefficients[0]; componentValue_L = coefficients[1]; RL = coefficients[2]; RC = coefficients[3]; RR = coefficients[4]; K = coefficients[5]; componentResistance = coefficients[6]; }
+
 protected:
     double zRegister_L = 0.0;    ///< storage register for L
     double zRegister_C = 0.0;    ///< storage register for L
+    WdfDenormalGuard guardState_L;  ///< conditions zRegister_L writes
+    WdfDenormalGuard guardState_C;  ///< conditions zRegister_C writes
     double K = 0.0;                ///< K value
 
     double componentValue_L = 0.0;    ///< component value L
@@ -1056,14 +1280,14 @@ public:
     virtual void reset(double _sampleRate) { setSampleRate(_sampleRate); zRegister_L = 0.0; zRegister_C = 0.0; }
 
     /** set input value into component */
-    virtual void setInput(double in){ zRegister_L = in; }
+    virtual void setInput(double in){ zRegister_L = guardState_L(in); }
 
     /** get output value; NOTE: see FX book for details */
     virtual double getOutput()
     {
         double NL = zRegister_L;
         double out = NL*(1.0 - K) + K*zRegister_C;
-        zRegister_C = out;
+        zRegister_C = guardState_C(out);
         return out;
     }
 
@@ -1085,9 +1309,29 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the L and C storage registers */
+    virtual int getNumStateRegisters() { return 2; }
+
+    /** copy the storage registers out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister_L; registers[1] = zRegister_C; }
+
+    /** restore the storage registers */
+    virtual void setStateRegisters(const double* registers) { zRegister_L = registers[0]; zRegister_C = registers[1]; }
+
+    /** coefficients: component values, simulated resistances and K */
+    virtual int getNumCoefficients() { return 7; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue_R; coefficients[1] = componentValue_C; coefficients[2] = RL; coefficients[3] = RC; coefficients[4] = RR; coefficients[5] = K; coefficients[6] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue_R = coefficients[0]; componentValue_C = coefficients[1]; RL = coefficients[2]; RC = coefficients[3]; RR = coefficients[4]; K = coefficients[5]; componentResistance = coefficients[6]; }
+
 protected:
     double zRegister_L = 0.0; ///< storage register for L
     double zRegister_C = 0.0; ///< storage register for C
+    WdfDenormalGuard guardState_L;  ///< conditions zRegister_L writes
+    WdfDenormalGuard guardState_C;  ///< conditions zRegister_C writes
     double K = 0.0;
 
     double componentValue_R = 0.0;///< component value R
@@ -1179,14 +1423,14 @@ public:
     virtual void reset(double _sampleRate) { setSampleRate(_sampleRate); zRegister_L = 0.0; zRegister_C = 0.0; }
 
     /** set input value into component; */
-    virtual void setInput(double in){ zRegister_L = in; }
+    virtual void setInput(double in){ zRegister_L = guardState_L(in); }
 
     /** get output value; NOTE: output is located in zRegister_C */
     virtual double getOutput()
     {
         double NL = zRegister_L;
         double out = NL*(1.0 - K) - K*zRegister_C;
-        zRegister_C = out;
+        zRegister_C = guardState_C(out);
         return out;
     }
 
@@ -1208,9 +1452,29 @@ public:
     /** set input3 value; not used for components */
     virtual void setInput3(double _in3) {}
 
+    /** state: the L and C storage registers */
+    virtual int getNumStateRegisters() { return 2; }
+
+    /** copy the storage registers out */
+    virtual void getStateRegisters(double* registers) { registers[0] = zRegister_L; registers[1] = zRegister_C; }
+
+    /** restore the storage registers */
+    virtual void setStateRegisters(const double* registers) { zRegister_L = registers[0]; zRegister_C = registers[1]; }
+
+    /** coefficients: component values, simulated resistances and K */
+    virtual int getNumCoefficients() { return 7; }
+
+    /** copy the coefficients out */
+    virtual void getCoefficients(double* coefficients) { coefficients[0] = componentValue_R; coefficients[1] = componentValue_C; coefficients[2] = RL; coefficients[3] = RC; coefficients[4] = RR; coefficients[5] = K; coefficients[6] = componentResistance; }
+
+    /** install precomputed coefficients without recalculating */
+    virtual void setCoefficients(const double* coefficients) { componentValue_R = coefficients[0]; componentValue_C = coefficients[1]; RL = coefficients[2]; RC = coefficients[3]; RR = coefficients[4]; K = coefficients[5]; componentResistance = coefficients[6]; }
+
 protected:
     double zRegister_L = 0.0; ///< storage register for L
     double zRegister_C = 0.0; ///< storage register for C
+    WdfDenormalGuard guardState_L;  ///< conditions zRegister_L writes
+    WdfDenormalGuard guardState_C;  ///< conditions zRegister_C writes
     double K = 0.0;
 
     double componentValue_C = 0.0;    ///< component value C
@@ -1311,7 +1575,11 @@ class WdfAdaptorBase : public IComponentAdaptor
 {
 public:
     WdfAdaptorBase() {}
-    virtual ~WdfAdaptorBase() {}
+    virtual ~WdfAdaptorBase() { delete wdfComponent; }
+
+    // --- the adaptor owns wdfComponent, and its ports point at other adaptors: not copyable
+    WdfAdaptorBase(const WdfAdaptorBase&) = delete;
+    WdfAdaptorBase& operator=(const WdfAdaptorBase&) = delete;
 
     /** set the termainal (load) resistance for terminating adaptors */
     void setTerminalResistance(double _terminalResistance) { terminalResistance = _terminalResistance; }
@@ -1346,6 +1614,11 @@ public:
     /** creates a new WDF component and connects it to Port 3 */
     void setComponent(wdfComponent componentType, double value1 = 0.0, double value2 = 0.0)
     {
+        // --- the adaptor owns its component; release any previous one
+        delete wdfComponent;
+        wdfComponent = nullptr;
+        port3CompAdaptor = nullptr;
+
         // --- decode and set
         if (componentType == wdfComponent::R)
         {
@@ -1454,7 +1727,127 @@ public:
     /** get adaptor connected at port 3: for extended functionality; not used in WDF ladder filter library */
     IComponentAdaptor* getPort3_CompAdaptor() { return port3CompAdaptor; }
 
+    /** state: the stored port inputs/outputs followed by the owned component's registers;
+        internal node values (N1, N2) are recomputed every sample and are not part of the state */
+    virtual int getNumStateRegisters()
+    {
+        return numPortRegisters + (wdfComponent ? wdfComponent->getNumStateRegisters() : 0);
+    }
+
+    /** copy port values and component registers out */
+    virtual void getStateRegisters(double* registers)
+    {
+        registers[0] = in1; registers[1] = in2; registers[2] = in3;
+        registers[3] = out1; registers[4] = out2; registers[5] = out3;
+
+        if (wdfComponent)
+            wdfComponent->getStateRegisters(registers + numPortRegisters);
+    }
+
+    /** restore port values and component registers */
+    virtual void setStateRegisters(const double* registers)
+    {
+        in1 = registers[0]; in2 = registers[1]; in3 = registers[2];
+        out1 = registers[3]; out2 = registers[4]; out3 = registers[5];
+
+        if (wdfComponent)
+            wdfComponent->setStateRegisters(registers + numPortRegisters);
+    }
+
+    /** capture the registers of several adaptors back to back (helper for circuits) */
+    static void getStateRegisters(WdfAdaptorBase* const* adaptors, int numAdaptors, double* registers)
+    {
+        for (int i = 0; i < numAdaptors; i++)
+        {
+            adaptors[i]->getStateRegisters(registers);
+            registers += adaptors[i]->getNumStateRegisters();
+        }
+    }
+
+    /** restore the registers of several adaptors captured with getStateRegisters(adaptors, ...) */
+    static void setStateRegisters(WdfAdaptorBase* const* adaptors, int numAdaptors, const double* registers)
+    {
+        for (int i = 0; i < numAdaptors; i++)
+        {
+            adaptors[i]->setStateRegisters(registers);
+            registers += adaptors[i]->getNumStateRegisters();
+        }
+    }
+
+    /** total register count of several adaptors */
+    static int getNumStateRegisters(WdfAdaptorBase* const* adaptors, int numAdaptors)
+    {
+        int count = 0;
+        for (int i = 0; i < numAdaptors; i++)
+            count += adaptors[i]->getNumStateRegisters();
+        return count;
+    }
+
+    /** coefficients: port resistances, the adaptor's scattering coefficients, then the owned component's */
+    virtual int getNumCoefficients()
+    {
+        return numPortResistances + getNumScatteringCoefficients() + (wdfComponent ? wdfComponent->getNumCoefficients() : 0);
+    }
+
+    /** copy port resistances, scattering and component coefficients out */
+    virtual void getCoefficients(double* coefficients)
+    {
+        coefficients[0] = R1; coefficients[1] = R2; coefficients[2] = R3;
+        getScatteringCoefficients(coefficients + numPortResistances);
+
+        if (wdfComponent)
+            wdfComponent->getCoefficients(coefficients + numPortResistances + getNumScatteringCoefficients());
+    }
+
+    /** install precomputed coefficients; replaces initialize( ) for an identically built adaptor */
+    virtual void setCoefficients(const double* coefficients)
+    {
+        R1 = coefficients[0]; R2 = coefficients[1]; R3 = coefficients[2];
+        setScatteringCoefficients(coefficients + numPortResistances);
+
+        if (wdfComponent)
+            wdfComponent->setCoefficients(coefficients + numPortResistances + getNumScatteringCoefficients());
+    }
+
+    /** capture the coefficients of several adaptors back to back (helper for circuits) */
+    static void getCoefficients(WdfAdaptorBase* const* adaptors, int numAdaptors, double* coefficients)
+    {
+        for (int i = 0; i < numAdaptors; i++)
+        {
+            adaptors[i]->getCoefficients(coefficients);
+            coefficients += adaptors[i]->getNumCoefficients();
+        }
+    }
+
+    /** install coefficients captured with getCoefficients(adaptors, ...) */
+    static void setCoefficients(WdfAdaptorBase* const* adaptors, int numAdaptors, const double* coefficients)
+    {
+        for (int i = 0; i < numAdaptors; i++)
+        {
+            adaptors[i]->setCoefficients(coefficients);
+            coefficients += adaptors[i]->getNumCoefficients();
+        }
+    }
+
+    /** total coefficient count of several adaptors */
+    static int getNumCoefficients(WdfAdaptorBase* const* adaptors, int numAdaptors)
+    {
+        int count = 0;
+        for (int i = 0; i < numAdaptors; i++)
+            count += adaptors[i]->getNumCoefficients();
+        return count;
+    }
+
 protected:
+    /** number of adaptor-specific scattering coefficients (B, A, ...) */
+    virtual int getNumScatteringCoefficients() { return 0; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients) {}
+
+    /** install the scattering coefficients */
+    virtual void setScatteringCoefficients(const double* coefficients) {}
+
     // --- can in theory connect any port to a component OR adaptor;
     //     though this library is setup with a convention R3 = component
     IComponentAdaptor* port1CompAdaptor = nullptr;    ///< componant or adaptor connected to port 1
@@ -1486,6 +1879,9 @@ protected:
 
     // --- source impedance, OK for this to be set to 0.0 for Rs = 0
     double sourceResistance = 600.0; ///< source impedance; OK for this to be set to 0.0 for Rs = 0
+
+    static const int numPortRegisters = 6; ///< in1..in3, out1..out3
+    static const int numPortResistances = 3; ///< R1, R2, R3
 };
 
 /**
@@ -1565,8 +1961,8 @@ public:
         // --- calc N1
         N1 = -(in1 - B*(in1 + N2 + in2) + in2);
 
-        // --- calc out1
-        out1 = in1 - B*(N2 + in2);
+        // --- calc out1, the wave reflected upstream: b1 = a1 - B(a1 + a2 + a3), as in N1
+        out1 = in1 - B*(in1 + N2 + in2);
 
         // --- deliver upstream
         if (getPort1_CompAdaptor())
@@ -1589,6 +1985,16 @@ public:
     /** get OUT3 always connects to component */
     virtual double getOutput3() { return out3; }
 
+protected:
+    /** scattering coefficients: B */
+    virtual int getNumScatteringCoefficients() { return 1; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients) { coefficients[0] = B; }
+
+    /** install the scattering coefficients */
+    virtual void setScatteringCoefficients(const double* coefficients) { B = coefficients[0]; }
+
 private:
     double N1 = 0.0;    ///< node 1 value, internal use only
     double N2 = 0.0;    ///< node 2 value, internal use only
@@ -1691,6 +2097,16 @@ public:
     /** get OUT3 always connects to component */
     virtual double getOutput3() { return out3; }
 
+protected:
+    /** scattering coefficients: B1, B3 */
+    virtual int getNumScatteringCoefficients() { return 2; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients) { coefficients[0] = B1; coefficients[1] = B3; }
+
+    /** install the scattering coefficients */
+    virtual void setScatteringCoefficients(const double* coefficients) { B1 = coefficients[0]; B3 = coefficients[1]; }
+
 private:
     double N1 = 0.0;    ///< node 1 value, internal use only
     double N2 = 0.0;    ///< node 2 value, internal use only
@@ -1806,6 +2222,16 @@ public:
     /** get OUT3 always connects to component */
     virtual double getOutput3() { return out3; }
 
+protected:
+    /** scattering coefficients: A */
+    virtual int getNumScatteringCoefficients() { return 1; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients) { coefficients[0] = A; }
+
+    /** install the scattering coefficients */
+    virtual void setScatteringCoefficients(const double* coefficients) { A = coefficients[0]; }
+
 private:
     double N1 = 0.0;    ///< node 1 value, internal use only
     double N2 = 0.0;    ///< node 2 value, internal use only
@@ -1911,6 +2337,16 @@ public:
     /** get OUT3 always connects to component */
     virtual double getOutput3() { return out3; }
 
+protected:
+    /** scattering coefficients: A1, A3 */
+    virtual int getNumScatteringCoefficients() { return 2; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients) { coefficients[0] = A1; coefficients[1] = A3; }
+
+    /** install the scattering coefficients */
+    virtual void setScatteringCoefficients(const double* coefficients) { A1 = coefficients[0]; A3 = coefficients[1]; }
+
 private:
     double N1 = 0.0;    ///< node 1 value, internal use only
     double N2 = 0.0;    ///< node 2 value, internal use only
@@ -1918,6 +2354,401 @@ private:
     double A3 = 0.0;    ///< A3 coefficient value
 };
 
+/**
+\struct WdfPickupParameters
+\ingroup WDF-Objects
+\brief
+Guitar pickup and cable: coil resistance and inductance in series with the string voltage, and the
+cable capacitance across the output. The defaults are a single-coil pickup on a few metres of cable.
+*/
+struct WdfPickupParameters
+{
+    double resistance = 6000.0;         ///< coil DC resistance, ohms
+    double inductance = 2.5;            ///< coil inductance, henries
+    double capacitance = 500.0e-12;     ///< cable (plus coil) capacitance, farads
+
+    /** humbucker on the same cable */
+    static WdfPickupParameters humbucker()
+    {
+        WdfPickupParameters parameters;
+        parameters.resistance = 8000.0;
+        parameters.inductance = 4.5;
+        return parameters;
+    }
+
+    /** a plain resistive source, as setSourceResistance( ) */
+    static WdfPickupParameters idealSource(double _resistance)
+    {
+        WdfPickupParameters parameters;
+        parameters.resistance = _resistance;
+        parameters.inductance = 0.0;
+        parameters.capacitance = 0.0;
+        return parameters;
+    }
+};
+
+/**
+\class WdfPickupSource
+\ingroup WDF-Objects
+\brief
+The WdfPickupSource object is a fused input element: a voltage source with a series RL coil and a
+shunt cable capacitance, reflection-free at port 2. Connect it upstream of the tree's first adaptor
+in place of setSourceResistance( ) and push audio into setInput1( ).
+
+The inductor and capacitor are discretised with the trapezoidal rule as in WdfInductor and
+WdfCapacitor. Each has port resistance R and stored wave b, so it is a Thevenin source v = R i + b.
+The coil branch is then a source E1 = Vs - bL of resistance Rs + RL. The cable is a source bC of
+resistance RC. The two in parallel are the port's Thevenin equivalent, so the incident wave sent
+downstream is b2 = gamma E1 + (1 - gamma) bC, with gamma = G1 / (G1 + GC) and R2 = 1 / (G1 + GC).
+When the reflected wave returns, the two stored waves are updated with the port voltage v:
+bL = 2 RL G1 v - (2 RL G1 E1 + bL) and bC = 2 v - bC. The part that does not depend on v is formed
+before the tree is evaluated, so the update adds two operations per wave to the per-sample chain.
+With idealSource( ) the element is exactly a resistive source and skips the update.
+*/
+class WdfPickupSource : public WdfAdaptorBase
+{
+public:
+    WdfPickupSource() {}
+    virtual ~WdfPickupSource() {}
+
+    /** coil and cable values; call initializeAdaptorChain( ) afterwards */
+    void setPickup(const WdfPickupParameters& _parameters) { parameters = _parameters; }
+
+    const WdfPickupParameters& getPickup() const { return parameters; }
+
+    /** flush the coil and cable states */
+    virtual void reset(double _sampleRate)
+    {
+        sampleRate = _sampleRate;
+        coilWave = cableWave = 0.0;
+    }
+
+    /** get the resistance at port 2; (Rs + RL) || RC */
+    virtual double getR2() { return R2; }
+
+    /** initialize from the pickup values and the sample rate; the upstream resistance is not used */
+    virtual void initialize(double _R1)
+    {
+        R1 = _R1;
+
+        // --- trapezoidal port resistances: RL = 2 fs L, GC = 2 fs C
+        double coilResistance = 2.0 * sampleRate * parameters.inductance;
+        double coilConductance = 1.0 / std::fmax(parameters.resistance + coilResistance, 1.0e-9);
+        double cableConductance = 2.0 * sampleRate * parameters.capacitance;
+
+        R2 = 1.0 / (coilConductance + cableConductance);
+        R3 = 0.0;
+        setScatteringCoefficients(coilConductance * R2, 2.0 * coilResistance * coilConductance);
+
+        // --- init downstream adaptor
+        if (getPort2_CompAdaptor())
+            getPort2_CompAdaptor()->initialize(R2);
+    }
+
+    /** push the source voltage; delivers the port's incident wave downstream */
+    virtual void setInput1(double _in1)
+    {
+        // --- save
+        in1 = _in1;
+
+        // --- Thevenin equivalent of the coil branch and the cable, in parallel
+        coilSource = in1 - coilWave;
+        out2 = gamma * coilSource + (1.0 - gamma) * cableWave;
+        coilOffset = coilGain * coilSource + coilWave;
+
+        // --- deliver downstream
+        if (getPort2_CompAdaptor())
+            getPort2_CompAdaptor()->setInput1(out2);
+    }
+
+    /** reflected wave from the tree: update the coil and cable states */
+    virtual void setInput2(double _in2)
+    {
+        // --- save
+        in2 = _in2;
+        if (!reactive)
+            return;
+
+        // --- next stored waves from the port voltage: inductor b = -a, capacitor b = a
+        double voltage = 0.5 * (in2 + out2);
+        coilWave = guardCoil(coilGain * voltage - coilOffset);
+        cableWave = guardCable(2.0 * voltage - cableWave);
+    }
+
+    /** set input 3: not used */
+    virtual void setInput3(double _in3) { }
+
+    /** get OUT1: not used, nothing is connected upstream */
+    virtual double getOutput1() { return out1; }
+
+    /** get OUT2 = incident wave on Port 2 */
+    virtual double getOutput2() { return out2; }
+
+    /** get OUT3: not used */
+    virtual double getOutput3() { return out3; }
+
+    /** port registers followed by the coil and cable waves */
+    virtual int getNumStateRegisters() { return numPortRegisters + 2; }
+
+    /** copy port values and the stored waves out */
+    virtual void getStateRegisters(double* registers)
+    {
+        WdfAdaptorBase::getStateRegisters(registers);
+        registers[numPortRegisters] = coilWave;
+        registers[numPortRegisters + 1] = cableWave;
+    }
+
+    /** restore port values and the stored waves */
+    virtual void setStateRegisters(const double* registers)
+    {
+        WdfAdaptorBase::setStateRegisters(registers);
+        coilWave = registers[numPortRegisters];
+        cableWave = registers[numPortRegisters + 1];
+    }
+
+protected:
+    /** scattering coefficients: gamma, 2 RL G1 */
+    virtual int getNumScatteringCoefficients() { return 2; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients) { coefficients[0] = gamma; coefficients[1] = coilGain; }
+
+    /** install the scattering coefficients */
+    virtual void setScatteringCoefficients(const double* coefficients) { setScatteringCoefficients(coefficients[0], coefficients[1]); }
+
+    /** gamma = 1 and no coil gain is a plain resistive source, with nothing to store */
+    void setScatteringCoefficients(double _gamma, double _coilGain)
+    {
+        gamma = _gamma;
+        coilGain = _coilGain;
+        reactive = gamma != 1.0 || coilGain != 0.0;
+    }
+
+private:
+    WdfPickupParameters parameters;
+    double sampleRate = 0.0;        ///< sample rate
+
+    double gamma = 1.0;             ///< G1 / (G1 + GC), with G1 = 1 / (Rs + RL)
+    double coilGain = 0.0;          ///< 2 RL G1
+    bool reactive = false;          ///< false for idealSource( )
+
+    double coilSource = 0.0;        ///< E1 = Vs - bL of this sample, internal use only
+    double coilOffset = 0.0;        ///< 2 RL G1 E1 + bL of this sample, internal use only
+
+    double coilWave = 0.0;          ///< inductor's stored wave bL
+    double cableWave = 0.0;         ///< capacitor's stored wave bC
+    WdfDenormalGuard guardCoil;
+    WdfDenormalGuard guardCable;
+};
+
+/**
+\struct WdfSpeakerParameters
+\ingroup WDF-Objects
+\brief
+Loudspeaker electrical equivalent: voice-coil resistance and inductance in series with the motional
+impedance, a parallel RLC whose resonance is the cone's. The defaults are a 12" 8 ohm guitar speaker.
+*/
+struct WdfSpeakerParameters
+{
+    double coilResistance = 6.4;            ///< Re, ohms
+    double coilInductance = 0.6e-3;         ///< Le, henries
+    double motionalResistance = 40.0;       ///< Rm = Re Qms / Qes, ohms; 0 for no motional branch
+    double motionalInductance = 12.7e-3;    ///< Lm = Re / (2 pi fs Qes), henries
+    double motionalCapacitance = 199.0e-6;  ///< Cm = Qes / (2 pi fs Re), farads
+
+    /** from Thiele-Small parameters: resonance fs and the mechanical and electrical Q */
+    static WdfSpeakerParameters thieleSmall(double Re, double Le, double fs, double Qms, double Qes)
+    {
+        const double twoPiFs = 2.0 * 3.14159265358979323846 * fs;
+
+        WdfSpeakerParameters parameters;
+        parameters.coilResistance = Re;
+        parameters.coilInductance = Le;
+        parameters.motionalResistance = Re * Qms / Qes;
+        parameters.motionalInductance = Re / (twoPiFs * Qes);
+        parameters.motionalCapacitance = Qes / (twoPiFs * Re);
+        return parameters;
+    }
+
+    /** a plain resistor, as setTerminalResistance( ) */
+    static WdfSpeakerParameters resistiveLoad(double _resistance)
+    {
+        WdfSpeakerParameters parameters;
+        parameters.coilResistance = _resistance;
+        parameters.coilInductance = 0.0;
+        parameters.motionalResistance = 0.0;
+        parameters.motionalInductance = 0.0;
+        parameters.motionalCapacitance = 0.0;
+        return parameters;
+    }
+};
+
+/**
+\class WdfSpeakerLoad
+\ingroup WDF-Objects
+\brief
+The WdfSpeakerLoad object is a fused loudspeaker termination: the root of a tree, connected
+downstream of the last (non-terminated) adaptor in place of setTerminalResistance( ).
+
+Le, Lm and Cm are discretised with the trapezoidal rule as in WdfInductor and WdfCapacitor, so each
+is a Thevenin source v = R i + b with a stored wave b. The motional RLC in parallel is then one
+source eM = (GLm bLm + GCm bCm) Rmech of resistance Rmech = 1 / (1 / Rm + GLm + GCm), and the whole
+speaker is v = Rz i + E with Rz = Re + RLe + Rmech and E = bLe + eM. Against the incident wave
+a = v + R1 i this gives i = (a - E) / (Rz + R1) and the reflected wave b = a - 2 R1 i. The three
+stored waves are then updated from i and the motional voltage. The element replaces three adaptors
+and four components with a dozen operations and no virtual calls.
+With resistiveLoad( ) it is exactly a resistor and skips the update.
+getOutput2( ) is the voltage across the speaker.
+*/
+class WdfSpeakerLoad : public WdfAdaptorBase
+{
+public:
+    WdfSpeakerLoad() {}
+    virtual ~WdfSpeakerLoad() {}
+
+    /** speaker values; re-initialise the chain afterwards */
+    void setSpeaker(const WdfSpeakerParameters& _parameters) { parameters = _parameters; }
+
+    const WdfSpeakerParameters& getSpeaker() const { return parameters; }
+
+    /** flush the coil and motional states */
+    virtual void reset(double _sampleRate)
+    {
+        sampleRate = _sampleRate;
+        coilWave = inductanceWave = capacitanceWave = 0.0;
+    }
+
+    /** the root has no port 2; R2 is the port resistance */
+    virtual double getR2() { return R1; }
+
+    /** port resistance of the upstream adaptor */
+    virtual void initialize(double _R1)
+    {
+        R1 = _R1;
+        R2 = R1;
+
+        // --- trapezoidal port resistances: RLe = 2 fs Le, GLm = 1 / (2 fs Lm), GCm = 2 fs Cm
+        double coilInductanceResistance = 2.0 * sampleRate * parameters.coilInductance;
+        double inductanceConductance = 0.0, capacitanceConductance = 0.0, motionalResistance = 0.0;
+        if (parameters.motionalResistance > 0.0)
+        {
+            inductanceConductance = parameters.motionalInductance > 0.0 ? 1.0 / (2.0 * sampleRate * parameters.motionalInductance) : 0.0;
+            capacitanceConductance = 2.0 * sampleRate * parameters.motionalCapacitance;
+            motionalResistance = 1.0 / (1.0 / parameters.motionalResistance + inductanceConductance + capacitanceConductance);
+        }
+
+        R3 = parameters.coilResistance + coilInductanceResistance + motionalResistance;
+
+        const double coefficients[numSpeakerCoefficients] = {
+            1.0 / (R3 + R1),
+            2.0 * coilInductanceResistance,
+            motionalResistance,
+            inductanceConductance * motionalResistance,
+            capacitanceConductance * motionalResistance };
+        setScatteringCoefficients(coefficients);
+    }
+
+    /** incident wave from the tree; reflects it back upstream */
+    virtual void setInput1(double _in1)
+    {
+        in1 = _in1;
+
+        // --- Thevenin source of the speaker, then the current it draws
+        double motionalSource = inductanceGain * inductanceWave + capacitanceGain * capacitanceWave;
+        double current = (in1 - coilWave - motionalSource) * currentGain;
+
+        out1 = in1 - 2.0 * R1 * current;
+        out2 = 0.5 * (in1 + out1);
+
+        if (reactive)
+        {
+            // --- next stored waves: inductors b = -a, capacitor b = a
+            double motionalVoltage = motionalResistance * current + motionalSource;
+            coilWave = guardCoil(-(coilGain * current + coilWave));
+            inductanceWave = guardInductance(inductanceWave - 2.0 * motionalVoltage);
+            capacitanceWave = guardCapacitance(2.0 * motionalVoltage - capacitanceWave);
+        }
+
+        if (getPort1_CompAdaptor())
+            getPort1_CompAdaptor()->setInput2(out1);
+    }
+
+    /** not used: nothing is connected below the root */
+    virtual void setInput2(double _in2) {}
+
+    /** not used: the root has no component */
+    virtual void setInput3(double _in3) {}
+
+    /** reflected wave */
+    virtual double getOutput1() { return out1; }
+
+    /** speaker voltage */
+    virtual double getOutput2() { return out2; }
+
+    /** not used */
+    virtual double getOutput3() { return out3; }
+
+    /** port registers followed by the voice-coil inductor, motional inductor and capacitor waves */
+    virtual int getNumStateRegisters() { return numPortRegisters + 3; }
+
+    /** copy port values and the stored waves out */
+    virtual void getStateRegisters(double* registers)
+    {
+        WdfAdaptorBase::getStateRegisters(registers);
+        registers[numPortRegisters] = coilWave;
+        registers[numPortRegisters + 1] = inductanceWave;
+        registers[numPortRegisters + 2] = capacitanceWave;
+    }
+
+    /** restore port values and the stored waves */
+    virtual void setStateRegisters(const double* registers)
+    {
+        WdfAdaptorBase::setStateRegisters(registers);
+        coilWave = registers[numPortRegisters];
+        inductanceWave = registers[numPortRegisters + 1];
+        capacitanceWave = registers[numPortRegisters + 2];
+    }
+
+protected:
+    static const int numSpeakerCoefficients = 5;
+
+    /** scattering coefficients: 1 / (Rz + R1), 2 RLe, Rmech, GLm Rmech, GCm Rmech */
+    virtual int getNumScatteringCoefficients() { return numSpeakerCoefficients; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients)
+    {
+        coefficients[0] = currentGain; coefficients[1] = coilGain; coefficients[2] = motionalResistance;
+        coefficients[3] = inductanceGain; coefficients[4] = capacitanceGain;
+    }
+
+    /** install the scattering coefficients; a load with no reactance has nothing to store */
+    virtual void setScatteringCoefficients(const double* coefficients)
+    {
+        currentGain = coefficients[0]; coilGain = coefficients[1]; motionalResistance = coefficients[2];
+        inductanceGain = coefficients[3]; capacitanceGain = coefficients[4];
+        reactive = coilGain != 0.0 || motionalResistance != 0.0;
+    }
+
+private:
+    WdfSpeakerParameters parameters;
+    double sampleRate = 0.0;            ///< sample rate
+
+    double currentGain = 0.0;           ///< 1 / (Rz + R1)
+    double coilGain = 0.0;              ///< 2 RLe
+    double motionalResistance = 0.0;    ///< Rmech
+    double inductanceGain = 0.0;        ///< GLm Rmech
+    double capacitanceGain = 0.0;       ///< GCm Rmech
+    bool reactive = false;              ///< false for resistiveLoad( )
+
+    double coilWave = 0.0;              ///< voice-coil inductor's stored wave bLe
+    double inductanceWave = 0.0;        ///< motional inductor's stored wave bLm
+    double capacitanceWave = 0.0;       ///< motional capacitor's stored wave bCm
+    WdfDenormalGuard guardCoil;
+    WdfDenormalGuard guardInductance;
+    WdfDenormalGuard guardCapacitance;
+};
+
 // ------------------------------------------------------------------------------ //
 // --- WDF Ladder Filter Design  Examples --------------------------------------- //
 // ------------------------------------------------------------------------------ //
@@ -1956,11 +2787,12 @@ public:
     virtual bool reset(double _sampleRate)
     {
         // --- rest WDF components (flush state registers)
+        pickup.reset(_sampleRate);
         seriesAdaptor_R3.reset(_sampleRate);
         seriesAdaptor_C23.reset(_sampleRate);
 
         // --- intialize the chain of adapters
-        seriesAdaptor_R3.initializeAdaptorChain();
+        pickup.initializeAdaptorChain();
         return true;
     }
     
@@ -1969,12 +2801,38 @@ public:
     virtual double processAudioSample(double xn)
     {
         //std::cout << "incoming pre = " << xn << std::endl;
-        // --- push audio sample into series L1
-        seriesAdaptor_R3.setInput1(xn);
+        // --- push audio sample into the source, which feeds series R3
+        pickup.setInput1(xn);
         //std::cout << "outgoing pre = " << seriesAdaptor_C23.getOutput1() << std::endl;
         // --- output is at terminated L2's output2
         return seriesAdaptor_C23.getOutput2();
     }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** precomputed coefficients of every adaptor and component in the tree */
+    virtual int getNumCoefficients() { return WdfAdaptorBase::getNumCoefficients(adaptors, numAdaptors); }
+
+    /** capture the tree's coefficients after reset( )/initializeAdaptorChain( ) */
+    virtual void getCoefficients(double* coefficients) { WdfAdaptorBase::getCoefficients(adaptors, numAdaptors, coefficients); }
+
+    /** install coefficients captured from an identically built circuit; no chain initialisation */
+    virtual void setCoefficients(const double* coefficients) { WdfAdaptorBase::setCoefficients(adaptors, numAdaptors, coefficients); }
+
+    /** drive the circuit from a pickup and cable instead of the plain source resistance; the
+        coefficients change, so a PresetBank must be built from a circuit with the same pickup */
+    void setPickup(const WdfPickupParameters& parameters)
+    {
+        pickup.setPickup(parameters);
+        pickup.initializeAdaptorChain();
+    }
     
     void createWDF()
     {
@@ -1989,17 +2847,25 @@ public:
         seriesAdaptor_C23.setComponent(wdfComponent::C, C23_value);
         
 
-        // --- connect adapters
+        // --- connect adapters; the source (plain resistance by default) is the tree's input
+        WdfAdaptorBase::connectAdaptors(&pickup, &seriesAdaptor_R3);
         WdfAdaptorBase::connectAdaptors(&seriesAdaptor_R3, &seriesAdaptor_C23);
         
-        seriesAdaptor_R3.setSourceResistance(100);
+        pickup.setPickup(WdfPickupParameters::idealSource(sourceResistance));
         seriesAdaptor_C23.setOpenTerminalResistance();
 
     }
     
 protected:
+    double sourceResistance = 100.0;
+
+    WdfPickupSource pickup;
     WdfSeriesAdaptor seriesAdaptor_R3;
     WdfSeriesTerminatedAdaptor seriesAdaptor_C23;
+
+    static const int numAdaptors = 3;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &pickup, &seriesAdaptor_R3, &seriesAdaptor_C23 };
+    static constexpr const char* adaptorNames[numAdaptors] = { "pickup", "seriesAdaptor_R3", "seriesAdaptor_C23" };   ///< for profiling reports
 };
 
 class WDFPostGainDistortionCircuit : public IAudioSignalProcessor
@@ -2021,6 +2887,7 @@ public:
         seriesAdaptor_Tone.reset(_sampleRate);
         parallelAdaptor_C29.reset(_sampleRate);
         parallelAdaptor_Volume.reset(_sampleRate);
+        speaker.reset(_sampleRate);
 
         // --- intialize the chain of adapters
         seriesAdaptor_C3.initializeAdaptorChain();
@@ -2038,11 +2905,46 @@ public:
 
         
         //std::cout << "post = " << parallelAdaptor_C29.getOutput() << std::endl;
-        // --- output is at terminated L2's output2
-        return parallelAdaptor_Volume.getOutput2();
+        // --- output is twice the load voltage, the level of a terminated adaptor's output2
+        return 2.0 * speaker.getOutput2();
         
         
     }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** precomputed coefficients of every adaptor and component in the tree */
+    virtual int getNumCoefficients() { return WdfAdaptorBase::getNumCoefficients(adaptors, numAdaptors); }
+
+    /** capture the tree's coefficients after reset( )/initializeAdaptorChain( ) */
+    virtual void getCoefficients(double* coefficients) { WdfAdaptorBase::getCoefficients(adaptors, numAdaptors, coefficients); }
+
+    /** install coefficients captured from an identically built circuit; no chain initialisation */
+    virtual void setCoefficients(const double* coefficients) { WdfAdaptorBase::setCoefficients(adaptors, numAdaptors, coefficients); }
+
+    /** push the current tone/volume into the existing components and recompute the adaptor
+        coefficients, keeping the state registers (no click, no allocation) */
+    void updateComponents()
+    {
+        seriesAdaptor_Tone.setComponentValue(tone);
+        parallelAdaptor_Volume.setComponentValue(volume);
+        seriesAdaptor_C3.initializeAdaptorChain();
+    }
+
+    /** load the circuit with a loudspeaker instead of the plain load resistance; the coefficients
+        change, so a PresetBank must be built from a circuit with the same speaker */
+    void setSpeaker(const WdfSpeakerParameters& parameters)
+    {
+        speaker.setSpeaker(parameters);
+        seriesAdaptor_C3.initializeAdaptorChain();
+    }
     
     void createWDF()
     {
@@ -2062,14 +2964,15 @@ public:
         parallelAdaptor_Volume.setComponent(wdfComponent::R, Volume_value);
         //seriesTerminatedAdaptor_outR.setComponent(wdfComponent::R, 0.0);
         
-        seriesAdaptor_C3.setSourceResistance(100);
+        seriesAdaptor_C3.setSourceResistance(sourceResistance);
         //parallelAdaptor_Volume.setSourceResistance(1000);
-        parallelAdaptor_Volume.setTerminalResistance(100);
+        speaker.setSpeaker(WdfSpeakerParameters::resistiveLoad(loadResistance));
         
-        // --- connect adapters
+        // --- connect adapters; the load (plain resistance by default) terminates the tree
         WdfAdaptorBase::connectAdaptors(&seriesAdaptor_C3, &seriesAdaptor_Tone);
         WdfAdaptorBase::connectAdaptors(&seriesAdaptor_Tone, &parallelAdaptor_C29);
         WdfAdaptorBase::connectAdaptors(&parallelAdaptor_C29, &parallelAdaptor_Volume);
+        WdfAdaptorBase::connectAdaptors(&parallelAdaptor_Volume, &speaker);
        // WdfAdaptorBase::connectAdaptors(&parallelAdaptor_Volume, &seriesTerminatedAdaptor_outR);
 
     }
@@ -2091,10 +2994,18 @@ public:
     }
     
 protected:
+    double sourceResistance = 100.0;
+    double loadResistance = 100.0;
+
     WdfSeriesAdaptor seriesAdaptor_C3;
     WdfSeriesAdaptor seriesAdaptor_Tone;
     WdfParallelAdaptor parallelAdaptor_C29;
-    WdfParallelTerminatedAdaptor parallelAdaptor_Volume;
+    WdfParallelAdaptor parallelAdaptor_Volume;
+    WdfSpeakerLoad speaker;
+
+    static const int numAdaptors = 5;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_C3, &seriesAdaptor_Tone, &parallelAdaptor_C29, &parallelAdaptor_Volume, &speaker };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_C3", "seriesAdaptor_Tone", "parallelAdaptor_C29", "parallelAdaptor_Volume", "speaker" };   ///< for profiling reports
 };
 
 
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    LoadMonitor.h
+    Created: 18 Oct 2026 8:04:37pm
+    Author:  Richie Haynes
+
+    Message-thread consumers of ProcessLoadMeter: a one-line readout for the
+    editor and an optional file log of the per-window summaries. The log is
+    enabled by pointing the WDF_LOAD_LOG environment variable at a file.
+    Both only exist when WDF_ENABLE_INSTRUMENTATION is non-zero.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <JuceHeader.h>
+#include "ProcessLoadMeter.h"
+
+#if WDF_ENABLE_INSTRUMENTATION
+
+/**
+\class LoadMeterView
+\brief
+Editor readout of the current, p99 and maximum block load plus the event counters.
+*/
+class LoadMeterView : public juce::Component, private juce::Timer
+{
+public:
+    explicit LoadMeterView(const ProcessLoadMeter& _meter) : meter(_meter)
+    {
+        startTimerHz(4);
+    }
+
+    ~LoadMeterView() override { stopTimer(); }
+
+    void paint(juce::Graphics& g) override
+    {
+        // --- red once the worst block of the last window came close to a dropout
+        g.setColour(meter.getWindowMax() > 0.8 ? juce::Colours::red : juce::Colours::white.withAlpha(0.7f));
+        g.setFont(11.0f);
+        g.drawFittedText(text, getLocalBounds(), juce::Justification::centredLeft, 1);
+    }
+
+private:
+    void timerCallback() override
+    {
+        juce::String next = "CPU " + juce::String(100.0 * meter.getCurrentLoad(), 1)
+                          + "%  p99 " + juce::String(100.0 * meter.getWindowP99(), 1)
+                          + "%  max " + juce::String(100.0 * meter.getWindowMax(), 1)
+                          + "%  rebuilds " + juce::String((juce::int64)meter.getRebuilds())
+                          + "  silence resets " + juce::String((juce::int64)meter.getSilenceResets())
+                          + "  overruns " + juce::String((juce::int64)meter.getOverruns());
+
+        if (next != text)
+        {
+            text = next;
+            repaint();
+        }
+    }
+
+    const ProcessLoadMeter& meter;
+    juce::String text;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoadMeterView)
+};
+
+/**
+\class LoadLogger
+\brief
+Drains ProcessLoadMeter's window summaries into a juce::FileLogger once a second.
+The logger is the meter's single summary consumer.
+*/
+class LoadLogger : private juce::Timer
+{
+public:
+    explicit LoadLogger(ProcessLoadMeter& _meter) : meter(_meter)
+    {
+        const juce::String path = juce::SystemStats::getEnvironmentVariable("WDF_LOAD_LOG", {});
+        if (path.isEmpty())
+            return;
+
+        log = std::make_unique<juce::FileLogger>(juce::File(path), "DigitalFilters block load: "
+                                                 "audio seconds, blocks, mean %, p99 %, max %, overruns, rebuilds, silence resets");
+        startTimer(1000);
+    }
+
+    ~LoadLogger() override { stopTimer(); }
+
+    /** true if WDF_LOAD_LOG was set */
+    bool isLogging() const { return log != nullptr; }
+
+private:
+    void timerCallback() override
+    {
+        ProcessLoadMeter::Summary summary;
+        while (meter.popSummary(summary))
+        {
+            log->logMessage(juce::String(summary.endSeconds, 1) + ", " + juce::String(summary.numBlocks)
+                            + ", " + juce::String(100.0 * summary.meanLoad, 2)
+                            + ", " + juce::String(100.0 * summary.p99Load, 2)
+                            + ", " + juce::String(100.0 * summary.maxLoad, 2)
+                            + ", " + juce::String(summary.numOverruns)
+                            + ", " + juce::String((juce::int64)summary.rebuilds)
+                            + ", " + juce::String((juce::int64)summary.silenceResets));
+        }
+    }
+
+    ProcessLoadMeter& meter;
+    std::unique_ptr<juce::FileLogger> log;
+
+    JUCE_DECLARE_NON_COPYABLE (LoadLogger)
+};
+
+#endif
@@ -0,0 +1,412 @@
+/*
+  ==============================================================================
+
+    MappedWavFile.h
+    Created: 18 Oct 2026 9:12:40am
+    Author:  Richie Haynes
+
+    Zero-copy PCM WAV reader and writer for the offline renderer. The file is
+    memory-mapped and samples are converted straight from (or into) the mapped
+    pages, so there is no intermediate read()/write() copy. Consumed regions are
+    handed back to the kernel as the render progresses, which keeps the resident
+    set bounded no matter how long the file is.
+
+    POSIX only (mmap/madvise); used by the render tool, not by the plug-in.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+\class MappedWavFileBase
+\brief
+Shared mapping and sample-format helpers for MappedWavReader and MappedWavWriter.
+Supports 16-bit, 24-bit and 32-bit integer PCM and 32-bit IEEE float, plain or
+WAVE_FORMAT_EXTENSIBLE.
+*/
+class MappedWavFileBase
+{
+public:
+    enum { formatPCM = 1, formatFloat = 3, formatExtensible = 0xFFFE };
+
+    virtual ~MappedWavFileBase() { close(); }
+
+    /** unmap and close the file */
+    void close()
+    {
+        if (base != nullptr)
+            munmap(base, mapSize);
+
+        if (fd >= 0)
+            ::close(fd);
+
+        base = nullptr;
+        mapSize = 0;
+        releasedBytes = 0;
+        fd = -1;
+    }
+
+    bool isOpen() const { return base != nullptr; }
+
+    int getNumChannels() const { return numChannels; }
+    double getSampleRate() const { return sampleRate; }
+    uint64_t getNumFrames() const { return numFrames; }
+    int getBitsPerSample() const { return bitsPerSample; }
+    bool isFloatingPoint() const { return formatTag == formatFloat; }
+
+protected:
+    /** byte offset of a frame inside the mapping */
+    size_t getFrameOffset(uint64_t frame) const { return dataOffset + (size_t)frame * (size_t)frameSize; }
+
+    /** hand everything before endByte back to the kernel; dirty pages are scheduled for write-back first */
+    void releaseUpTo(size_t endByte, bool dirty)
+    {
+        const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+        endByte -= endByte % pageSize;
+
+        if (base == nullptr || endByte <= releasedBytes)
+            return;
+
+        if (dirty)
+            msync(base + releasedBytes, endByte - releasedBytes, MS_ASYNC);
+
+        madvise(base + releasedBytes, endByte - releasedBytes, MADV_DONTNEED);
+        releasedBytes = endByte;
+    }
+
+    static uint16_t readU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+    static uint32_t readU32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+    static void writeU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+    static void writeU32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+
+    /** convert one stored sample to float */
+    float decodeSample(const uint8_t* p) const
+    {
+        if (formatTag == formatFloat)
+        {
+            float f;
+            std::memcpy(&f, p, sizeof(float));
+            return f;
+        }
+
+        if (bitsPerSample == 16)
+            return (float)(int16_t)readU16(p) * (1.0f / 32768.0f);
+
+        if (bitsPerSample == 24)
+        {
+            int32_t v = (int32_t)((uint32_t)p[0] << 8 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 24) >> 8;
+            return (float)v * (1.0f / 8388608.0f);
+        }
+
+        return (float)((double)(int32_t)readU32(p) * (1.0 / 2147483648.0));
+    }
+
+    /** convert one float to the stored format, clipping integer formats */
+    void encodeSample(uint8_t* p, float x) const
+    {
+        if (formatTag == formatFloat)
+        {
+            std::memcpy(p, &x, sizeof(float));
+            return;
+        }
+
+        double clipped = x < -1.0f ? -1.0 : (x > 1.0f ? 1.0 : (double)x);
+
+        if (bitsPerSample == 16)
+        {
+            writeU16(p, (uint16_t)(int16_t)std::lrint(std::fmin(clipped * 32768.0, 32767.0)));
+        }
+        else if (bitsPerSample == 24)
+        {
+            int32_t v = (int32_t)std::lrint(std::fmin(clipped * 8388608.0, 8388607.0));
+            p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16);
+        }
+        else
+        {
+            writeU32(p, (uint32_t)(int32_t)std::llrint(std::fmin(clipped * 2147483648.0, 2147483647.0)));
+        }
+    }
+
+    /** true if the fmt chunk describes something we can convert */
+    bool isSupportedFormat() const
+    {
+        if (numChannels <= 0 || sampleRate <= 0.0)
+            return false;
+
+        if (formatTag == formatFloat)
+            return bitsPerSample == 32;
+
+        return formatTag == formatPCM && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32);
+    }
+
+    int fd = -1;                ///< file descriptor backing the mapping
+    uint8_t* base = nullptr;    ///< start of the mapping
+    size_t mapSize = 0;         ///< mapped length in bytes
+    size_t dataOffset = 0;      ///< offset of the first sample in the data chunk
+    size_t releasedBytes = 0;   ///< page-aligned prefix already returned to the kernel
+
+    int formatTag = formatPCM;  ///< PCM or float (extensible is resolved to its sub-format)
+    int numChannels = 0;        ///< interleaved channel count
+    int bitsPerSample = 0;      ///< container bits per sample
+    int frameSize = 0;          ///< bytes per interleaved frame
+    double sampleRate = 0.0;    ///< sample rate
+    uint64_t numFrames = 0;     ///< frames in the data chunk
+};
+
+/**
+\class MappedWavReader
+\brief
+Read-only mapping of a PCM WAV file; readFrames() de-interleaves directly out of the mapping.
+*/
+class MappedWavReader : public MappedWavFileBase
+{
+public:
+    /** map a file and parse its RIFF header; returns false and fills error on failure */
+    bool open(const std::string& path, std::string& error)
+    {
+        close();
+
+        fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return fail("cannot open " + path, error);
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < 12)
+            return fail("not a WAV file: " + path, error);
+
+        mapSize = (size_t)info.st_size;
+        void* mapping = mmap(nullptr, mapSize, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            return fail("cannot map " + path, error);
+
+        base = (uint8_t*)mapping;
+        madvise(base, mapSize, MADV_SEQUENTIAL);
+
+        if (!parseHeader())
+            return fail("unsupported or malformed WAV file: " + path, error);
+
+        return true;
+    }
+
+    /** convert frames [startFrame, startFrame + frames) into one float buffer per channel */
+    void readFrames(uint64_t startFrame, int frames, float* const* dest) const
+    {
+        const uint8_t* frame = base + getFrameOffset(startFrame);
+        const int bytesPerSample = bitsPerSample / 8;
+
+        for (int i = 0; i < frames; i++, frame += frameSize)
+            for (int channel = 0; channel < numChannels; channel++)
+                dest[channel][i] = decodeSample(frame + channel * bytesPerSample);
+    }
+
+    /** tell the kernel the frames before this position will not be read again */
+    void releaseFramesBefore(uint64_t frame) { releaseUpTo(getFrameOffset(frame), false); }
+
+private:
+    bool fail(const std::string& message, std::string& error)
+    {
+        error = message;
+        close();
+        return false;
+    }
+
+    bool parseHeader()
+    {
+        if (std::memcmp(base, "RIFF", 4) != 0 || std::memcmp(base + 8, "WAVE", 4) != 0)
+            return false;
+
+        bool haveFormat = false;
+        size_t position = 12;
+
+        while (position + 8 <= mapSize)
+        {
+            const uint8_t* chunk = base + position;
+            size_t chunkSize = readU32(chunk + 4);
+
+            if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16 && position + 8 + chunkSize <= mapSize)
+            {
+                formatTag = readU16(chunk + 8);
+                numChannels = readU16(chunk + 10);
+                sampleRate = (double)readU32(chunk + 12);
+                bitsPerSample = readU16(chunk + 22);
+
+                // --- extensible: the real format is the first two bytes of the sub-format GUID
+                if (formatTag == formatExtensible && chunkSize >= 40)
+                    formatTag = readU16(chunk + 32);
+
+                haveFormat = true;
+            }
+            else if (std::memcmp(chunk, "data", 4) == 0 && haveFormat)
+            {
+                if (!isSupportedFormat())
+                    return false;
+
+                frameSize = numChannels * bitsPerSample / 8;
+                dataOffset = position + 8;
+
+                // --- tolerate streamed files whose data size was never patched
+                size_t available = mapSize - dataOffset;
+                if (chunkSize == 0 || chunkSize > available)
+                    chunkSize = available;
+
+                numFrames = chunkSize / (size_t)frameSize;
+                return true;
+            }
+
+            position += 8 + chunkSize + (chunkSize & 1);
+        }
+
+        return false;
+    }
+};
+
+/**
+\class MappedWavWriter
+\brief
+Writable mapping of a WAV file of known length. The file is sized up-front (the renderer
+always knows its output length) so writeFrames() encodes straight into the page cache.
+*/
+class MappedWavWriter : public MappedWavFileBase
+{
+public:
+    ~MappedWavWriter() { close(); }
+
+    /** create (or truncate) a file for the given layout; bitsPerSample 16, 24 or 32, float32 when asFloat is set */
+    bool create(const std::string& path, int _numChannels, double _sampleRate, int _bitsPerSample,
+                bool asFloat, uint64_t _numFrames, std::string& error)
+    {
+        return map(path, _numChannels, _sampleRate, _bitsPerSample, asFloat, _numFrames, createNew, error);
+    }
+
+    /** re-open a partially written file created earlier with the same layout (for resuming a render) */
+    bool openExisting(const std::string& path, int _numChannels, double _sampleRate, int _bitsPerSample,
+                      bool asFloat, uint64_t _numFrames, std::string& error)
+    {
+        return map(path, _numChannels, _sampleRate, _bitsPerSample, asFloat, _numFrames, reopen, error);
+    }
+
+    /** open for writing one chunk of a file that several renderers fill concurrently: creates it
+        if missing, never truncates, and the header every writer stores is identical */
+    bool openShared(const std::string& path, int _numChannels, double _sampleRate, int _bitsPerSample,
+                    bool asFloat, uint64_t _numFrames, std::string& error)
+    {
+        return map(path, _numChannels, _sampleRate, _bitsPerSample, asFloat, _numFrames, shared, error);
+    }
+
+    /** encode frames from one float buffer per channel into the mapping */
+    void writeFrames(uint64_t startFrame, int frames, const float* const* src)
+    {
+        uint8_t* frame = base + getFrameOffset(startFrame);
+        const int bytesPerSample = bitsPerSample / 8;
+
+        for (int i = 0; i < frames; i++, frame += frameSize)
+            for (int channel = 0; channel < numChannels; channel++)
+                encodeSample(frame + channel * bytesPerSample, src[channel][i]);
+    }
+
+    /** schedule write-back of everything before this frame and drop it from the resident set */
+    void flushFramesBefore(uint64_t frame) { releaseUpTo(getFrameOffset(frame), true); }
+
+    /** write back everything and close */
+    void close()
+    {
+        if (base != nullptr)
+            msync(base, mapSize, MS_SYNC);
+
+        MappedWavFileBase::close();
+    }
+
+    /** block until everything written so far is on disk */
+    bool sync() { return fd >= 0 && fsync(fd) == 0; }
+
+private:
+    static const size_t headerSize = 44;
+    static constexpr uint64_t maxRiffSize = 0xFFFFFFFFull;   ///< largest file whose sizes fit the 32-bit header fields
+
+    enum OpenMode { createNew, reopen, shared };
+
+    bool map(const std::string& path, int _numChannels, double _sampleRate, int _bitsPerSample,
+             bool asFloat, uint64_t _numFrames, OpenMode mode, std::string& error)
+    {
+        close();
+
+        formatTag = asFloat ? formatFloat : formatPCM;
+        numChannels = _numChannels;
+        sampleRate = _sampleRate;
+        bitsPerSample = asFloat ? 32 : _bitsPerSample;
+        numFrames = _numFrames;
+
+        if (!isSupportedFormat())
+            return fail("unsupported output format", error);
+
+        frameSize = numChannels * bitsPerSample / 8;
+        dataOffset = headerSize;
+
+        // --- the RIFF and data sizes are 32 bits; larger renders would need RF64
+        if (numFrames > (maxRiffSize - headerSize) / (uint64_t)frameSize)
+            return fail("output exceeds the 4 GB WAV limit", error);
+
+        mapSize = dataOffset + (size_t)numFrames * (size_t)frameSize;
+
+        const int flags[] = { O_RDWR | O_CREAT | O_TRUNC, O_RDWR, O_RDWR | O_CREAT };
+        fd = ::open(path.c_str(), flags[mode], 0644);
+        if (fd < 0)
+            return fail("cannot open " + path, error);
+
+        // --- a shared file may still be empty if another writer has not sized it yet
+        struct stat info;
+        if (mode != createNew && (fstat(fd, &info) != 0 || ((size_t)info.st_size != mapSize && !(mode == shared && info.st_size == 0))))
+            return fail("existing output does not match the render layout: " + path, error);
+
+        if (ftruncate(fd, (off_t)mapSize) != 0)
+            return fail("cannot size " + path, error);
+
+        void* mapping = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED)
+            return fail("cannot map " + path, error);
+
+        base = (uint8_t*)mapping;
+        madvise(base, mapSize, MADV_SEQUENTIAL);
+
+        if (mode != reopen)
+            writeHeader();
+
+        return true;
+    }
+
+    bool fail(const std::string& message, std::string& error)
+    {
+        error = message;
+        MappedWavFileBase::close();
+        return false;
+    }
+
+    void writeHeader()
+    {
+        const uint32_t dataBytes = (uint32_t)(mapSize - headerSize);
+
+        std::memcpy(base, "RIFF", 4);
+        writeU32(base + 4, (uint32_t)(mapSize - 8));
+        std::memcpy(base + 8, "WAVE", 4);
+        std::memcpy(base + 12, "fmt ", 4);
+        writeU32(base + 16, 16);
+        writeU16(base + 20, (uint16_t)formatTag);
+        writeU16(base + 22, (uint16_t)numChannels);
+        writeU32(base + 24, (uint32_t)sampleRate);
+        writeU32(base + 28, (uint32_t)(sampleRate * frameSize));
+        writeU16(base + 32, (uint16_t)frameSize);
+        writeU16(base + 34, (uint16_t)bitsPerSample);
+        std::memcpy(base + 36, "data", 4);
+        writeU32(base + 40, dataBytes);
+    }
+};
@@ -11,11 +11,14 @@
 //#include "FilterObjects.h"
 //==============================================================================
 DigitalFiltersAudioProcessorEditor::DigitalFiltersAudioProcessorEditor (DigitalFiltersAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p), audioProcessor (p), analyserView (p.getAnalyser()), responseView (p)
+   #if WDF_ENABLE_INSTRUMENTATION
+    , loadMeterView (p.getLoadMeter())
+   #endif
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-        setSize (350, 400);
+        setSize (350, 480);
     
     // TONE CONTROL GUI COMPONENTS
     toneControlFreqDial.setSliderStyle(juce::Slider::SliderStyle::RotaryVerticalDrag);
@@ -46,12 +49,32 @@ DigitalFiltersAudioProcessorEditor::DigitalFiltersAudioProcessorEditor (DigitalF
     
     volumeValue = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.tree, "volume", volumeDial);
     
+    // INPUT STAGE TOGGLE
+    filterButton.setButtonText("Input Stage");
+    filterButton.setClickingTogglesState(true);
+    filterButton.setToggleState(audioProcessor.filterToggle != 0, juce::dontSendNotification);
+    filterButton.onClick = [this] { filterButtonClicked(); };
+    addAndMakeVisible(&filterButton);
+    audioProcessor.filterToggleChanged.addChangeListener(this);
+    
+    // OUTPUT SPECTRUM AND SCOPE
+    addAndMakeVisible(&analyserView);
+    
+    // CIRCUIT FREQUENCY RESPONSE
+    addAndMakeVisible(&responseView);
+    
+    // BLOCK LOAD READOUT
+   #if WDF_ENABLE_INSTRUMENTATION
+    addAndMakeVisible(&loadMeterView);
+   #endif
+    
     
     
 }
 
 DigitalFiltersAudioProcessorEditor::~DigitalFiltersAudioProcessorEditor()
 {
+    audioProcessor.filterToggleChanged.removeChangeListener(this);
 }
 
 //==============================================================================
@@ -72,10 +95,20 @@ void DigitalFiltersAudioProcessorEditor::resized()
     
     volumeDial.setBounds(50, 150, 100, 100);
     toneControlFreqDial.setBounds(200, 150, 100, 100);
+    filterButton.setBounds(125, 300, 100, 30);
+    analyserView.setBounds(25, 350, 300, 110);
+    responseView.setBounds(25, 15, 300, 95);
+   #if WDF_ENABLE_INSTRUMENTATION
+    loadMeterView.setBounds(25, 462, 300, 16);
+   #endif
 }
 
 void DigitalFiltersAudioProcessorEditor::filterButtonClicked()
 {
+    audioProcessor.setPreGainEnabled(filterButton.getToggleState());
+}
 
-    
+void DigitalFiltersAudioProcessorEditor::changeListenerCallback (juce::ChangeBroadcaster*)
+{
+    filterButton.setToggleState(audioProcessor.filterToggle != 0, juce::dontSendNotification);
 }
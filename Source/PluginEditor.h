@@ -10,10 +10,12 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "ResponseView.h"
 //==============================================================================
 /**
 */
-class DigitalFiltersAudioProcessorEditor  : public juce::AudioProcessorEditor
+class DigitalFiltersAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                             private juce::ChangeListener
 {
 public:
     DigitalFiltersAudioProcessorEditor (DigitalFiltersAudioProcessor&);
@@ -25,12 +27,22 @@ public:
     void filterButtonClicked();
     
 private:
+    // Follows filterToggle when it is changed by the host (state restore) rather than the button
+    void changeListenerCallback (juce::ChangeBroadcaster* source) override;
+    
     
     juce::TextButton filterButton;
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     DigitalFiltersAudioProcessor& audioProcessor;
     
+    AnalyserView analyserView;
+    ResponseView responseView;
+    
+   #if WDF_ENABLE_INSTRUMENTATION
+    LoadMeterView loadMeterView;
+   #endif
+    
     juce::Slider toneControlFreqDial;
     juce::Slider gainDial;
     juce::Label toneControlFreqLabel;
@@ -11,6 +11,15 @@
 #include <JuceHeader.h>
 #include "FilterObjects.h"
 
+//==============================================================================
+static juce::StringArray getPresetNames()
+{
+    juce::StringArray names;
+    for (int i = 0; i < PresetBank::numPresets; i++)
+        names.add(PresetBank::getDefinition(i).name);
+    return names;
+}
+
 //==============================================================================
 DigitalFiltersAudioProcessor::DigitalFiltersAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -29,7 +38,13 @@ tree(*this, nullptr, "Parameter",
 
     std::make_unique<juce::AudioParameterFloat> ("gain", "Gain", 0.0f, 48.0f, 0.0f),
 
-    std::make_unique<juce::AudioParameterFloat> ("volume", "Volume", juce::NormalisableRange<float> (0.0f, 10000.0f, 1.0f, 0.30f), 1000.0f)   } )
+    std::make_unique<juce::AudioParameterFloat> ("volume", "Volume", juce::NormalisableRange<float> (0.0f, 10000.0f, 1.0f, 0.30f), 1000.0f),
+
+    std::make_unique<juce::AudioParameterChoice> ("morphFrom", "Morph From", getPresetNames(), 0),
+
+    std::make_unique<juce::AudioParameterChoice> ("morphTo", "Morph To", getPresetNames(), 1),
+
+    std::make_unique<juce::AudioParameterFloat> ("morph", "Morph", 0.0f, 1.0f, 0.0f)   } )
 
 
 
@@ -37,6 +52,12 @@ tree(*this, nullptr, "Parameter",
 
 #endif
 {
+    // Looked up once: the audio thread reads the values through these, never by name
+    centreFreqParameter = tree.getRawParameterValue("centreFreq");
+    volumeParameter = tree.getRawParameterValue("volume");
+    morphParameter = tree.getRawParameterValue("morph");
+    morphFromParameter = tree.getRawParameterValue("morphFrom");
+    morphToParameter = tree.getRawParameterValue("morphTo");
 }
 
 DigitalFiltersAudioProcessor::~DigitalFiltersAudioProcessor()
@@ -78,27 +99,38 @@ bool DigitalFiltersAudioProcessor::isMidiEffect() const
 
 double DigitalFiltersAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    return tailLengthSeconds.load();
 }
 
 int DigitalFiltersAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return PresetBank::numPresets;
 }
 
 int DigitalFiltersAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return presetBank.getCurrentIndex();
 }
 
 void DigitalFiltersAudioProcessor::setCurrentProgram (int index)
 {
+    if (index < 0 || index >= PresetBank::numPresets)
+        return;
+    
+    // Parameters first, so updateFilter already sees the preset's values when the swap lands
+    const PresetBank::Definition& preset = PresetBank::getDefinition(index);
+    setParameterValue("centreFreq", preset.tone);
+    setParameterValue("volume", preset.volume);
+    
+    presetBank.select(index);
 }
 
 const juce::String DigitalFiltersAudioProcessor::getProgramName (int index)
 {
-    return {};
+    if (index < 0 || index >= PresetBank::numPresets)
+        return {};
+    
+    return PresetBank::getDefinition(index).name;
 }
 
 void DigitalFiltersAudioProcessor::changeProgramName (int index, const juce::String& newName)
@@ -119,26 +151,63 @@ void DigitalFiltersAudioProcessor::prepareToPlay (double sampleRate, int samples
 
     lowPassFilter.prepare(spec);
     lowPassFilter.reset();
-
-    preGainCircuit[0].createWDF();
-    preGainCircuit[1].createWDF();
     
-    preGainCircuit[0].reset(sampleRate);
-    preGainCircuit[1].reset(sampleRate);
+    analyser.setSampleRate(sampleRate);
     
-    postGainCircuit[0].createWDF();
-    postGainCircuit[1].createWDF();
+   #if WDF_ENABLE_INSTRUMENTATION
+    loadMeter.prepare(sampleRate);
+   #endif
+
+    currentTone = *centreFreqParameter;
+    currentVolume = *volumeParameter;
+
+    // 20 ms equal-power crossfade for topology changes
+    const bool preGainEnabled = filterToggle != 0;
+    circuits.prepare(sampleRate, 0.02, [this, sampleRate, preGainEnabled] (CircuitChain& chain) { buildChain(chain, sampleRate, preGainEnabled); });
+
+    for (int channel = 0; channel < 2; channel++)
+        silenceDetector[channel].wake();
+
+    CircuitChain& chain = circuits.getActive();
+    circuitAnalysis.prepare(chain.preGainCircuit[0].getNumStateRegisters() + chain.postGainCircuit[0].getNumStateRegisters());
+    applyAnalysis(chain.tailSeconds, chain.outputGain);
     
-    postGainCircuit[0].reset(sampleRate);
-    postGainCircuit[1].reset(sampleRate);
+    presetBank.build(sampleRate);
+    coefficientCache.clear();
     
-
+    // Morph only takes over once the morph controls move
+    morphCoefficients.resize(presetBank.getNumMorphCoefficients());
+    currentMorph = *morphParameter;
+    currentMorphFrom = (int) *morphFromParameter;
+    currentMorphTo = (int) *morphToParameter;
+    morphActive = false;
 }
 
 void DigitalFiltersAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    circuits.stop();
+}
+
+void DigitalFiltersAudioProcessor::buildChain (CircuitChain& chain, double sampleRate, bool preGainEnabled)
+{
+    chain.build(sampleRate, *centreFreqParameter, *volumeParameter, preGainEnabled);
+}
+
+void DigitalFiltersAudioProcessor::setPreGainEnabled (bool shouldBeEnabled)
+{
+    // Unchanged (e.g. a state restore on undo or preset browsing): no rebuild, no crossfade
+    const int toggle = shouldBeEnabled ? 1 : 0;
+    if (filterToggle.exchange(toggle) == toggle)
+        return;
+    
+    filterToggleChanged.sendChangeMessage();
+    
+    // Before prepareToPlay the next prepare builds with filterToggle anyway
+    const double sampleRate = getSampleRate();
+    if (sampleRate > 0.0)
+        circuits.requestSwap([this, sampleRate, shouldBeEnabled] (CircuitChain& chain) { buildChain(chain, sampleRate, shouldBeEnabled); });
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -167,57 +236,254 @@ bool DigitalFiltersAudioProcessor::isBusesLayoutSupported (const BusesLayout& la
 
 void DigitalFiltersAudioProcessor::updateFilter ()
 {
-    float centreFreq = *tree.getRawParameterValue("centreFreq");
-    float volume = *tree.getRawParameterValue("volume");
-    float gain = *tree.getRawParameterValue("gain");
+    float centreFreq = *centreFreqParameter;
+    float volume = *volumeParameter;
     
-    for (int channel = 0; channel < getTotalNumInputChannels(); channel++) {
-        postGainCircuit[channel].setTone(centreFreq);
-        
-        postGainCircuit[channel].setVolume(volume);
-        postGainCircuit[channel].reset(getSampleRate());
-        postGainCircuit[channel].createWDF();
+    if (centreFreq == currentTone && volume == currentVolume)
+        return;
+    
+    // A recalled preset leaves the parameters at its values after the normalise round trip;
+    // while it is still the selected program, those values are its coefficients already
+    if (appliedPreset >= 0 && appliedPreset == presetBank.getCurrentIndex()
+        && centreFreq == appliedPresetTone && volume == appliedPresetVolume)
+    {
+        currentTone = centreFreq;
+        currentVolume = volume;
+        return;
+    }
+    
+    appliedPreset = -1;
+    
+    currentTone = centreFreq;
+    currentVolume = volume;
+    
+    morphActive = false;
+    setToneVolume(circuits.getActive(), circuits.getFadingOut(), centreFreq, volume);
+}
 
+void DigitalFiltersAudioProcessor::setToneVolume (CircuitChain& chain, CircuitChain* fadingOut, float tone, float volume)
+{
+    // Update the existing components in place: keeps the circuit state, no allocation.
+    // A position visited before is copied from the cache, with its tail analysis, instead of
+    // re-initialising the adaptors. The analysis depends on the topology, so that is in the key.
+    const CoefficientCache::Key key = CoefficientCache::makeKey(tone, volume, getSampleRate(), chain.preGainEnabled ? 1 : 0);
+    CoefficientCache::Analysis analysis;
+    int numCoefficients = 0;
+    
+    if (coefficientCache.lookup(key, cachedCoefficients, numCoefficients, &analysis)
+        && numCoefficients == chain.postGainCircuit[0].getNumCoefficients())
+    {
+        chain.setPostGainCoefficients(cachedCoefficients, tone, volume);
+        
+        if (fadingOut != nullptr)
+            fadingOut->setPostGainCoefficients(cachedCoefficients, tone, volume);
+        
+        applyAnalysis(analysis.tailSeconds, analysis.outputGain);
+        return;
     }
     
+   #if WDF_ENABLE_INSTRUMENTATION
+    loadMeter.countRebuild();
+   #endif
+    
+    chain.setParameters(tone, volume);
+    
+    if (fadingOut != nullptr)
+        fadingOut->setParameters(tone, volume);
+    
+    numCoefficients = chain.postGainCircuit[0].getNumCoefficients();
+    if (analyseCircuits(analysis) && numCoefficients <= CoefficientCache::maxCoefficients)
+    {
+        chain.postGainCircuit[0].getCoefficients(cachedCoefficients);
+        coefficientCache.insert(key, cachedCoefficients, numCoefficients, analysis);
+    }
+}
+
+void DigitalFiltersAudioProcessor::updateMorph ()
+{
+    float morph = *morphParameter;
+    int morphFrom = (int) *morphFromParameter;
+    int morphTo = (int) *morphToParameter;
+    
+    if (morph == currentMorph && morphFrom == currentMorphFrom && morphTo == currentMorphTo)
+        return;
+    
+    currentMorph = morph;
+    currentMorphFrom = morphFrom;
+    currentMorphTo = morphTo;
+    
+    // Fixed cost per block: interpolate between two precomputed breakpoints and copy
+    CircuitChain& active = circuits.getActive();
+    double tailSeconds = 0.0;
+    double outputGain = 0.0;
+    if (!presetBank.getMorphCoefficients(morphFrom, morphTo, morph, morphCoefficients.data())
+        || !presetBank.getMorphAnalysis(morphFrom, morphTo, morph, active.preGainEnabled, tailSeconds, outputGain))
+        return;
+    
+    const double* preGainCoefficients = morphCoefficients.data();
+    const double* postGainCoefficients = preGainCoefficients + presetBank.getNumPreGainCoefficients();
+    double tone = PresetBank::getMorphTone(morphFrom, morphTo, morph);
+    double volume = PresetBank::getMorphVolume(morphFrom, morphTo, morph);
+    
+    active.setCoefficients(preGainCoefficients, postGainCoefficients, tone, volume);
+    
+    if (CircuitChain* fadingOut = circuits.getFadingOut())
+        fadingOut->setCoefficients(preGainCoefficients, postGainCoefficients, tone, volume);
+    
+    // The last control moved wins: tone/volume take over again only when they change
+    morphActive = true;
+    currentTone = *centreFreqParameter;
+    currentVolume = *volumeParameter;
+    
+    applyAnalysis(tailSeconds, outputGain);
+}
+
+bool DigitalFiltersAudioProcessor::analyseCircuits (CoefficientCache::Analysis& analysis)
+{
+    // Both channels share component values, so channel 0 stands for the pair
+    IAudioSignalProcessor* chain[2];
+    int numCircuits = circuits.getActive().getCircuits(0, chain);
+    WdfTailAnalysis result;
+    
+    if (!circuitAnalysis.analyse(chain, numCircuits, getSampleRate(), result))
+        return false;
+    
+    analysis.tailSeconds = result.tailSeconds;
+    analysis.outputGain = result.outputGain;
+    applyAnalysis(analysis.tailSeconds, analysis.outputGain);
+    return true;
+}
+
+void DigitalFiltersAudioProcessor::applyAnalysis (double tailSeconds, double outputGain)
+{
+    tailLengthSeconds = tailSeconds;
+    
+    for (int channel = 0; channel < 2; channel++)
+        silenceDetector[channel].setStateGain(outputGain);
 }
 
 void DigitalFiltersAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    // With WDF_REALTIME_CHECKS, any allocation, lock or blocking call from here on fails the test
+    WDF_REALTIME_SECTION ("processBlock");
     
     juce::ScopedNoDenormals noDenormals;
+   #if WDF_ENABLE_INSTRUMENTATION
+    const auto blockStart = ProcessLoadMeter::now();
+   #endif
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    // A rebuilt chain starts its crossfade; it was built and analysed on the builder thread from the
+    // parameters of a moment ago
+    if (CircuitChain* adopted = circuits.beginBlock())
+    {
+       #if WDF_ENABLE_INSTRUMENTATION
+        loadMeter.countRebuild();
+       #endif
+        
+        applyAnalysis(adopted->tailSeconds, adopted->outputGain);
+        
+        if (morphActive)
+            currentMorphFrom = -1;  // forces updateMorph to install the morph on the new chain
+        else if (adopted->tone != currentTone || adopted->volume != currentVolume)
+            setToneVolume(*adopted, nullptr, currentTone, currentVolume);
+        
+        for (int channel = 0; channel < 2; channel++)
+            silenceDetector[channel].wake();
+    }
+
+    // A recalled preset arrives with its coefficients and tail analysis already computed
+    if (const CircuitPreset* preset = presetBank.takePending())
+    {
+        const int topology = circuits.getActive().preGainEnabled ? 1 : 0;
+        circuits.getActive().setCoefficients(preset->preGainCoefficients.data(), preset->postGainCoefficients.data(), preset->tone, preset->volume);
+        
+        if (CircuitChain* fadingOut = circuits.getFadingOut())
+            fadingOut->setCoefficients(preset->preGainCoefficients.data(), preset->postGainCoefficients.data(), preset->tone, preset->volume);
+        
+        currentTone = preset->tone;
+        currentVolume = preset->volume;
+        morphActive = false;
+        
+        // setCurrentProgram wrote the parameters before publishing the preset
+        appliedPreset = preset->index;
+        appliedPresetTone = *centreFreqParameter;
+        appliedPresetVolume = *volumeParameter;
+        applyAnalysis(preset->tailSeconds[topology], preset->outputGain[topology]);
+    }
+
+    updateMorph();
+    updateFilter();
+
+    CircuitChain& chain = circuits.getActive();
+    CircuitChain* fadingOut = circuits.getFadingOut();
+
     for (int channel = 0; channel < totalNumInputChannels; channel++)
     {
         
         const float * inputBuffer = buffer.getReadPointer(channel);
         auto * outputData = buffer.getWritePointer(channel);
         
+        // Idle channels cost one scan of the input until signal returns
+        bool inputSilent = silenceDetector[channel].isSilent(inputBuffer, buffer.getNumSamples());
         
+        if (silenceDetector[channel].isIdle() && fadingOut == nullptr)
+        {
+            if (inputSilent)
+            {
+                buffer.clear(channel, 0, buffer.getNumSamples());
+                continue;
+            }
+            
+            // Circuits were flushed on the way in, so they restart from rest
+            silenceDetector[channel].wake();
+        }
         
         for (int sample = 0; sample < buffer.getNumSamples(); sample++)
         {
 
             float inputSample = inputBuffer[sample];
             
-            double preGainCircuitOut = preGainCircuit[channel].processAudioSample(inputSample);
+            double circuitOut = chain.processAudioSample(channel, inputSample);
             
-            double postGainCircuitOut = postGainCircuit[channel].processAudioSample(preGainCircuitOut);
+            if (fadingOut != nullptr)
+            {
+                float oldGain, newGain;
+                circuits.getFadeGains(sample, oldGain, newGain);
+                circuitOut = newGain * circuitOut + oldGain * fadingOut->processAudioSample(channel, inputSample);
+            }
             
-            outputData[sample] = (float)postGainCircuitOut;
-            
-            updateFilter();
+            outputData[sample] = (float)circuitOut;
 
         }
         
-        
+        if (inputSilent && fadingOut == nullptr)
+        {
+            IAudioSignalProcessor* channelCircuits[2];
+            int numCircuits = chain.getCircuits(channel, channelCircuits);
+           #if WDF_ENABLE_INSTRUMENTATION
+            if (silenceDetector[channel].updateAfterSilentBlock(channelCircuits, numCircuits))
+                loadMeter.countSilenceReset();
+           #else
+            silenceDetector[channel].updateAfterSilentBlock(channelCircuits, numCircuits);
+           #endif
+        }
 
     }
+    
+    circuits.advance(buffer.getNumSamples());
+    circuits.endBlock();
+    
+    // The analyser only costs a copy here; the FFT runs on the message thread
+    analyser.pushSamples(buffer.getReadPointer(0), buffer.getNumSamples());
+    
+   #if WDF_ENABLE_INSTRUMENTATION
+    loadMeter.endBlock(blockStart, buffer.getNumSamples());
+   #endif
 
 }
 
@@ -236,15 +502,47 @@ juce::AudioProcessorEditor* DigitalFiltersAudioProcessor::createEditor()
 //==============================================================================
 void DigitalFiltersAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    juce::MemoryOutputStream stream (destData, false);
+    
+    stream.writeInt (stateMagic);
+    stream.writeInt (stateVersion);
+    stream.writeFloat (*tree.getRawParameterValue("centreFreq"));
+    stream.writeFloat (*tree.getRawParameterValue("volume"));
+    stream.writeFloat (*tree.getRawParameterValue("gain"));
+    stream.writeInt (presetBank.getCurrentIndex());
+    stream.writeInt (filterToggle);
+    stream.writeFloat (*tree.getRawParameterValue("morph"));
+    stream.writeInt ((int) *tree.getRawParameterValue("morphFrom"));
+    stream.writeInt ((int) *tree.getRawParameterValue("morphTo"));
 }
 
 void DigitalFiltersAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    juce::MemoryInputStream stream (data, (size_t) sizeInBytes, false);
+    
+    // Layout: magic, version, tone, volume, gain, program index, filterToggle, morph position
+    // and its two presets; 4 bytes each
+    if (sizeInBytes < stateSize || stream.readInt() != stateMagic)
+        return;
+    
+    int version = stream.readInt();
+    if (version < 1 || version > stateVersion)
+        return;
+    
+    setParameterValue("centreFreq", stream.readFloat());
+    setParameterValue("volume", stream.readFloat());
+    setParameterValue("gain", stream.readFloat());
+    presetBank.setCurrentIndex(stream.readInt());
+    setPreGainEnabled(stream.readInt() != 0);
+    setParameterValue("morph", stream.readFloat());
+    setParameterValue("morphFrom", (float) stream.readInt());
+    setParameterValue("morphTo", (float) stream.readInt());
+}
+
+void DigitalFiltersAudioProcessor::setParameterValue (const juce::String& parameterID, float value)
+{
+    if (auto* parameter = tree.getParameter(parameterID))
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
 }
 
 //==============================================================================
@@ -11,6 +11,15 @@
 #include <JuceHeader.h>
 #include "FilterObjects.h"
 #include "Distortion.h"
+#include "SilenceDetector.h"
+#include "WdfAnalysis.h"
+#include "PresetBank.h"
+#include "CircuitChain.h"
+#include "CircuitSwap.h"
+#include "CoefficientCache.h"
+#include "SpectrumAnalyser.h"
+#include "LoadMonitor.h"
+#include "RealtimeGuard.h"
 
 //==============================================================================
 /**
@@ -22,7 +31,24 @@ public:
     DigitalFiltersAudioProcessor();
     ~DigitalFiltersAudioProcessor() override;
     juce::AudioProcessorValueTreeState tree;
-    int filterToggle = 0;
+    std::atomic<int> filterToggle { 1 };   // 1 = pre-gain input stage in circuit
+    
+    // Switch the input stage in or out; the new chain is built off the audio thread and crossfaded
+    void setPreGainEnabled (bool shouldBeEnabled);
+    
+    // Notifies editors (on the message thread) when filterToggle changes, e.g. on a state restore
+    juce::ChangeBroadcaster filterToggleChanged;
+    
+    // Output analysis shared by every open editor
+    SpectrumAnalyser& getAnalyser() { return analyser; }
+    
+    // True while the circuits run the preset morph rather than the tone/volume parameters
+    bool isMorphActive() const { return morphActive.load(); }
+    
+   #if WDF_ENABLE_INSTRUMENTATION
+    // Block timing and event counters for the editor readout
+    const ProcessLoadMeter& getLoadMeter() const { return loadMeter; }
+   #endif
 
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
@@ -61,9 +87,68 @@ private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DigitalFiltersAudioProcessor)
     
-    // One filter for each speaker    
-    WDFPreGainDistortionCircuit preGainCircuit[2];
-    WDFPostGainDistortionCircuit postGainCircuit[2];
+    // One filter for each speaker, swapped as a whole when the topology changes
+    CircuitSwap<CircuitChain> circuits;
+    void buildChain (CircuitChain& chain, double sampleRate, bool preGainEnabled);
+    
+    // Skips a channel's circuits while its input and tail are silent
+    SilenceDetector silenceDetector[2];
+    
+    // Last values pushed into the circuits, so updateFilter only rebuilds on change
+    float currentTone = -1.0f;
+    float currentVolume = -1.0f;
+    
+    // Parameter values read on the audio thread
+    std::atomic<float>* centreFreqParameter = nullptr;
+    std::atomic<float>* volumeParameter = nullptr;
+    std::atomic<float>* morphParameter = nullptr;
+    std::atomic<float>* morphFromParameter = nullptr;
+    std::atomic<float>* morphToParameter = nullptr;
+    
+    // Tone/volume into a chain (and the one fading out): a cached position is copied, any other rebuilt
+    void setToneVolume (CircuitChain& chain, CircuitChain* fadingOut, float tone, float volume);
+    
+    // Circuit tail: copied from a rebuilt chain or along with cached or precomputed coefficients,
+    // analysed on the audio thread only after an in-place rebuild
+    bool analyseCircuits (CoefficientCache::Analysis& analysis);
+    void applyAnalysis (double tailSeconds, double outputGain);
+    WdfAnalysis circuitAnalysis;
+    std::atomic<double> tailLengthSeconds { 0.0 };
+    
+    // Coefficient sets of recently visited tone/volume positions, so automation sweeps skip re-initialisation
+    CoefficientCache coefficientCache;
+    double cachedCoefficients[CoefficientCache::maxCoefficients];
+    
+    // Factory presets with precomputed coefficients, recalled by pointer swap
+    PresetBank presetBank;
+    
+    // Morph between two presets through the bank's coefficient breakpoints
+    void updateMorph();
+    std::vector<double> morphCoefficients;
+    float currentMorph = 0.0f;
+    int currentMorphFrom = -1;
+    int currentMorphTo = -1;
+    std::atomic<bool> morphActive { false };
+    
+    // Preset last installed from the bank, and the parameter values it left behind
+    int appliedPreset = -1;
+    float appliedPresetTone = 0.0f;
+    float appliedPresetVolume = 0.0f;
+    
+    // Binary state: 'WDFS', version, then the parameter values
+    static const int stateMagic = 0x53464457;
+    static const int stateVersion = 1;
+    static const int stateSize = 10 * 4;
+    void setParameterValue (const juce::String& parameterID, float value);
+    
+    // Post-circuit audio for the editors' analyser views
+    SpectrumAnalyser analyser;
+    
+   #if WDF_ENABLE_INSTRUMENTATION
+    // Per-block load, published to the editor and (with WDF_LOAD_LOG set) a log file
+    ProcessLoadMeter loadMeter;
+    LoadLogger loadLogger { loadMeter };
+   #endif
     
     juce::Random random;
     
@@ -0,0 +1,317 @@
+/*
+  ==============================================================================
+
+    PresetBank.h
+    Created: 18 Oct 2026 4:05:33pm
+    Author:  Richie Haynes
+
+    Factory presets with their adaptor coefficients computed up front. The
+    bank is built off the audio thread (prepareToPlay) for the current sample
+    rate; selecting a preset publishes a pointer to its entry, and the audio
+    thread picks it up with a single atomic exchange and copies the
+    coefficients into its circuits (CircuitChain::setCoefficients). No
+    adaptor chain is re-initialised, nothing is allocated on the audio
+    thread, and the circuit state is kept. The chain's tail length and
+    output gain are analysed here too, with and without the input stage,
+    so a recall copies them instead of re-analysing.
+
+    build( ) may run on the host's thread while the message thread selects a
+    preset, so it computes into local tables and swaps them in under a lock
+    that select( ) also takes. The audio thread never locks: it only reads
+    the tables between prepareToPlay calls.
+
+    For morphing, every pair of presets also gets a table of breakpoints:
+    circuits built at resistances spaced geometrically between the two
+    presets. A morph position interpolates between the two neighbouring
+    breakpoints in coefficient space, a fixed O(coefficients) cost per block
+    that never touches createWDF( ) or initializeAdaptorChain( ). Between
+    breakpoints the tail and gain are taken as the larger of the two.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "FilterObjects.h"
+#include "WdfAnalysis.h"
+
+/**
+\struct CircuitPreset
+\brief
+One bank entry: parameter values plus the coefficients they produce.
+*/
+struct CircuitPreset
+{
+    std::string name;
+    int index = 0;          ///< position in the bank
+    float tone = 0.0f;      ///< post-gain tone resistance (ohms)
+    float volume = 0.0f;    ///< post-gain volume resistance (ohms)
+    std::vector<double> preGainCoefficients;
+    std::vector<double> postGainCoefficients;
+    double tailSeconds[2] = {};     ///< chain tail by topology: [0] post-gain only, [1] with the input stage
+    double outputGain[2] = {};      ///< chain state-to-output gain, same indexing
+};
+
+/**
+\class PresetBank
+\brief
+Precomputed presets, recalled by pointer swap.
+*/
+class PresetBank
+{
+public:
+    /** factory preset table */
+    struct Definition
+    {
+        const char* name;
+        float tone;
+        float volume;
+    };
+
+    static const int numPresets = 5;
+    static const int numMorphBreakpoints = 33;
+
+    /** preset name and parameter values; available before build( ) */
+    static const Definition& getDefinition(int index)
+    {
+        static const Definition definitions[numPresets] =
+        {
+            { "Default",     5000.0f,  1000.0f },
+            { "Bright",      500.0f,   1000.0f },
+            { "Dark",        15000.0f, 1000.0f },
+            { "Full Volume", 5000.0f,  10000.0f },
+            { "Low Level",   5000.0f,  200.0f }
+        };
+        return definitions[index];
+    }
+
+    /** compute every preset's coefficients, and the morph breakpoints between every pair, at this
+        sample rate; call while the audio thread is stopped. A selection made meanwhile on the
+        message thread is kept, and re-published from the new tables if still pending. */
+    void build(double sampleRate)
+    {
+        const int newNumPreGainCoefficients = WDFPreGainDistortionCircuit().getNumCoefficients();
+        const int newNumPostGainCoefficients = WDFPostGainDistortionCircuit().getNumCoefficients();
+
+        WdfAnalysis analysis;
+        analysis.prepare(WDFPreGainDistortionCircuit().getNumStateRegisters() + WDFPostGainDistortionCircuit().getNumStateRegisters());
+
+        std::vector<std::unique_ptr<CircuitPreset>> newPresets;
+        for (int i = 0; i < numPresets; i++)
+        {
+            const Definition& definition = getDefinition(i);
+            auto preset = std::make_unique<CircuitPreset>();
+            preset->name = definition.name;
+            preset->index = i;
+            preset->tone = definition.tone;
+            preset->volume = definition.volume;
+
+            preset->preGainCoefficients.resize(newNumPreGainCoefficients);
+            preset->postGainCoefficients.resize(newNumPostGainCoefficients);
+            computeCoefficients(sampleRate, definition.tone, definition.volume,
+                                preset->preGainCoefficients.data(), preset->postGainCoefficients.data(),
+                                analysis, preset->tailSeconds, preset->outputGain);
+
+            newPresets.push_back(std::move(preset));
+        }
+
+        // --- breakpoints for each unordered pair (from < to)
+        const int stride = newNumPreGainCoefficients + newNumPostGainCoefficients;
+        std::vector<std::vector<double>> newMorphTables(numPresets * numPresets);
+        std::vector<std::vector<double>> newMorphTails(numPresets * numPresets);
+        for (int from = 0; from < numPresets; from++)
+        {
+            for (int to = from + 1; to < numPresets; to++)
+            {
+                std::vector<double>& table = newMorphTables[from * numPresets + to];
+                table.resize((size_t)numMorphBreakpoints * stride);
+                std::vector<double>& tails = newMorphTails[from * numPresets + to];
+                tails.resize((size_t)numMorphBreakpoints * tailStride);
+
+                for (int k = 0; k < numMorphBreakpoints; k++)
+                {
+                    double position = (double)k / (double)(numMorphBreakpoints - 1);
+                    double* breakpoint = table.data() + (size_t)k * stride;
+                    double* tail = tails.data() + (size_t)k * tailStride;
+                    computeCoefficients(sampleRate, getMorphTone(from, to, position), getMorphVolume(from, to, position),
+                                        breakpoint, breakpoint + newNumPreGainCoefficients, analysis, tail, tail + 2);
+                }
+            }
+        }
+
+        // --- publish; the old tables are freed when the locals go out of scope, after the unlock
+        std::lock_guard<std::mutex> lock(mutex);
+        const bool wasPending = pending.exchange(nullptr) != nullptr;
+        presets.swap(newPresets);
+        morphTables.swap(newMorphTables);
+        morphTails.swap(newMorphTails);
+        numPreGainCoefficients = newNumPreGainCoefficients;
+        numPostGainCoefficients = newNumPostGainCoefficients;
+
+        if (wasPending)
+            pending.store(presets[currentIndex.load()].get(), std::memory_order_release);
+    }
+
+    /** coefficient counts of the circuits the bank is built for; valid after build( ) */
+    int getNumPreGainCoefficients() const { return numPreGainCoefficients; }
+    int getNumPostGainCoefficients() const { return numPostGainCoefficients; }
+    int getNumMorphCoefficients() const { return numPreGainCoefficients + numPostGainCoefficients; }
+
+    /** tone resistance at a morph position: geometric, as resistances are heard logarithmically */
+    static double getMorphTone(int from, int to, double position)
+    {
+        return getDefinition(from).tone * std::pow((double)getDefinition(to).tone / getDefinition(from).tone, position);
+    }
+
+    /** volume resistance at a morph position */
+    static double getMorphVolume(int from, int to, double position)
+    {
+        return getDefinition(from).volume * std::pow((double)getDefinition(to).volume / getDefinition(from).volume, position);
+    }
+
+    /** audio thread: coefficients at a position (0 = from, 1 = to) between two presets, interpolated
+        between the nearest breakpoints. Writes getNumMorphCoefficients( ) values: pre-gain then
+        post-gain. Returns false if the bank is not built or the indices are invalid. */
+    bool getMorphCoefficients(int from, int to, double position, double* coefficients) const
+    {
+        if (!isBuilt() || from < 0 || to < 0 || from >= numPresets || to >= numPresets)
+            return false;
+
+        const int stride = getNumMorphCoefficients();
+        position = std::min(1.0, std::max(0.0, position));
+
+        if (from == to)
+        {
+            const CircuitPreset& preset = *presets[from];
+            std::copy(preset.preGainCoefficients.begin(), preset.preGainCoefficients.end(), coefficients);
+            std::copy(preset.postGainCoefficients.begin(), preset.postGainCoefficients.end(), coefficients + getNumPreGainCoefficients());
+            return true;
+        }
+
+        // --- tables are stored for from < to
+        if (from > to)
+        {
+            std::swap(from, to);
+            position = 1.0 - position;
+        }
+
+        const std::vector<double>& table = morphTables[from * numPresets + to];
+        double scaled = position * (numMorphBreakpoints - 1);
+        int k = std::min((int)scaled, numMorphBreakpoints - 2);
+        double fraction = scaled - k;
+
+        const double* lower = table.data() + (size_t)k * stride;
+        const double* upper = lower + stride;
+        for (int i = 0; i < stride; i++)
+            coefficients[i] = lower[i] + fraction * (upper[i] - lower[i]);
+
+        return true;
+    }
+
+    /** audio thread: chain tail and output gain at a morph position, for the topology with or
+        without the input stage; the larger of the two neighbouring breakpoints' values. Returns
+        false if the bank is not built or the indices are invalid. */
+    bool getMorphAnalysis(int from, int to, double position, bool preGainEnabled, double& tailSeconds, double& outputGain) const
+    {
+        if (!isBuilt() || from < 0 || to < 0 || from >= numPresets || to >= numPresets)
+            return false;
+
+        const int topology = preGainEnabled ? 1 : 0;
+        position = std::min(1.0, std::max(0.0, position));
+
+        if (from == to)
+        {
+            tailSeconds = presets[from]->tailSeconds[topology];
+            outputGain = presets[from]->outputGain[topology];
+            return true;
+        }
+
+        if (from > to)
+        {
+            std::swap(from, to);
+            position = 1.0 - position;
+        }
+
+        const std::vector<double>& tails = morphTails[from * numPresets + to];
+        int k = std::min((int)(position * (numMorphBreakpoints - 1)), numMorphBreakpoints - 2);
+
+        const double* lower = tails.data() + (size_t)k * tailStride;
+        const double* upper = lower + tailStride;
+        tailSeconds = std::max(lower[topology], upper[topology]);
+        outputGain = std::max(lower[2 + topology], upper[2 + topology]);
+        return true;
+    }
+
+    /** true once build( ) has run */
+    bool isBuilt() const { return !presets.empty(); }
+
+    /** select a preset (message thread); the audio thread applies it on its next takePending( ) */
+    void select(int index)
+    {
+        if (index < 0 || index >= numPresets)
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        currentIndex = index;
+        if (isBuilt())
+            pending.store(presets[index].get(), std::memory_order_release);
+    }
+
+    /** record the current preset without recalling it (state restore: parameters may have been edited since) */
+    void setCurrentIndex(int index)
+    {
+        if (index >= 0 && index < numPresets)
+            currentIndex = index;
+    }
+
+    /** index of the last selected preset */
+    int getCurrentIndex() const { return currentIndex.load(); }
+
+    /** audio thread: the preset selected since the last call, or nullptr */
+    const CircuitPreset* takePending() { return pending.exchange(nullptr, std::memory_order_acquire); }
+
+private:
+    static const int tailStride = 4;    ///< per breakpoint: tailSeconds[2] then outputGain[2]
+
+    /** coefficients for a parameter position, plus the chain's tail and output gain for each
+        topology ([0] post-gain only, [1] with the input stage) */
+    static void computeCoefficients(double sampleRate, double tone, double volume, double* preGainCoefficients, double* postGainCoefficients,
+                                    WdfAnalysis& analysis, double* tailSeconds, double* outputGain)
+    {
+        WDFPreGainDistortionCircuit preGain;
+        preGain.reset(sampleRate);
+        preGain.getCoefficients(preGainCoefficients);
+
+        WDFPostGainDistortionCircuit postGain;
+        postGain.setTone(tone);
+        postGain.setVolume(volume);
+        postGain.createWDF();
+        postGain.reset(sampleRate);
+        postGain.getCoefficients(postGainCoefficients);
+
+        IAudioSignalProcessor* chain[] = { &preGain, &postGain };
+        for (int topology = 0; topology < 2; topology++)
+        {
+            WdfTailAnalysis result;
+            analysis.analyse(chain + 1 - topology, 1 + topology, sampleRate, result);
+            tailSeconds[topology] = result.tailSeconds;
+            outputGain[topology] = result.outputGain;
+        }
+    }
+
+    std::vector<std::unique_ptr<CircuitPreset>> presets;
+    std::vector<std::vector<double>> morphTables;   ///< [from * numPresets + to], from < to
+    std::vector<std::vector<double>> morphTails;    ///< same indexing, tailStride values per breakpoint
+    int numPreGainCoefficients = 0;
+    int numPostGainCoefficients = 0;
+    std::atomic<const CircuitPreset*> pending { nullptr };
+    std::atomic<int> currentIndex { 0 };
+    std::mutex mutex;                               ///< build( ) and select( ) only
+};
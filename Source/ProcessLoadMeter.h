@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    ProcessLoadMeter.h
+    Created: 18 Oct 2026 7:46:55pm
+    Author:  Richie Haynes
+
+    Per-block CPU load of processBlock( ) as a fraction of the real-time
+    budget (block length / sample rate), timed with the steady clock. The
+    audio thread keeps a load histogram per window and, at the end of each
+    window, publishes its maximum and 99th percentile through atomics (for
+    the editor) and a single-producer/single-consumer ring of summaries (for
+    the optional file log). Rebuild events and silence resets are counted
+    alongside. Nothing here locks or allocates after prepare( ).
+
+    Everything is compiled out when WDF_ENABLE_INSTRUMENTATION is 0: the
+    plug-in wraps every use in #if WDF_ENABLE_INSTRUMENTATION.
+
+  ==============================================================================
+*/
+#pragma once
+
+#ifndef WDF_ENABLE_INSTRUMENTATION
+ #define WDF_ENABLE_INSTRUMENTATION 1
+#endif
+
+#if WDF_ENABLE_INSTRUMENTATION
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+
+/**
+\class ProcessLoadMeter
+\brief
+Real-time load statistics of the audio callback.
+*/
+class ProcessLoadMeter
+{
+public:
+    static const int numHistogramBins = 400;        ///< 0.5% steps up to 200% load
+    static constexpr double binWidth = 0.005;
+    static const int ringSize = 64;                 ///< window summaries held for the logger
+
+    /** one published window */
+    struct Summary
+    {
+        double endSeconds = 0.0;    ///< audio time at the end of the window
+        double meanLoad = 0.0;
+        double maxLoad = 0.0;
+        double p99Load = 0.0;
+        uint32_t numBlocks = 0;
+        uint32_t numOverruns = 0;   ///< blocks that took longer than real time
+        uint64_t rebuilds = 0;      ///< running totals at the end of the window
+        uint64_t silenceResets = 0;
+    };
+
+    /** set the rate the budget is computed for and the window length; audio thread stopped */
+    void prepare(double _sampleRate, double _windowSeconds = 1.0)
+    {
+        sampleRate = _sampleRate;
+        windowSamples = (uint64_t)(_windowSeconds * _sampleRate);
+        resetWindow();
+        audioSeconds = 0.0;
+    }
+
+    /** audio thread: timestamp at the start of processBlock( ) */
+    static std::chrono::steady_clock::time_point now() { return std::chrono::steady_clock::now(); }
+
+    /** audio thread: account for a block that started at start */
+    void endBlock(std::chrono::steady_clock::time_point start, int numSamples)
+    {
+        if (numSamples <= 0 || sampleRate <= 0.0)
+            return;
+
+        const double elapsed = std::chrono::duration<double>(now() - start).count();
+        const double load = elapsed * sampleRate / (double)numSamples;
+
+        currentLoad.store(load, std::memory_order_relaxed);
+        histogram[(int)std::min(load / binWidth, (double)(numHistogramBins - 1))]++;
+        windowSum += load;
+        windowMax = std::max(windowMax, load);
+        windowBlocks++;
+        if (load > 1.0)
+            windowOverruns++;
+
+        windowPosition += (uint64_t)numSamples;
+        audioSeconds += (double)numSamples / sampleRate;
+        if (windowPosition >= windowSamples)
+            publishWindow();
+    }
+
+    /** audio thread: a circuit chain was rebuilt or re-initialised */
+    void countRebuild() { rebuilds.fetch_add(1, std::memory_order_relaxed); }
+
+    /** audio thread: a silent channel went idle and its circuit state was reset to zero (not a
+        count of WdfDenormalGuard flushes, which happen per register inside the circuits) */
+    void countSilenceReset() { silenceResets.fetch_add(1, std::memory_order_relaxed); }
+
+    // --- any thread
+    double getCurrentLoad() const { return currentLoad.load(std::memory_order_relaxed); }
+    double getWindowMax() const { return lastMax.load(std::memory_order_relaxed); }
+    double getWindowP99() const { return lastP99.load(std::memory_order_relaxed); }
+    uint64_t getRebuilds() const { return rebuilds.load(std::memory_order_relaxed); }
+    uint64_t getSilenceResets() const { return silenceResets.load(std::memory_order_relaxed); }
+    uint64_t getOverruns() const { return overruns.load(std::memory_order_relaxed); }
+
+    /** single consumer: take the oldest unread summary; false if none */
+    bool popSummary(Summary& summary)
+    {
+        const uint32_t read = readIndex.load(std::memory_order_relaxed);
+        if (read == writeIndex.load(std::memory_order_acquire))
+            return false;
+
+        summary = ring[read % ringSize];
+        readIndex.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    void publishWindow()
+    {
+        // --- p99: smallest load with at least 99% of the blocks at or below it
+        const uint32_t target = windowBlocks - windowBlocks / 100;
+        uint32_t count = 0;
+        int bin = 0;
+        for (; bin < numHistogramBins - 1; bin++)
+        {
+            count += histogram[bin];
+            if (count >= target)
+                break;
+        }
+        const double p99 = std::min(windowMax, (bin + 1) * binWidth);
+
+        lastMax.store(windowMax, std::memory_order_relaxed);
+        lastP99.store(p99, std::memory_order_relaxed);
+        overruns.fetch_add(windowOverruns, std::memory_order_relaxed);
+
+        // --- drop the summary rather than overwrite one the logger has not read
+        const uint32_t write = writeIndex.load(std::memory_order_relaxed);
+        if (write - readIndex.load(std::memory_order_acquire) < (uint32_t)ringSize)
+        {
+            Summary& summary = ring[write % ringSize];
+            summary.endSeconds = audioSeconds;
+            summary.meanLoad = windowSum / (double)windowBlocks;
+            summary.maxLoad = windowMax;
+            summary.p99Load = p99;
+            summary.numBlocks = windowBlocks;
+            summary.numOverruns = windowOverruns;
+            summary.rebuilds = getRebuilds();
+            summary.silenceResets = getSilenceResets();
+            writeIndex.store(write + 1, std::memory_order_release);
+        }
+
+        resetWindow();
+    }
+
+    void resetWindow()
+    {
+        std::memset(histogram, 0, sizeof(histogram));
+        windowPosition = 0;
+        windowSum = 0.0;
+        windowMax = 0.0;
+        windowBlocks = 0;
+        windowOverruns = 0;
+    }
+
+    // --- audio thread only
+    double sampleRate = 0.0;
+    uint64_t windowSamples = 0;
+    uint64_t windowPosition = 0;
+    double audioSeconds = 0.0;
+    uint32_t histogram[numHistogramBins] = {};
+    double windowSum = 0.0;
+    double windowMax = 0.0;
+    uint32_t windowBlocks = 0;
+    uint32_t windowOverruns = 0;
+
+    // --- published
+    std::atomic<double> currentLoad { 0.0 };
+    std::atomic<double> lastMax { 0.0 };
+    std::atomic<double> lastP99 { 0.0 };
+    std::atomic<uint64_t> rebuilds { 0 };
+    std::atomic<uint64_t> silenceResets { 0 };
+    std::atomic<uint64_t> overruns { 0 };
+
+    Summary ring[ringSize];
+    std::atomic<uint32_t> writeIndex { 0 };
+    std::atomic<uint32_t> readIndex { 0 };
+};
+
+#endif
@@ -0,0 +1,425 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.cpp
+    Created: 18 Oct 2026 9:21:40pm
+    Author:  Richie Haynes
+
+    Replacement operator new/delete and interposed C library calls behind
+    RealtimeGuard.h. Each one checks the calling thread's section depth
+    (initial-exec TLS, so the check itself never allocates) and then
+    forwards: the allocator through glibc's __libc_* entry points, the rest
+    through dlsym(RTLD_NEXT). Everything but operator new/delete is Linux
+    only.
+
+  ==============================================================================
+*/
+#ifndef _GNU_SOURCE
+ #define _GNU_SOURCE        // RTLD_NEXT
+#endif
+#undef _FORTIFY_SOURCE      // the fortified inline open( )/read( ) would clash with the definitions below
+
+#include "RealtimeGuard.h"
+
+#if WDF_REALTIME_CHECKS
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+ #include <dlfcn.h>
+ #include <execinfo.h>
+ #include <fcntl.h>
+ #include <pthread.h>
+ #include <semaphore.h>
+ #include <stdarg.h>
+ #include <stdio.h>
+ #include <time.h>
+ #include <unistd.h>
+ #define WDF_REALTIME_INTERPOSE 1
+#else
+ #define WDF_REALTIME_INTERPOSE 0
+#endif
+
+#if defined(__GNUC__)
+ #define WDF_REALTIME_TLS __thread __attribute__((tls_model("initial-exec")))
+#else
+ #define WDF_REALTIME_TLS thread_local
+#endif
+
+#if defined(__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t count, size_t size);
+    void* __libc_realloc(void* pointer, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* pointer);
+}
+#endif
+
+using RealtimeGuard::Violation;
+
+namespace
+{
+    const int maxSectionDepth = 16;     ///< deeper sections are counted but not tagged
+
+    // --- per thread: plain PODs, nothing to construct or destroy
+    WDF_REALTIME_TLS int sectionDepth = 0;
+    WDF_REALTIME_TLS const char* sectionTags[maxSectionDepth];
+    WDF_REALTIME_TLS int reporting = 0;     ///< > 0 while a handler runs, so its own calls pass
+
+    std::atomic<RealtimeGuard::Handler> handler { nullptr };
+    std::atomic<uint64_t> numViolations { 0 };
+
+    void reportAndAbort(Violation violation, const char* call)
+    {
+        RealtimeGuard::printReport(violation, call);
+        std::abort();
+    }
+
+    void check(Violation violation, const char* call)
+    {
+        if (sectionDepth == 0 || reporting > 0)
+            return;
+
+        reporting++;
+        numViolations.fetch_add(1, std::memory_order_relaxed);
+        RealtimeGuard::Handler current = handler.load(std::memory_order_acquire);
+        (current != nullptr ? current : reportAndAbort)(violation, call);
+        reporting--;
+    }
+
+    void* allocate(size_t size)
+    {
+       #if defined(__GLIBC__)
+        return __libc_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void* allocateAligned(size_t size, size_t alignment)
+    {
+       #if defined(__GLIBC__)
+        return __libc_memalign(alignment, size);
+       #else
+        void* pointer = nullptr;
+        return posix_memalign(&pointer, alignment, size) == 0 ? pointer : nullptr;
+       #endif
+    }
+
+    void release(void* pointer)
+    {
+       #if defined(__GLIBC__)
+        __libc_free(pointer);
+       #else
+        std::free(pointer);
+       #endif
+    }
+
+    void* throwingNew(size_t size, const char* call)
+    {
+        check(Violation::allocation, call);
+        void* pointer = allocate(size != 0 ? size : 1);
+        if (pointer == nullptr)
+            throw std::bad_alloc();
+        return pointer;
+    }
+
+    void* throwingAlignedNew(size_t size, std::align_val_t alignment, const char* call)
+    {
+        check(Violation::allocation, call);
+        void* pointer = allocateAligned(size != 0 ? size : 1, (size_t)alignment);
+        if (pointer == nullptr)
+            throw std::bad_alloc();
+        return pointer;
+    }
+
+    void checkedDelete(void* pointer, const char* call)
+    {
+        if (pointer == nullptr)
+            return;
+        check(Violation::deallocation, call);
+        release(pointer);
+    }
+
+    void writeString(const char* text)
+    {
+       #if WDF_REALTIME_INTERPOSE
+        ssize_t ignored = ::write(STDERR_FILENO, text, std::strlen(text));
+        (void)ignored;
+       #else
+        std::fputs(text, stderr);
+       #endif
+    }
+}
+
+//==============================================================================
+void RealtimeGuard::enter(const char* tag)
+{
+    if (sectionDepth < maxSectionDepth)
+        sectionTags[sectionDepth] = tag;
+    sectionDepth++;
+}
+
+void RealtimeGuard::leave()
+{
+    if (sectionDepth > 0)
+        sectionDepth--;
+}
+
+bool RealtimeGuard::isInSection()
+{
+    return sectionDepth > 0;
+}
+
+void RealtimeGuard::setHandler(Handler _handler)
+{
+    handler.store(_handler, std::memory_order_release);
+}
+
+uint64_t RealtimeGuard::getNumViolations()
+{
+    return numViolations.load(std::memory_order_relaxed);
+}
+
+const char* RealtimeGuard::getName(Violation violation)
+{
+    switch (violation)
+    {
+        case Violation::allocation: return "allocation";
+        case Violation::deallocation: return "deallocation";
+        case Violation::lock: return "lock";
+        case Violation::wait: return "wait";
+        case Violation::sleep: return "sleep";
+        case Violation::fileIO: return "file I/O";
+    }
+    return "unknown";
+}
+
+void RealtimeGuard::printReport(Violation violation, const char* call)
+{
+    writeString("real-time violation: ");
+    writeString(getName(violation));
+    writeString(" (");
+    writeString(call);
+    writeString(") in ");
+
+    const int numTags = sectionDepth < maxSectionDepth ? sectionDepth : maxSectionDepth;
+    for (int i = 0; i < numTags; i++)
+    {
+        writeString(i > 0 ? " > " : "");
+        writeString(sectionTags[i]);
+    }
+    writeString(sectionDepth > numTags ? " > ...\n" : "\n");
+
+   #if WDF_REALTIME_INTERPOSE
+    void* frames[64];
+    const int numFrames = backtrace(frames, 64);
+    backtrace_symbols_fd(frames, numFrames, STDERR_FILENO);
+   #endif
+}
+
+//==============================================================================
+// --- operator new/delete, every C++17 form
+void* operator new(size_t size) { return throwingNew(size, "operator new"); }
+void* operator new[](size_t size) { return throwingNew(size, "operator new[]"); }
+void* operator new(size_t size, std::align_val_t alignment) { return throwingAlignedNew(size, alignment, "operator new"); }
+void* operator new[](size_t size, std::align_val_t alignment) { return throwingAlignedNew(size, alignment, "operator new[]"); }
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    check(Violation::allocation, "operator new");
+    return allocate(size != 0 ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    check(Violation::allocation, "operator new[]");
+    return allocate(size != 0 ? size : 1);
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    check(Violation::allocation, "operator new");
+    return allocateAligned(size != 0 ? size : 1, (size_t)alignment);
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    check(Violation::allocation, "operator new[]");
+    return allocateAligned(size != 0 ? size : 1, (size_t)alignment);
+}
+
+void operator delete(void* pointer) noexcept { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer) noexcept { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, size_t) noexcept { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, size_t) noexcept { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, std::align_val_t) noexcept { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { checkedDelete(pointer, "operator delete[]"); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { checkedDelete(pointer, "operator delete"); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { checkedDelete(pointer, "operator delete[]"); }
+
+#if WDF_REALTIME_INTERPOSE
+
+//==============================================================================
+namespace
+{
+    /** the next definition of name after this program's, looked up once */
+    template <typename Function>
+    Function next(std::atomic<Function>& cached, const char* name)
+    {
+        Function function = cached.load(std::memory_order_relaxed);
+        if (function == nullptr)
+        {
+            function = (Function)dlsym(RTLD_NEXT, name);
+            cached.store(function, std::memory_order_relaxed);
+        }
+        return function;
+    }
+
+    std::atomic<int (*)(pthread_mutex_t*)> nextMutexLock { nullptr };
+    std::atomic<int (*)(pthread_rwlock_t*)> nextReadLock { nullptr };
+    std::atomic<int (*)(pthread_rwlock_t*)> nextWriteLock { nullptr };
+    std::atomic<int (*)(pthread_cond_t*, pthread_mutex_t*)> nextConditionWait { nullptr };
+    std::atomic<int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*)> nextConditionTimedWait { nullptr };
+    std::atomic<int (*)(sem_t*)> nextSemaphoreWait { nullptr };
+    std::atomic<int (*)(const struct timespec*, struct timespec*)> nextNanosleep { nullptr };
+    std::atomic<int (*)(useconds_t)> nextUsleep { nullptr };
+    std::atomic<unsigned int (*)(unsigned int)> nextSleep { nullptr };
+    std::atomic<int (*)(const char*, int, ...)> nextOpen { nullptr };
+    std::atomic<FILE* (*)(const char*, const char*)> nextFopen { nullptr };
+    std::atomic<ssize_t (*)(int, void*, size_t)> nextRead { nullptr };
+    std::atomic<ssize_t (*)(int, const void*, size_t)> nextWrite { nullptr };
+}
+
+extern "C"
+{
+   #if defined(__GLIBC__)
+    // --- the C allocator, for code that bypasses operator new (juce::HeapBlock, strdup, ...)
+    void* malloc(size_t size) noexcept
+    {
+        check(Violation::allocation, "malloc");
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t count, size_t size) noexcept
+    {
+        check(Violation::allocation, "calloc");
+        return __libc_calloc(count, size);
+    }
+
+    void* realloc(void* pointer, size_t size) noexcept
+    {
+        check(Violation::allocation, "realloc");
+        return __libc_realloc(pointer, size);
+    }
+
+    void free(void* pointer) noexcept
+    {
+        if (pointer != nullptr)
+            check(Violation::deallocation, "free");
+        __libc_free(pointer);
+    }
+   #endif
+
+    // --- locks and waits; trylock stays allowed
+    int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept
+    {
+        check(Violation::lock, "pthread_mutex_lock");
+        return next(nextMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock) noexcept
+    {
+        check(Violation::lock, "pthread_rwlock_rdlock");
+        return next(nextReadLock, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock) noexcept
+    {
+        check(Violation::lock, "pthread_rwlock_wrlock");
+        return next(nextWriteLock, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* condition, pthread_mutex_t* mutex)
+    {
+        check(Violation::wait, "pthread_cond_wait");
+        return next(nextConditionWait, "pthread_cond_wait")(condition, mutex);
+    }
+
+    int pthread_cond_timedwait(pthread_cond_t* condition, pthread_mutex_t* mutex, const struct timespec* time)
+    {
+        check(Violation::wait, "pthread_cond_timedwait");
+        return next(nextConditionTimedWait, "pthread_cond_timedwait")(condition, mutex, time);
+    }
+
+    int sem_wait(sem_t* semaphore)
+    {
+        check(Violation::lock, "sem_wait");
+        return next(nextSemaphoreWait, "sem_wait")(semaphore);
+    }
+
+    // --- sleeping
+    int nanosleep(const struct timespec* request, struct timespec* remaining)
+    {
+        check(Violation::sleep, "nanosleep");
+        return next(nextNanosleep, "nanosleep")(request, remaining);
+    }
+
+    int usleep(useconds_t microseconds)
+    {
+        check(Violation::sleep, "usleep");
+        return next(nextUsleep, "usleep")(microseconds);
+    }
+
+    unsigned int sleep(unsigned int seconds)
+    {
+        check(Violation::sleep, "sleep");
+        return next(nextSleep, "sleep")(seconds);
+    }
+
+    // --- files
+    int open(const char* path, int flags, ...)
+    {
+        check(Violation::fileIO, "open");
+
+        mode_t mode = 0;
+        if ((flags & O_CREAT) != 0 || (flags & O_TMPFILE) == O_TMPFILE)
+        {
+            va_list arguments;
+            va_start(arguments, flags);
+            mode = (mode_t)va_arg(arguments, int);
+            va_end(arguments);
+        }
+        return next(nextOpen, "open")(path, flags, mode);
+    }
+
+    FILE* fopen(const char* path, const char* mode)
+    {
+        check(Violation::fileIO, "fopen");
+        return next(nextFopen, "fopen")(path, mode);
+    }
+
+    ssize_t read(int descriptor, void* buffer, size_t size)
+    {
+        check(Violation::fileIO, "read");
+        return next(nextRead, "read")(descriptor, buffer, size);
+    }
+
+    ssize_t write(int descriptor, const void* buffer, size_t size)
+    {
+        check(Violation::fileIO, "write");
+        return next(nextWrite, "write")(descriptor, buffer, size);
+    }
+}
+
+#endif
+#endif
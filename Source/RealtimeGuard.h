@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    RealtimeGuard.h
+    Created: 18 Oct 2026 9:21:40pm
+    Author:  Richie Haynes
+
+    Test-mode check that the audio thread stays real-time safe. Code marks
+    its real-time sections with WDF_REALTIME_SECTION("tag"); while a thread
+    is inside one, RealtimeGuard.cpp reports every heap allocation or
+    release, mutex/condition/semaphore wait, sleep and blocking file call
+    it makes. The default report names the violation and the open section
+    tags, prints a backtrace to stderr and aborts, so a test that drives
+    processBlock( ) fails at the offending call.
+
+    Build with WDF_REALTIME_CHECKS=1 and link RealtimeGuard.cpp into the
+    test executable: the checks work by replacing operator new/delete and
+    interposing the C library calls, which only takes effect for the
+    program's own symbols, not inside a plug-in loaded by a host. With the
+    default of 0 the macro expands to nothing and RealtimeGuard.cpp is empty.
+
+  ==============================================================================
+*/
+#pragma once
+
+#ifndef WDF_REALTIME_CHECKS
+ #define WDF_REALTIME_CHECKS 0
+#endif
+
+#if WDF_REALTIME_CHECKS
+
+#include <cstdint>
+
+namespace RealtimeGuard
+{
+    /** what the audio thread was caught doing */
+    enum class Violation
+    {
+        allocation,     ///< operator new, malloc, calloc, realloc
+        deallocation,   ///< operator delete, free
+        lock,           ///< mutex, rwlock or semaphore wait
+        wait,           ///< condition variable wait
+        sleep,          ///< sleep, usleep, nanosleep
+        fileIO          ///< open, fopen, read, write
+    };
+
+    /** called on the offending thread with the section still open; may return to carry on */
+    typedef void (*Handler)(Violation violation, const char* call);
+
+    /** open a real-time section on this thread; sections nest, tag must be a string literal */
+    void enter(const char* tag);
+
+    /** close the innermost section */
+    void leave();
+
+    /** true while this thread is inside a real-time section */
+    bool isInSection();
+
+    /** replace the report; nullptr restores the default (report, backtrace, abort) */
+    void setHandler(Handler handler);
+
+    /** violations seen since start-up, any thread */
+    uint64_t getNumViolations();
+
+    /** the name of a violation, e.g. "allocation" */
+    const char* getName(Violation violation);
+
+    /** write the open section tags of this thread, outermost first, and a backtrace to stderr */
+    void printReport(Violation violation, const char* call);
+}
+
+/**
+\class ScopedRealtimeSection
+\brief
+Marks the enclosing scope as real-time for RealtimeGuard.
+*/
+class ScopedRealtimeSection
+{
+public:
+    explicit ScopedRealtimeSection(const char* tag) { RealtimeGuard::enter(tag); }
+    ~ScopedRealtimeSection() { RealtimeGuard::leave(); }
+
+    ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+    ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+};
+
+#define WDF_REALTIME_SECTION(tag) ScopedRealtimeSection realtimeSection (tag)
+
+#else
+
+#define WDF_REALTIME_SECTION(tag)
+
+#endif
@@ -0,0 +1,442 @@
+/*
+  ==============================================================================
+
+    RenderPipeline.h
+    Created: 18 Oct 2026 9:40:02am
+    Author:  Richie Haynes
+
+    Streaming block pipeline for offline rendering. A prefetch thread decodes
+    the next block out of the mapped input while the render thread runs the
+    WDF circuits on the current one, so the circuit loop never waits on I/O.
+    Only two blocks are ever resident, whatever the file length.
+
+    Long renders can checkpoint the circuit state periodically and resume
+    from the last checkpoint with bit-identical output. A file can also be
+    rendered as independent chunks; each chunk first runs the input before
+    it through the circuits for the tail length WdfAnalysis derives, so the
+    seams are below -120 dB.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CircuitCheckpoint.h"
+#include "CoefficientCache.h"
+#include "FilterObjects.h"
+#include "MappedWavFile.h"
+#include "WdfAnalysis.h"
+
+/**
+\class BlockPrefetcher
+\brief
+Double-buffered reader: fills one block on a background thread while the
+consumer works on the other one.
+*/
+class BlockPrefetcher
+{
+public:
+    /** a decoded block; channel pointers stay valid until the block is released */
+    struct Block
+    {
+        std::vector<std::vector<float>> channels;
+        std::vector<float*> channelPointers;
+        uint64_t startFrame = 0;
+        int numFrames = 0;
+        bool ready = false;
+    };
+
+    ~BlockPrefetcher() { stop(); }
+
+    /** start decoding reader from firstFrame up to (not including) endFrame in blocks of blockSize frames */
+    void start(MappedWavReader& _reader, int blockSize, uint64_t firstFrame = 0, uint64_t _endFrame = UINT64_MAX)
+    {
+        stop();
+
+        reader = &_reader;
+        nextFrame = firstFrame;
+        endFrame = std::min<uint64_t>(_endFrame, reader->getNumFrames());
+        finished = false;
+        quit = false;
+        consumerSlot = 0;
+
+        for (auto& block : blocks)
+        {
+            block.channels.assign(reader->getNumChannels(), std::vector<float>(blockSize));
+            block.channelPointers.clear();
+            for (auto& channel : block.channels)
+                block.channelPointers.push_back(channel.data());
+            block.ready = false;
+        }
+
+        worker = std::thread([this] { run(); });
+    }
+
+    /** wait for the next block; returns nullptr at end of file */
+    Block* acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        Block& block = blocks[consumerSlot];
+        ready.wait(lock, [&] { return block.ready || finished; });
+        return block.ready ? &block : nullptr;
+    }
+
+    /** give a block back so the prefetch thread can refill it */
+    void release(Block* block)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            block->ready = false;
+            consumerSlot ^= 1;
+        }
+        freed.notify_one();
+    }
+
+    /** stop the prefetch thread */
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        freed.notify_one();
+
+        if (worker.joinable())
+            worker.join();
+    }
+
+private:
+    void run()
+    {
+        int slot = 0;
+
+        while (nextFrame < endFrame)
+        {
+            Block& block = blocks[slot];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                freed.wait(lock, [&] { return !block.ready || quit; });
+                if (quit)
+                    return;
+            }
+
+            // --- decode outside the lock; the consumer is busy with the other slot
+            block.startFrame = nextFrame;
+            block.numFrames = (int)std::min<uint64_t>(block.channels[0].size(), endFrame - nextFrame);
+            reader->readFrames(block.startFrame, block.numFrames, block.channelPointers.data());
+            nextFrame += (uint64_t)block.numFrames;
+            reader->releaseFramesBefore(nextFrame);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                block.ready = true;
+            }
+            ready.notify_one();
+            slot ^= 1;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            finished = true;
+        }
+        ready.notify_one();
+    }
+
+    MappedWavReader* reader = nullptr;
+    Block blocks[2];
+    uint64_t nextFrame = 0;
+    uint64_t endFrame = 0;
+    int consumerSlot = 0;
+    bool finished = false;
+    bool quit = false;
+
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::condition_variable freed;
+    std::thread worker;
+};
+
+/**
+\class OfflineRenderer
+\brief
+Runs the plug-in's pre-gain -> post-gain circuit chain over a mapped file, one circuit
+pair per channel, writing the result straight into a mapped output file.
+*/
+class OfflineRenderer
+{
+public:
+    /** set the tone and volume resistances used by the post-gain circuit */
+    void setParameters(double _tone, double _volume)
+    {
+        tone = _tone;
+        volume = _volume;
+    }
+
+    /** set the block size used for prefetching and write-back */
+    void setBlockSize(int _blockSize) { blockSize = _blockSize; }
+
+    /** checkpoint to path roughly every intervalFrames while rendering; an empty path disables checkpoints */
+    void setCheckpoint(const std::string& path, uint64_t intervalFrames)
+    {
+        checkpointPath = path;
+        checkpointInterval = intervalFrames;
+    }
+
+    /** share a coefficient cache (may be nullptr); prepare( ) then reuses the coefficients of
+        parameter sets seen before, by this or any other renderer using the cache */
+    void setCoefficientCache(CoefficientCache* cache) { coefficientCache = cache; }
+
+    /** build circuits for this channel count and sample rate and clear their state */
+    void prepare(int numChannels, double sampleRate)
+    {
+        numActiveChannels = numChannels;
+
+        while ((int)preGainCircuits.size() < numChannels)
+        {
+            preGainCircuits.push_back(std::make_unique<WDFPreGainDistortionCircuit>());
+            postGainCircuits.push_back(std::make_unique<WDFPostGainDistortionCircuit>());
+        }
+
+        // --- circuits already built at this rate only need their state cleared and, on a cache
+        //     hit, the stored coefficients copied in
+        const CoefficientCache::Key key = CoefficientCache::makeKey(tone, volume, sampleRate);
+        int numCoefficients = 0;
+        const bool reuse = coefficientCache != nullptr && sampleRate == preparedSampleRate && numChannels <= numPreparedChannels
+            && coefficientCache->lookup(key, cachedCoefficients, numCoefficients)
+            && numCoefficients == postGainCircuits[0]->getNumCoefficients();
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            postGainCircuits[channel]->setTone(tone);
+            postGainCircuits[channel]->setVolume(volume);
+
+            if (reuse)
+            {
+                clearState(*preGainCircuits[channel]);
+                clearState(*postGainCircuits[channel]);
+                postGainCircuits[channel]->setCoefficients(cachedCoefficients);
+                continue;
+            }
+
+            // --- new values into the existing components: no allocation, the tree stays connected
+            postGainCircuits[channel]->updateComponents();
+            preGainCircuits[channel]->reset(sampleRate);
+            postGainCircuits[channel]->reset(sampleRate);
+        }
+
+        if (reuse)
+            return;
+
+        if (sampleRate != preparedSampleRate)
+            numPreparedChannels = 0;
+        preparedSampleRate = sampleRate;
+        numPreparedChannels = std::max(numPreparedChannels, numChannels);
+
+        numCoefficients = postGainCircuits[0]->getNumCoefficients();
+        if (coefficientCache != nullptr && numCoefficients <= CoefficientCache::maxCoefficients)
+        {
+            postGainCircuits[0]->getCoefficients(cachedCoefficients);
+            coefficientCache->insert(key, cachedCoefficients, numCoefficients);
+        }
+    }
+
+    /** frames of input to pre-roll before a chunk boundary for the current parameters: the
+        -120 dB tail of the circuit chain. Call after prepare( ). */
+    uint64_t getPreRollFrames(double sampleRate, uint64_t maxFrames)
+    {
+        IAudioSignalProcessor* chain[] = { preGainCircuits[0].get(), postGainCircuits[0].get() };
+        WdfTailAnalysis tail;
+
+        analysis.prepare(chain[0]->getNumStateRegisters() + chain[1]->getNumStateRegisters());
+        if (!analysis.analyse(chain, 2, sampleRate, tail))
+            return maxFrames;
+
+        return WdfAnalysis::getPreRollFrames(tail, sampleRate, maxFrames);
+    }
+
+    /** render only frames [firstFrame, firstFrame + numFrames) of the input into the same frames of
+        output, starting from rest far enough back that the chunk matches a whole-file render */
+    void renderRange(MappedWavReader& input, MappedWavWriter& output, uint64_t firstFrame, uint64_t numFrames)
+    {
+        const int numChannels = input.getNumChannels();
+        prepare(numChannels, input.getSampleRate());
+
+        const uint64_t preRoll = getPreRollFrames(input.getSampleRate(), firstFrame);
+        const uint64_t endFrame = std::min<uint64_t>(firstFrame + numFrames, input.getNumFrames());
+
+        BlockPrefetcher prefetcher;
+        prefetcher.start(input, blockSize, firstFrame - preRoll, endFrame);
+        std::vector<const float*> writePointers((size_t)numChannels);
+
+        while (BlockPrefetcher::Block* block = prefetcher.acquire())
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+            {
+                float* samples = block->channelPointers[channel];
+                WDFPreGainDistortionCircuit& preGain = *preGainCircuits[channel];
+                WDFPostGainDistortionCircuit& postGain = *postGainCircuits[channel];
+
+                for (int i = 0; i < block->numFrames; i++)
+                    samples[i] = (float)postGain.processAudioSample(preGain.processAudioSample(samples[i]));
+            }
+
+            // --- pre-roll frames only settle the state; write from firstFrame on
+            const int numFrames = block->numFrames;
+            const uint64_t blockEnd = block->startFrame + (uint64_t)numFrames;
+            if (blockEnd > firstFrame)
+            {
+                const int skip = (int)(block->startFrame < firstFrame ? firstFrame - block->startFrame : 0);
+                for (int channel = 0; channel < numChannels; channel++)
+                    writePointers[channel] = block->channelPointers[channel] + skip;
+
+                output.writeFrames(block->startFrame + (uint64_t)skip, numFrames - skip, writePointers.data());
+                framesRendered += (uint64_t)(numFrames - skip);
+            }
+            prefetcher.release(block);
+
+            output.flushFramesBefore(blockEnd);
+        }
+    }
+
+    /** render the input into output, which must already exist with the same layout; pass a loaded
+        checkpoint to continue an interrupted render. Returns false if a checkpoint could not be written. */
+    bool render(MappedWavReader& input, MappedWavWriter& output, const CircuitCheckpoint* resumeFrom = nullptr)
+    {
+        const int numChannels = input.getNumChannels();
+        uint64_t startFrame = 0;
+
+        if (resumeFrom != nullptr)
+        {
+            setParameters(resumeFrom->tone, resumeFrom->volume);
+            startFrame = resumeFrom->framePosition;
+        }
+
+        prepare(numChannels, input.getSampleRate());
+
+        if (resumeFrom != nullptr && !restoreCheckpoint(*resumeFrom, numChannels))
+        {
+            error = "checkpoint does not match this circuit";
+            return false;
+        }
+
+        BlockPrefetcher prefetcher;
+        prefetcher.start(input, blockSize, startFrame);
+
+        bool checkpointsOk = true;
+        uint64_t lastCheckpoint = startFrame;
+
+        while (BlockPrefetcher::Block* block = prefetcher.acquire())
+        {
+            for (int channel = 0; channel < numChannels; channel++)
+            {
+                float* samples = block->channelPointers[channel];
+                WDFPreGainDistortionCircuit& preGain = *preGainCircuits[channel];
+                WDFPostGainDistortionCircuit& postGain = *postGainCircuits[channel];
+
+                for (int i = 0; i < block->numFrames; i++)
+                    samples[i] = (float)postGain.processAudioSample(preGain.processAudioSample(samples[i]));
+            }
+
+            const int numFrames = block->numFrames;
+            const uint64_t endFrame = block->startFrame + (uint64_t)numFrames;
+            output.writeFrames(block->startFrame, numFrames, block->channelPointers.data());
+            prefetcher.release(block);
+
+            output.flushFramesBefore(endFrame);
+            framesRendered += (uint64_t)numFrames;
+
+            if (!checkpointPath.empty() && endFrame - lastCheckpoint >= checkpointInterval && endFrame < input.getNumFrames())
+            {
+                // --- the audio must be on disk before a checkpoint claims it
+                CircuitCheckpoint checkpoint;
+                captureCheckpoint(checkpoint, endFrame, input.getNumFrames(), input.getSampleRate());
+                checkpointsOk = output.sync() && checkpoint.save(checkpointPath, error) && checkpointsOk;
+                lastCheckpoint = endFrame;
+            }
+        }
+
+        return checkpointsOk;
+    }
+
+    /** snapshot every channel's circuit registers; call between blocks */
+    void captureCheckpoint(CircuitCheckpoint& checkpoint, uint64_t framePosition, uint64_t totalFrames, double sampleRate)
+    {
+        checkpoint.framePosition = framePosition;
+        checkpoint.totalFrames = totalFrames;
+        checkpoint.sampleRate = sampleRate;
+        checkpoint.tone = tone;
+        checkpoint.volume = volume;
+        checkpoint.channelRegisters.resize(numActiveChannels);
+
+        for (int channel = 0; channel < numActiveChannels; channel++)
+        {
+            WDFPreGainDistortionCircuit& preGain = *preGainCircuits[channel];
+            WDFPostGainDistortionCircuit& postGain = *postGainCircuits[channel];
+            std::vector<double>& registers = checkpoint.channelRegisters[channel];
+
+            registers.resize(preGain.getNumStateRegisters() + postGain.getNumStateRegisters());
+            preGain.getStateRegisters(registers.data());
+            postGain.getStateRegisters(registers.data() + preGain.getNumStateRegisters());
+        }
+    }
+
+    /** restore registers captured by captureCheckpoint( ); the circuits must already be prepared */
+    bool restoreCheckpoint(const CircuitCheckpoint& checkpoint, int numChannels)
+    {
+        if ((int)checkpoint.channelRegisters.size() < numChannels)
+            return false;
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            WDFPreGainDistortionCircuit& preGain = *preGainCircuits[channel];
+            WDFPostGainDistortionCircuit& postGain = *postGainCircuits[channel];
+            const std::vector<double>& registers = checkpoint.channelRegisters[channel];
+
+            if ((int)registers.size() != preGain.getNumStateRegisters() + postGain.getNumStateRegisters())
+                return false;
+
+            preGain.setStateRegisters(registers.data());
+            postGain.setStateRegisters(registers.data() + preGain.getNumStateRegisters());
+        }
+        return true;
+    }
+
+    /** last checkpoint error, if render( ) returned false */
+    const std::string& getError() const { return error; }
+
+    /** total frames rendered by this object */
+    uint64_t getFramesRendered() const { return framesRendered; }
+
+protected:
+    double tone = 5000.0;
+    double volume = 10000.0;
+    int blockSize = 4096;
+    int numActiveChannels = 0;
+    uint64_t framesRendered = 0;
+
+    std::string checkpointPath;
+    uint64_t checkpointInterval = 0;
+    std::string error;
+
+    std::vector<std::unique_ptr<WDFPreGainDistortionCircuit>> preGainCircuits;
+    std::vector<std::unique_ptr<WDFPostGainDistortionCircuit>> postGainCircuits;
+    WdfAnalysis analysis;
+
+    CoefficientCache* coefficientCache = nullptr;
+    double cachedCoefficients[CoefficientCache::maxCoefficients];
+    double preparedSampleRate = 0.0;    ///< rate the first numPreparedChannels circuits were built at
+    int numPreparedChannels = 0;
+
+private:
+    static void clearState(IAudioSignalProcessor& circuit)
+    {
+        std::vector<double> zeros((size_t)circuit.getNumStateRegisters(), 0.0);
+        circuit.setStateRegisters(zeros.data());
+    }
+};
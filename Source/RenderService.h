@@ -0,0 +1,571 @@
+/*
+  ==============================================================================
+
+    RenderService.h
+    Created: 18 Oct 2026 11:20:44am
+    Author:  Richie Haynes
+
+    Long-running render service. Worker threads each own an OfflineRenderer
+    whose circuits stay built between jobs, so a job only pays for setting its
+    tone/volume values. Jobs arrive over a Unix domain socket using a small
+    framed protocol and are scheduled by priority (FIFO within a priority).
+
+    Frame layout (little-endian):
+        uint32 magic 'WDFJ' | uint16 version | uint16 type | uint32 length | payload
+    Payloads are "key=value" lines.
+
+    POSIX only; used by the render tool, not by the plug-in.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <queue>
+#include <sstream>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#include "RenderPipeline.h"
+
+#ifndef MSG_NOSIGNAL
+ #define MSG_NOSIGNAL 0    // macOS: callers ignore SIGPIPE instead
+#endif
+
+/**
+\class RenderProtocol
+\brief
+Framing helpers shared by the render service and its clients.
+*/
+class RenderProtocol
+{
+public:
+    enum MessageType : uint16_t
+    {
+        submitJob = 1,  ///< payload: input, output, tone, volume, priority, bits, wait
+        getStats,       ///< no payload
+        shutdown,       ///< no payload
+        replyOk,        ///< payload depends on request
+        replyError      ///< payload: error
+    };
+
+    typedef std::map<std::string, std::string> Fields;
+
+    static const uint32_t magic = 0x4A464457;   // 'WDFJ'
+    static const uint16_t version = 1;
+    static const uint32_t maxPayload = 1 << 16;
+
+    /** write one frame; returns false if the peer went away */
+    static bool writeMessage(int fd, MessageType type, const Fields& fields)
+    {
+        std::string payload;
+        for (auto& field : fields)
+            payload += field.first + "=" + field.second + "\n";
+
+        uint8_t header[12];
+        putU32(header, magic);
+        header[4] = (uint8_t)version; header[5] = (uint8_t)(version >> 8);
+        header[6] = (uint8_t)type; header[7] = (uint8_t)(type >> 8);
+        putU32(header + 8, (uint32_t)payload.size());
+
+        return writeAll(fd, header, sizeof(header)) && writeAll(fd, payload.data(), payload.size());
+    }
+
+    /** read one frame; returns false on EOF, a bad header or an oversized payload */
+    static bool readMessage(int fd, MessageType& type, Fields& fields)
+    {
+        uint8_t header[12];
+        if (!readAll(fd, header, sizeof(header)))
+            return false;
+
+        uint32_t length = getU32(header + 8);
+        if (getU32(header) != magic || (header[4] | header[5] << 8) != version || length > maxPayload)
+            return false;
+
+        std::string payload(length, '\0');
+        if (!readAll(fd, &payload[0], length))
+            return false;
+
+        type = (MessageType)(header[6] | header[7] << 8);
+        fields.clear();
+
+        std::istringstream lines(payload);
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            size_t equals = line.find('=');
+            if (equals != std::string::npos)
+                fields[line.substr(0, equals)] = line.substr(equals + 1);
+        }
+        return true;
+    }
+
+    /** connect to a service socket; returns -1 on failure */
+    static int connectTo(const std::string& socketPath)
+    {
+        sockaddr_un address;
+        if (!makeAddress(socketPath, address))
+            return -1;
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (sockaddr*)&address, sizeof(address)) != 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+        return fd;
+    }
+
+    /** fill a sockaddr_un; false if the path is too long */
+    static bool makeAddress(const std::string& socketPath, sockaddr_un& address)
+    {
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path))
+            return false;
+
+        std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+        return true;
+    }
+
+private:
+    static void putU32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+    static uint32_t getU32(const uint8_t* p) { return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24; }
+
+    static bool writeAll(int fd, const void* data, size_t size)
+    {
+        const char* p = (const char*)data;
+        while (size > 0)
+        {
+            ssize_t written = send(fd, p, size, MSG_NOSIGNAL);
+            if (written <= 0)
+                return false;
+            p += written;
+            size -= (size_t)written;
+        }
+        return true;
+    }
+
+    static bool readAll(int fd, void* data, size_t size)
+    {
+        char* p = (char*)data;
+        while (size > 0)
+        {
+            ssize_t received = recv(fd, p, size, 0);
+            if (received <= 0)
+                return false;
+            p += received;
+            size -= (size_t)received;
+        }
+        return true;
+    }
+};
+
+/**
+\struct RenderJob
+\brief
+One queued render request and its outcome.
+*/
+struct RenderJob
+{
+    uint64_t id = 0;
+    int priority = 0;               ///< higher runs first
+    std::string inputPath;
+    std::string outputPath;
+    double tone = 5000.0;
+    double volume = 10000.0;
+    std::string bits = "float";     ///< 16, 24, 32 or float
+
+    bool done = false;
+    bool failed = false;
+    std::string error;
+    uint64_t frames = 0;
+};
+
+/**
+\class RenderService
+\brief
+Priority job queue served by a fixed pool of warm OfflineRenderer workers, plus the
+Unix-socket front end.
+*/
+class RenderService
+{
+public:
+    /** snapshot of the service counters */
+    struct Stats
+    {
+        size_t queueDepth = 0;
+        int busyWorkers = 0;
+        int numWorkers = 0;
+        uint64_t jobsCompleted = 0;
+        uint64_t jobsFailed = 0;
+        double audioSecondsRendered = 0.0;
+        double busySeconds = 0.0;
+        double uptimeSeconds = 0.0;
+        uint64_t cacheHits = 0;         ///< shared coefficient cache
+        uint64_t cacheMisses = 0;
+        double cacheHitRate = 0.0;
+    };
+
+    ~RenderService() { stop(); }
+
+    /** start the worker pool; circuits are built here, not per job */
+    void start(int numWorkers)
+    {
+        startTime = std::chrono::steady_clock::now();
+        quit = false;
+
+        for (int i = 0; i < numWorkers; i++)
+        {
+            auto renderer = std::make_unique<OfflineRenderer>();
+            renderer->setCoefficientCache(&coefficientCache);
+            renderer->prepare(2, 48000.0);
+            renderers.push_back(std::move(renderer));
+        }
+
+        for (int i = 0; i < numWorkers; i++)
+            workers.emplace_back([this, i] { runWorker(*renderers[i]); });
+    }
+
+    /** drain the queue and join the pool */
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        jobAvailable.notify_all();
+        jobFinished.notify_all();
+
+        for (auto& worker : workers)
+            worker.join();
+
+        workers.clear();
+    }
+
+    /** queue a job and return its id */
+    uint64_t submit(RenderJob job)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        job.id = ++lastJobId;
+
+        // --- forget old finished jobs so a long-lived service doesn't grow without bound
+        if (jobs.size() >= maxRememberedJobs)
+            for (auto it = jobs.begin(); it != jobs.end();)
+                it = it->second->done ? jobs.erase(it) : std::next(it);
+
+        auto shared = std::make_shared<RenderJob>(job);
+        jobs[job.id] = shared;
+        queue.push(shared);
+        jobAvailable.notify_one();
+        return job.id;
+    }
+
+    /** block until a job has finished; returns a copy of its final state */
+    RenderJob waitFor(uint64_t id)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto found = jobs.find(id);
+        if (found == jobs.end())
+            return RenderJob();
+
+        std::shared_ptr<RenderJob> job = found->second;
+        jobFinished.wait(lock, [&] { return job->done || quit; });
+        return *job;
+    }
+
+    /** read the counters */
+    Stats getStats()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats stats = counters;
+        stats.queueDepth = queue.size();
+        stats.numWorkers = (int)workers.size();
+        stats.uptimeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        stats.cacheHits = coefficientCache.getHits();
+        stats.cacheMisses = coefficientCache.getMisses();
+        stats.cacheHitRate = coefficientCache.getHitRate();
+        return stats;
+    }
+
+    /** accept and serve connections on socketPath until a shutdown message arrives; fails if
+        another service is already listening there */
+    bool serve(const std::string& socketPath, std::string& error)
+    {
+        sockaddr_un address;
+        if (!RenderProtocol::makeAddress(socketPath, address))
+        {
+            error = "socket path too long";
+            return false;
+        }
+
+        // --- only a stale socket (nobody accepting on it) is removed; anything else is left alone
+        struct stat info;
+        if (lstat(socketPath.c_str(), &info) == 0)
+        {
+            int running = RenderProtocol::connectTo(socketPath);
+            if (running >= 0)
+            {
+                ::close(running);
+                error = "a render service is already listening on " + socketPath;
+                return false;
+            }
+            if (!S_ISSOCK(info.st_mode))
+            {
+                error = socketPath + " exists and is not a socket";
+                return false;
+            }
+            unlink(socketPath.c_str());
+        }
+
+        int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0 || bind(listener, (sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0)
+        {
+            error = "cannot listen on " + socketPath;
+            if (listener >= 0)
+                ::close(listener);
+            return false;
+        }
+
+        std::vector<Connection> connections;
+        while (!shutdownRequested)
+        {
+            int client = accept(listener, nullptr, nullptr);
+            if (client < 0)
+                continue;
+
+            reapConnections(connections, false);
+
+            // --- the connection that wakes accept( ) after a shutdown request
+            if (shutdownRequested)
+            {
+                ::close(client);
+                break;
+            }
+
+            if (connections.size() >= maxConnections)
+            {
+                RenderProtocol::writeMessage(client, RenderProtocol::replyError, { { "error", "too many connections" } });
+                ::close(client);
+                continue;
+            }
+
+            // --- an idle client is dropped rather than holding a connection slot forever
+            timeval timeout = { idleTimeoutSeconds, 0 };
+            setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+            auto finished = std::make_shared<std::atomic<bool>>(false);
+            connections.push_back({ std::thread([this, client, socketPath, finished]
+                                                {
+                                                    serveClient(client, socketPath);
+                                                    *finished = true;
+                                                }),
+                                    client, finished });
+        }
+
+        // --- unblock clients still waiting in recv( ), then join them
+        for (auto& connection : connections)
+            ::shutdown(connection.fd, SHUT_RDWR);
+        reapConnections(connections, true);
+
+        ::close(listener);
+        unlink(socketPath.c_str());
+        return true;
+    }
+
+private:
+    /** a client connection and the thread serving it; the fd is closed when the thread is joined */
+    struct Connection
+    {
+        std::thread thread;
+        int fd = -1;
+        std::shared_ptr<std::atomic<bool>> finished;
+    };
+
+    /** join and close finished connections, or all of them */
+    static void reapConnections(std::vector<Connection>& connections, bool all)
+    {
+        for (auto it = connections.begin(); it != connections.end();)
+        {
+            if (!all && !*it->finished)
+            {
+                ++it;
+                continue;
+            }
+
+            it->thread.join();
+            ::close(it->fd);
+            it = connections.erase(it);
+        }
+    }
+
+    struct LaterFirst
+    {
+        bool operator()(const std::shared_ptr<RenderJob>& a, const std::shared_ptr<RenderJob>& b) const
+        {
+            return a->priority != b->priority ? a->priority < b->priority : a->id > b->id;
+        }
+    };
+
+    void runWorker(OfflineRenderer& renderer)
+    {
+        for (;;)
+        {
+            std::shared_ptr<RenderJob> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAvailable.wait(lock, [&] { return quit || !queue.empty(); });
+                if (queue.empty())
+                    return;
+
+                job = queue.top();
+                queue.pop();
+                counters.busyWorkers++;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            double sampleRate = 0.0;
+            render(renderer, *job, sampleRate);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                counters.busyWorkers--;
+                counters.busySeconds += seconds;
+                if (job->failed)
+                    counters.jobsFailed++;
+                else
+                    counters.jobsCompleted++;
+                if (sampleRate > 0.0)
+                    counters.audioSecondsRendered += (double)job->frames / sampleRate;
+                job->done = true;
+            }
+            jobFinished.notify_all();
+        }
+    }
+
+    void render(OfflineRenderer& renderer, RenderJob& job, double& sampleRate)
+    {
+        MappedWavReader input;
+        MappedWavWriter output;
+        const bool asFloat = job.bits == "float";
+
+        if (!input.open(job.inputPath, job.error)
+            || !output.create(job.outputPath, input.getNumChannels(), input.getSampleRate(),
+                              asFloat ? 32 : std::atoi(job.bits.c_str()), asFloat, input.getNumFrames(), job.error))
+        {
+            job.failed = true;
+            return;
+        }
+
+        uint64_t before = renderer.getFramesRendered();
+        renderer.setParameters(job.tone, job.volume);
+        renderer.render(input, output);
+        output.close();
+
+        job.frames = renderer.getFramesRendered() - before;
+        sampleRate = input.getSampleRate();
+    }
+
+    /** answer requests on one connection until it closes; the caller closes client */
+    void serveClient(int client, const std::string& socketPath)
+    {
+        RenderProtocol::MessageType type;
+        RenderProtocol::Fields request;
+
+        while (RenderProtocol::readMessage(client, type, request))
+        {
+            if (type == RenderProtocol::submitJob)
+            {
+                RenderJob job;
+                job.inputPath = request["input"];
+                job.outputPath = request["output"];
+                if (request.count("tone")) job.tone = std::atof(request["tone"].c_str());
+                if (request.count("volume")) job.volume = std::atof(request["volume"].c_str());
+                if (request.count("priority")) job.priority = std::atoi(request["priority"].c_str());
+                if (request.count("bits")) job.bits = request["bits"];
+
+                if (job.inputPath.empty() || job.outputPath.empty())
+                {
+                    RenderProtocol::writeMessage(client, RenderProtocol::replyError, { { "error", "input and output are required" } });
+                    continue;
+                }
+
+                uint64_t id = submit(job);
+                if (request["wait"] == "1")
+                {
+                    RenderJob finished = waitFor(id);
+                    RenderProtocol::writeMessage(client, finished.failed ? RenderProtocol::replyError : RenderProtocol::replyOk,
+                                                 { { "job", std::to_string(id) }, { "frames", std::to_string(finished.frames) },
+                                                   { "error", finished.error } });
+                }
+                else
+                {
+                    RenderProtocol::writeMessage(client, RenderProtocol::replyOk, { { "job", std::to_string(id) } });
+                }
+            }
+            else if (type == RenderProtocol::getStats)
+            {
+                Stats stats = getStats();
+                char throughput[64];
+                std::snprintf(throughput, sizeof(throughput), "%.2f",
+                              stats.busySeconds > 0.0 ? stats.audioSecondsRendered / stats.busySeconds : 0.0);
+                char hitRate[64];
+                std::snprintf(hitRate, sizeof(hitRate), "%.3f", stats.cacheHitRate);
+
+                RenderProtocol::writeMessage(client, RenderProtocol::replyOk,
+                                             { { "queue_depth", std::to_string(stats.queueDepth) },
+                                               { "busy_workers", std::to_string(stats.busyWorkers) },
+                                               { "workers", std::to_string(stats.numWorkers) },
+                                               { "jobs_completed", std::to_string(stats.jobsCompleted) },
+                                               { "jobs_failed", std::to_string(stats.jobsFailed) },
+                                               { "audio_seconds", std::to_string(stats.audioSecondsRendered) },
+                                               { "uptime_seconds", std::to_string(stats.uptimeSeconds) },
+                                               { "realtime_factor_per_worker", throughput },
+                                               { "cache_hits", std::to_string(stats.cacheHits) },
+                                               { "cache_misses", std::to_string(stats.cacheMisses) },
+                                               { "cache_hit_rate", hitRate } });
+            }
+            else if (type == RenderProtocol::shutdown)
+            {
+                shutdownRequested = true;
+                RenderProtocol::writeMessage(client, RenderProtocol::replyOk, {});
+
+                // --- wake the accept() loop so it sees the flag
+                int wake = RenderProtocol::connectTo(socketPath);
+                if (wake >= 0)
+                    ::close(wake);
+            }
+            else
+            {
+                RenderProtocol::writeMessage(client, RenderProtocol::replyError, { { "error", "unknown request" } });
+            }
+        }
+    }
+
+    static const size_t maxRememberedJobs = 4096;
+    static const size_t maxConnections = 64;
+    static const int idleTimeoutSeconds = 300;
+
+    std::vector<std::unique_ptr<OfflineRenderer>> renderers;
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobFinished;
+    std::priority_queue<std::shared_ptr<RenderJob>, std::vector<std::shared_ptr<RenderJob>>, LaterFirst> queue;
+    std::map<uint64_t, std::shared_ptr<RenderJob>> jobs;
+    uint64_t lastJobId = 0;
+    bool quit = false;
+    std::atomic<bool> shutdownRequested { false };
+
+    Stats counters;
+    std::chrono::steady_clock::time_point startTime;
+    CoefficientCache coefficientCache;      ///< shared by every worker
+};
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+    ResponseView.h
+    Created: 18 Oct 2026 7:18:06pm
+    Author:  Richie Haynes
+
+    Editor component plotting the magnitude and phase response of the
+    circuit chain for the current tone/volume and input stage setting, or
+    for the morph position while the processor runs the preset morph. The
+    view keeps its own circuits, built on the message thread, and evaluates
+    their transfer function analytically (WdfFrequencyResponse): no audio is
+    run and the audio thread is never touched. The curve is recomputed only
+    when a parameter has moved and drawn into a cached image, so the 60 Hz
+    timer is nearly free while nothing changes.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+#include "WdfFrequencyResponse.h"
+
+/**
+\class ResponseView
+\brief
+Analytic frequency-response plot of the processor's circuit chain.
+*/
+class ResponseView : public juce::Component, private juce::Timer
+{
+public:
+    static constexpr double lowestFrequency = 20.0;
+    static constexpr double highestFrequency = 20000.0;
+    static constexpr float decibelRange = 48.0f;    ///< vertical span, ending 3 dB above the peak
+
+    explicit ResponseView(DigitalFiltersAudioProcessor& p)
+        : audioProcessor(p),
+          tone(p.tree.getRawParameterValue("centreFreq")),
+          volume(p.tree.getRawParameterValue("volume")),
+          morph(p.tree.getRawParameterValue("morph")),
+          morphFrom(p.tree.getRawParameterValue("morphFrom")),
+          morphTo(p.tree.getRawParameterValue("morphTo"))
+    {
+        setOpaque(true);
+        analysis.prepare(preGainCircuit.getNumStateRegisters() + postGainCircuit.getNumStateRegisters());
+        startTimerHz(60);
+    }
+
+    ~ResponseView() override { stopTimer(); }
+
+    void paint(juce::Graphics& g) override
+    {
+        if (image.isValid())
+            g.drawImageAt(image, 0, 0);
+        else
+            g.fillAll(juce::Colours::black);
+    }
+
+    void resized() override
+    {
+        const int numPoints = juce::jmax(2, getWidth());
+        frequencies.resize((size_t)numPoints);
+        magnitudes.resize((size_t)numPoints);
+        phases.resize((size_t)numPoints);
+        for (int i = 0; i < numPoints; i++)
+            frequencies[(size_t)i] = lowestFrequency * std::pow(highestFrequency / lowestFrequency, (double)i / (double)(numPoints - 1));
+
+        image = getWidth() > 0 && getHeight() > 0 ? juce::Image(juce::Image::RGB, getWidth(), getHeight(), true) : juce::Image();
+        lastTone = -1.0f;   // recompute and redraw at the new size
+        timerCallback();
+    }
+
+private:
+    void timerCallback() override
+    {
+        float currentTone = tone->load();
+        float currentVolume = volume->load();
+
+        // --- the morph breakpoints are circuits built at these values, so the exact circuit stands in for them
+        if (audioProcessor.isMorphActive())
+        {
+            const int from = (int)morphFrom->load();
+            const int to = (int)morphTo->load();
+            currentTone = (float)PresetBank::getMorphTone(from, to, morph->load());
+            currentVolume = (float)PresetBank::getMorphVolume(from, to, morph->load());
+        }
+
+        const bool currentPreGain = audioProcessor.filterToggle != 0;
+        const double sampleRate = audioProcessor.getSampleRate() > 0.0 ? audioProcessor.getSampleRate() : 48000.0;
+
+        if (currentTone == lastTone && currentVolume == lastVolume && currentPreGain == lastPreGain && sampleRate == lastSampleRate)
+            return;
+
+        lastTone = currentTone;
+        lastVolume = currentVolume;
+        lastPreGain = currentPreGain;
+        lastSampleRate = sampleRate;
+
+        if (!computeResponse(sampleRate))
+            return;
+
+        renderImage();
+        repaint();
+    }
+
+    /** rebuild the private circuits and evaluate the response at every pixel column */
+    bool computeResponse(double sampleRate)
+    {
+        preGainCircuit.createWDF();
+        preGainCircuit.reset(sampleRate);
+
+        postGainCircuit.setTone(lastTone);
+        postGainCircuit.setVolume(lastVolume);
+        postGainCircuit.createWDF();
+        postGainCircuit.reset(sampleRate);
+
+        IAudioSignalProcessor* chain[] = { &preGainCircuit, &postGainCircuit };
+        IAudioSignalProcessor* const* first = lastPreGain ? chain : chain + 1;
+        if (!analysis.realise(first, lastPreGain ? 2 : 1, model))
+            return false;
+
+        response.setModel(model);
+        response.evaluate(frequencies.data(), (int)frequencies.size(), sampleRate, magnitudes.data(), phases.data());
+        return true;
+    }
+
+    void renderImage()
+    {
+        if (!image.isValid())
+            return;
+
+        juce::Graphics g(image);
+        const float width = (float)image.getWidth();
+        const float height = (float)image.getHeight();
+        g.fillAll(juce::Colours::black);
+
+        const float top = 3.0f + (float)*std::max_element(magnitudes.begin(), magnitudes.end());
+        const float bottom = top - decibelRange;
+
+        // --- 12 dB grid below the top
+        g.setColour(juce::Colours::white.withAlpha(0.1f));
+        for (float level = std::floor(top / 12.0f) * 12.0f; level > bottom; level -= 12.0f)
+            g.drawHorizontalLine((int)juce::jmap(level, bottom, top, height, 0.0f), 0.0f, width);
+
+        juce::Path magnitude;
+        juce::Path phase;
+        for (size_t i = 0; i < magnitudes.size(); i++)
+        {
+            const float x = width * (float)i / (float)(magnitudes.size() - 1);
+            const float yMagnitude = juce::jmap((float)magnitudes[i], bottom, top, height, 0.0f);
+            const float yPhase = juce::jmap((float)phases[i], -juce::MathConstants<float>::pi, juce::MathConstants<float>::pi, height, 0.0f);
+
+            if (i == 0)
+            {
+                magnitude.startNewSubPath(x, yMagnitude);
+                phase.startNewSubPath(x, yPhase);
+            }
+            else
+            {
+                magnitude.lineTo(x, yMagnitude);
+                phase.lineTo(x, yPhase);
+            }
+        }
+
+        g.setColour(juce::Colours::lightgreen.withAlpha(0.4f));
+        g.strokePath(phase, juce::PathStrokeType(1.0f));
+        g.setColour(juce::Colours::lightgreen);
+        g.strokePath(magnitude, juce::PathStrokeType(2.0f));
+
+        g.setColour(juce::Colours::white.withAlpha(0.6f));
+        g.setFont(11.0f);
+        g.drawText(juce::String(top, 1) + " dB", 4, 2, 80, 14, juce::Justification::topLeft);
+    }
+
+    DigitalFiltersAudioProcessor& audioProcessor;
+    std::atomic<float>* tone;
+    std::atomic<float>* volume;
+    std::atomic<float>* morph;
+    std::atomic<float>* morphFrom;
+    std::atomic<float>* morphTo;
+
+    // --- message-thread copies of the circuits, never the ones the audio thread runs
+    WDFPreGainDistortionCircuit preGainCircuit;
+    WDFPostGainDistortionCircuit postGainCircuit;
+    WdfAnalysis analysis;
+    WdfStateSpace model;
+    WdfFrequencyResponse response;
+
+    std::vector<double> frequencies;
+    std::vector<double> magnitudes;
+    std::vector<double> phases;
+    juce::Image image;
+
+    float lastTone = -1.0f;
+    float lastVolume = -1.0f;
+    bool lastPreGain = true;
+    double lastSampleRate = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResponseView)
+};
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    SilenceDetector.h
+    Created: 18 Oct 2026 2:26:50pm
+    Author:  Richie Haynes
+
+    Per-channel idle tracking for the WDF chain. A channel goes idle once its
+    input has been silent and the energy left in the circuit's state
+    registers has decayed below what can reach the output above the
+    threshold; while idle, processBlock skips the circuit and writes silence.
+    The registers are flushed to zero on the way in, which is inaudible
+    because they are already below the threshold, so the circuit wakes from
+    its rest state without a discontinuity.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <limits>
+
+#include "FilterObjects.h"
+
+/**
+\class SilenceDetector
+\brief
+Decides, block by block, whether a channel's circuits can be bypassed.
+*/
+class SilenceDetector
+{
+public:
+    /** -120 dBFS */
+    static constexpr float defaultThreshold = 1.0e-6f;
+
+    /** maximum registers across the circuits a detector watches */
+    static const int maxStateRegisters = 64;
+
+    /** set the silence threshold (linear amplitude) */
+    void setThreshold(float _threshold) { threshold = _threshold; }
+
+    /** set the bound on output amplitude per unit of register norm (WdfTailAnalysis::outputGain),
+        so the state threshold corresponds to the output threshold; 0 means the state is inaudible */
+    void setStateGain(double _stateGain) { stateGain = _stateGain; }
+
+    /** leave the idle state, e.g. after a reset or a parameter rebuild */
+    void wake() { idle = false; }
+
+    /** true while the channel's circuits are being skipped */
+    bool isIdle() const { return idle; }
+
+    /** true if every sample of the block is below the threshold */
+    bool isSilent(const float* samples, int numSamples) const
+    {
+        for (int i = 0; i < numSamples; i++)
+            if (std::fabs(samples[i]) > threshold)
+                return false;
+
+        return true;
+    }
+
+    /** call after processing a block whose input was silent; enters the idle state (flushing
+        the circuits) once the state energy has decayed. Returns true if the channel is now idle. */
+    bool updateAfterSilentBlock(IAudioSignalProcessor* const* circuits, int numCircuits)
+    {
+        double energy = 0.0;
+        for (int i = 0; i < numCircuits; i++)
+            energy += getStateEnergy(*circuits[i]);
+
+        if (energy > getStateThreshold() * getStateThreshold())
+            return false;
+
+        for (int i = 0; i < numCircuits; i++)
+            flush(*circuits[i]);
+
+        idle = true;
+        return true;
+    }
+
+    /** sum of squares of a circuit's state registers */
+    static double getStateEnergy(IAudioSignalProcessor& circuit)
+    {
+        int numRegisters = circuit.getNumStateRegisters();
+        if (numRegisters > maxStateRegisters)
+            return HUGE_VAL;    // too big to inspect: never idle
+
+        double registers[maxStateRegisters];
+        circuit.getStateRegisters(registers);
+
+        double energy = 0.0;
+        for (int i = 0; i < numRegisters; i++)
+            energy += registers[i] * registers[i];
+
+        return energy;
+    }
+
+    /** zero a circuit's state registers without touching its coefficients */
+    static void flush(IAudioSignalProcessor& circuit)
+    {
+        double registers[maxStateRegisters] = {};
+        if (circuit.getNumStateRegisters() <= maxStateRegisters)
+            circuit.setStateRegisters(registers);
+    }
+
+private:
+    double getStateThreshold() const
+    {
+        return stateGain > 0.0 ? (double)threshold / stateGain : std::sqrt(std::numeric_limits<double>::max());
+    }
+
+    float threshold = defaultThreshold;
+    double stateGain = 1.0;
+    bool idle = false;
+};
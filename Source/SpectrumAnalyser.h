@@ -0,0 +1,308 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.h
+    Created: 18 Oct 2026 6:20:14pm
+    Author:  Richie Haynes
+
+    Spectrum and scope display of the circuit output. The audio thread hands
+    each processed block to a wait-free single-producer/single-consumer FIFO
+    (juce::AbstractFifo): one or two memcpys, nothing else. Everything else
+    runs on the message thread. SpectrumAnalyser drains the FIFO and runs the
+    FFT at most once per frame interval, however many editors are open;
+    every AnalyserView redraws its cached image only when a new frame has
+    been produced, and paint( ) just blits that image.
+
+    The frame interval adapts to a CPU budget: if draining, FFT and drawing
+    take more than cpuBudget of the message thread over a one second window
+    the interval doubles, and it halves again once well under budget.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <JuceHeader.h>
+
+/**
+\class SpectrumAnalyser
+\brief
+Shared analysis model: the audio-thread FIFO plus the message-thread FFT.
+*/
+class SpectrumAnalyser
+{
+public:
+    static const int fftOrder = 11;
+    static const int fftSize = 1 << fftOrder;       ///< 2048 points
+    static const int numBins = fftSize / 2;
+    static const int scopeSize = 512;               ///< samples shown by the scope
+    static const int fifoSize = 16384;              ///< ~340 ms at 48 kHz before blocks are dropped
+
+    static constexpr double cpuBudget = 0.02;       ///< fraction of the message thread for the analyser
+    static constexpr double minFrameIntervalMs = 33.0;
+    static constexpr double maxFrameIntervalMs = 250.0;
+    static constexpr float minimumDecibels = -100.0f;
+
+    SpectrumAnalyser()
+        : fifo(fifoSize), fifoBuffer(fifoSize, 0.0f), fft(fftOrder),
+          window(fftSize, juce::dsp::WindowingFunction<float>::hann, false),
+          history(fftSize, 0.0f), fftData(2 * fftSize, 0.0f),
+          levels(numBins, minimumDecibels), scope(scopeSize, 0.0f)
+    {
+    }
+
+    /** sample rate of the pushed audio, for the frequency axis */
+    void setSampleRate(double _sampleRate) { sampleRate = _sampleRate; }
+    double getSampleRate() const { return sampleRate.load(); }
+
+    /** audio thread: queue samples; a block that does not fit is dropped rather than waited for */
+    void pushSamples(const float* samples, int numSamples)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        if (size1 + size2 < numSamples)
+            return;
+
+        std::memcpy(fifoBuffer.data() + start1, samples, (size_t)size1 * sizeof(float));
+        if (size2 > 0)
+            std::memcpy(fifoBuffer.data() + start2, samples + size1, (size_t)size2 * sizeof(float));
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    /** message thread: drain the FIFO and compute a new frame if the frame interval has passed.
+        Returns the current frame number; views redraw when it changes. */
+    uint64_t update()
+    {
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        if (now - lastFrameTime < frameIntervalMs)
+            return frameNumber;
+
+        lastFrameTime = now;
+        if (drain() > 0)
+        {
+            computeSpectrum();
+            computeScope();
+            frameNumber++;
+        }
+
+        addWork(juce::Time::getMillisecondCounterHiRes() - now);
+        return frameNumber;
+    }
+
+    /** message thread: account for time spent drawing, towards the CPU budget */
+    void addWork(double milliseconds)
+    {
+        workMs += milliseconds;
+
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        const double elapsed = now - budgetWindowStart;
+        if (elapsed < 1000.0)
+            return;
+
+        const double load = workMs / elapsed;
+        if (load > cpuBudget)
+            frameIntervalMs = juce::jmin(maxFrameIntervalMs, frameIntervalMs * 2.0);
+        else if (load < 0.25 * cpuBudget)
+            frameIntervalMs = juce::jmax(minFrameIntervalMs, frameIntervalMs * 0.5);
+
+        budgetWindowStart = now;
+        workMs = 0.0;
+    }
+
+    /** current spacing between frames; views poll at this rate */
+    double getFrameIntervalMs() const { return frameIntervalMs; }
+
+    /** magnitude per FFT bin in dB, floored at minimumDecibels */
+    const std::vector<float>& getLevels() const { return levels; }
+
+    /** the most recent scopeSize samples, starting at a rising zero crossing where there is one */
+    const std::vector<float>& getScope() const { return scope; }
+
+private:
+    /** move queued samples into the history window; returns how many arrived */
+    int drain()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(fifo.getNumReady(), start1, size1, start2, size2);
+
+        append(fifoBuffer.data() + start1, size1);
+        append(fifoBuffer.data() + start2, size2);
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+    void append(const float* samples, int numSamples)
+    {
+        if (numSamples >= fftSize)
+        {
+            std::copy(samples + numSamples - fftSize, samples + numSamples, history.begin());
+            return;
+        }
+
+        std::copy(history.begin() + numSamples, history.end(), history.begin());
+        std::copy(samples, samples + numSamples, history.end() - numSamples);
+    }
+
+    void computeSpectrum()
+    {
+        std::copy(history.begin(), history.end(), fftData.begin());
+        window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+        fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+        // --- full scale sine = 0 dB: the Hann window's coherent gain is 1/2
+        const float scale = 4.0f / (float)fftSize;
+        for (int bin = 0; bin < numBins; bin++)
+        {
+            float level = juce::Decibels::gainToDecibels(fftData[(size_t)bin] * scale, minimumDecibels);
+
+            // --- fast attack, slow release so the display does not flicker
+            levels[(size_t)bin] = level > levels[(size_t)bin] ? level : juce::jmax(level, levels[(size_t)bin] - 3.0f);
+        }
+    }
+
+    void computeScope()
+    {
+        int start = fftSize - scopeSize;
+        for (int i = fftSize - scopeSize; i > 0; i--)
+        {
+            if (history[(size_t)i - 1] < 0.0f && history[(size_t)i] >= 0.0f)
+            {
+                start = i;
+                break;
+            }
+        }
+        std::copy(history.begin() + start, history.begin() + start + scopeSize, scope.begin());
+    }
+
+    // --- audio thread -> message thread
+    juce::AbstractFifo fifo;
+    std::vector<float> fifoBuffer;
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // --- message thread only
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::vector<float> history;
+    std::vector<float> fftData;
+    std::vector<float> levels;
+    std::vector<float> scope;
+
+    uint64_t frameNumber = 0;
+    double lastFrameTime = 0.0;
+    double frameIntervalMs = minFrameIntervalMs;
+    double budgetWindowStart = 0.0;
+    double workMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE (SpectrumAnalyser)
+};
+
+/**
+\class AnalyserView
+\brief
+Editor component drawing a SpectrumAnalyser: log-frequency spectrum with the scope trace
+overlaid, rendered into a cached image on new frames only.
+*/
+class AnalyserView : public juce::Component, private juce::Timer
+{
+public:
+    explicit AnalyserView(SpectrumAnalyser& _analyser) : analyser(_analyser)
+    {
+        setOpaque(true);
+        startTimer((int)analyser.getFrameIntervalMs());
+    }
+
+    ~AnalyserView() override { stopTimer(); }
+
+    void paint(juce::Graphics& g) override
+    {
+        if (image.isValid())
+            g.drawImageAt(image, 0, 0);
+        else
+            g.fillAll(juce::Colours::black);
+    }
+
+    void resized() override
+    {
+        image = getWidth() > 0 && getHeight() > 0 ? juce::Image(juce::Image::RGB, getWidth(), getHeight(), true) : juce::Image();
+        renderImage();
+        repaint();
+    }
+
+private:
+    void timerCallback() override
+    {
+        // --- follow the shared frame rate when the budget has changed it
+        if ((int)analyser.getFrameIntervalMs() != getTimerInterval())
+            startTimer((int)analyser.getFrameIntervalMs());
+
+        const uint64_t frame = analyser.update();
+        if (frame == lastFrame || !isShowing())
+            return;
+
+        lastFrame = frame;
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        renderImage();
+        repaint();
+        analyser.addWork(juce::Time::getMillisecondCounterHiRes() - start);
+    }
+
+    void renderImage()
+    {
+        if (!image.isValid())
+            return;
+
+        juce::Graphics g(image);
+        const float width = (float)image.getWidth();
+        const float height = (float)image.getHeight();
+        g.fillAll(juce::Colours::black);
+
+        // --- octave grid from 31.25 Hz
+        const double nyquist = 0.5 * analyser.getSampleRate();
+        const double lowest = 20.0;
+        const double decades = std::log10(nyquist / lowest);
+        g.setColour(juce::Colours::white.withAlpha(0.1f));
+        for (double frequency = 31.25; frequency < nyquist; frequency *= 2.0)
+        {
+            float x = width * (float)(std::log10(frequency / lowest) / decades);
+            g.drawVerticalLine((int)x, 0.0f, height);
+        }
+
+        // --- spectrum
+        const std::vector<float>& levels = analyser.getLevels();
+        juce::Path spectrum;
+        spectrum.startNewSubPath(0.0f, height);
+        for (int x = 0; x < image.getWidth(); x++)
+        {
+            double frequency = lowest * std::pow(10.0, decades * x / width);
+            int bin = juce::jlimit(0, SpectrumAnalyser::numBins - 1, (int)(frequency / nyquist * SpectrumAnalyser::numBins));
+            float level = levels[(size_t)bin];
+            spectrum.lineTo((float)x, juce::jmap(level, SpectrumAnalyser::minimumDecibels, 0.0f, height, 0.0f));
+        }
+        spectrum.lineTo(width, height);
+        spectrum.closeSubPath();
+
+        g.setColour(juce::Colours::skyblue.withAlpha(0.6f));
+        g.fillPath(spectrum);
+
+        // --- scope
+        const std::vector<float>& scope = analyser.getScope();
+        juce::Path trace;
+        for (int i = 0; i < SpectrumAnalyser::scopeSize; i++)
+        {
+            float x = width * (float)i / (float)(SpectrumAnalyser::scopeSize - 1);
+            float y = juce::jmap(juce::jlimit(-1.0f, 1.0f, scope[(size_t)i]), -1.0f, 1.0f, height, 0.0f);
+            if (i == 0)
+                trace.startNewSubPath(x, y);
+            else
+                trace.lineTo(x, y);
+        }
+
+        g.setColour(juce::Colours::orange);
+        g.strokePath(trace, juce::PathStrokeType(1.0f));
+    }
+
+    SpectrumAnalyser& analyser;
+    juce::Image image;
+    uint64_t lastFrame = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalyserView)
+};
@@ -0,0 +1,413 @@
+/*
+  ==============================================================================
+
+    WdfAnalysis.h
+    Created: 18 Oct 2026 3:12:40pm
+    Author:  Richie Haynes
+
+    Time-constant analysis of a chain of connected WDF circuits. Around its
+    rest state a linear WDF tree is a state-space system
+
+        x[n+1] = A x[n] + B u[n]        y[n] = C x[n] + D u[n]
+
+    where x are the circuits' state registers. The matrices are read off the
+    tree itself by driving one register (or the input) at a time, so every
+    component value and port resistance is accounted for without a separate
+    netlist. Only the modes that the input can excite and the output can see
+    affect the tail, so A is first restricted to the controllable then the
+    observable subspace (Krylov bases). The dominant pole modulus of what is
+    left gives the slowest time constant and the -120 dB decay time.
+
+    The same reduced (minimal) realisation is available through realise( ),
+    for evaluating the transfer function (WdfFrequencyResponse).
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "FilterObjects.h"
+
+/**
+\struct WdfTailAnalysis
+\brief
+Result of WdfAnalysis::analyse( ).
+*/
+struct WdfTailAnalysis
+{
+    int numStateRegisters = 0;          ///< registers across the whole chain
+    int numModes = 0;                   ///< order after removing uncontrollable/unobservable states
+    double spectralRadius = 0.0;        ///< largest pole modulus of the remaining modes
+    double timeConstantSeconds = 0.0;   ///< slowest time constant (infinite if not decaying)
+    double tailSeconds = 0.0;           ///< time for the slowest mode to fall by 120 dB
+    double outputGain = 0.0;            ///< ||C||: bound on |y| per unit of register norm
+
+    /** true if every remaining mode decays */
+    bool isStable() const { return spectralRadius < 1.0; }
+};
+
+/**
+\struct WdfStateSpace
+\brief
+Minimal state-space realisation of a linear WDF chain, from WdfAnalysis::realise( ).
+*/
+struct WdfStateSpace
+{
+    int order = 0;              ///< number of states after reduction
+    std::vector<double> A;      ///< order x order, row major
+    std::vector<double> B;      ///< order
+    std::vector<double> C;      ///< order
+    double D = 0.0;             ///< direct feedthrough
+};
+
+/**
+\class WdfAnalysis
+\brief
+Derives the dominant time constant and tail length of a WDF circuit chain.
+Call prepare( ) off the audio thread; analyse( ) then does not allocate.
+*/
+class WdfAnalysis
+{
+public:
+    /** number of time constants for an exponential decay to fall by 120 dB: ln(10^6) */
+    static constexpr double timeConstantsTo120dB = 13.815510557964274;
+
+    /** allocate workspace for chains of up to maxStateRegisters registers */
+    void prepare(int _maxStateRegisters)
+    {
+        maxStateRegisters = _maxStateRegisters;
+        const size_t n = (size_t)maxStateRegisters;
+
+        savedState.assign(n, 0.0);
+        reducedB.assign(n, 0.0);
+        reducedC.assign(n, 0.0);
+        registers.assign(n, 0.0);
+        A.assign(n * n, 0.0);
+        B.assign(n, 0.0);
+        C.assign(n, 0.0);
+        basis.assign(n * n, 0.0);
+        reduced.assign(n * n, 0.0);
+        product.assign(n * n, 0.0);
+        observation.assign(n, 0.0);
+    }
+
+    /** analyse the chain circuits[0] -> circuits[1] -> ... at sampleRate; the circuits must be built
+        and reset. Their state is restored afterwards. Returns false if the chain has more registers
+        than prepare( ) allowed for. */
+    bool analyse(IAudioSignalProcessor* const* circuits, int numCircuits, double sampleRate, WdfTailAnalysis& result)
+    {
+        result = WdfTailAnalysis();
+
+        int n = 0;
+        int m = 0;
+        if (!reduce(circuits, numCircuits, n, m))
+            return false;
+
+        result.numStateRegisters = n;
+        result.outputGain = outputGain;
+        result.numModes = m;
+        result.spectralRadius = m > 0 ? spectralRadius(reduced.data(), m) : 0.0;
+
+        if (result.spectralRadius <= 0.0)
+            return true;
+
+        if (!result.isStable())
+        {
+            result.timeConstantSeconds = std::numeric_limits<double>::infinity();
+            result.tailSeconds = std::numeric_limits<double>::infinity();
+            return true;
+        }
+
+        result.timeConstantSeconds = -1.0 / (sampleRate * std::log(result.spectralRadius));
+        result.tailSeconds = timeConstantsTo120dB * result.timeConstantSeconds;
+        return true;
+    }
+
+    /** minimal realisation of the chain for transfer-function evaluation; same requirements as
+        analyse( ). model's vectors are resized, so call off the audio thread. */
+    bool realise(IAudioSignalProcessor* const* circuits, int numCircuits, WdfStateSpace& model)
+    {
+        int n = 0;
+        int m = 0;
+        if (!reduce(circuits, numCircuits, n, m))
+            return false;
+
+        model.order = m;
+        model.A.assign(reduced.begin(), reduced.begin() + m * m);
+        model.B.assign(reducedB.begin(), reducedB.begin() + m);
+        model.C.assign(reducedC.begin(), reducedC.begin() + m);
+        model.D = D;
+        return true;
+    }
+
+    /** frames of real input to run through freshly reset circuits before a chunk boundary so the
+        state matches an uninterrupted render to within -120 dB */
+    static uint64_t getPreRollFrames(const WdfTailAnalysis& analysis, double sampleRate, uint64_t maxFrames)
+    {
+        if (!analysis.isStable())
+            return maxFrames;
+
+        return std::min<uint64_t>(maxFrames, (uint64_t)std::ceil(analysis.tailSeconds * sampleRate));
+    }
+
+private:
+    /** probe the chain (restoring its state) and reduce it to the controllable and observable
+        subspace: reduced (m x m, stride m), reducedB, reducedC and D. n is the full order. */
+    bool reduce(IAudioSignalProcessor* const* circuits, int numCircuits, int& n, int& m)
+    {
+        n = 0;
+        for (int i = 0; i < numCircuits; i++)
+            n += circuits[i]->getNumStateRegisters();
+
+        if (n > maxStateRegisters)
+            return false;
+
+        getChainState(circuits, numCircuits, savedState.data());
+        probe(circuits, numCircuits, n);
+        setChainState(circuits, numCircuits, savedState.data());
+
+        double gain = 0.0;
+        for (int i = 0; i < n; i++)
+            gain += C[i] * C[i];
+        outputGain = std::sqrt(gain);
+
+        // --- controllable part: Krylov space of (A, B)
+        int r = krylovBasis(A.data(), n, B.data(), false);
+        project(A.data(), n, r);
+
+        // --- B_r = Q^T B, C_r = C Q
+        for (int i = 0; i < r; i++)
+        {
+            double sumB = 0.0;
+            double sumC = 0.0;
+            for (int j = 0; j < n; j++)
+            {
+                sumB += basis[(size_t)j * n + i] * B[j];
+                sumC += C[j] * basis[(size_t)j * n + i];
+            }
+            reducedB[i] = sumB;
+            observation[i] = sumC;
+        }
+        for (int i = 0; i < r * r; i++)
+            A[i] = reduced[i];
+
+        // --- observable part of what is left: Krylov space of (A_r^T, C_r^T)
+        m = krylovBasis(A.data(), r, observation.data(), true);
+        project(A.data(), r, m);
+
+        for (int i = 0; i < m; i++)
+        {
+            double sumB = 0.0;
+            double sumC = 0.0;
+            for (int j = 0; j < r; j++)
+            {
+                sumB += basis[(size_t)j * r + i] * reducedB[j];
+                sumC += observation[j] * basis[(size_t)j * r + i];
+            }
+            B[i] = sumB;
+            reducedC[i] = sumC;
+        }
+        for (int i = 0; i < m; i++)
+            reducedB[i] = B[i];
+
+        return true;
+    }
+
+    static void getChainState(IAudioSignalProcessor* const* circuits, int numCircuits, double* state)
+    {
+        for (int i = 0; i < numCircuits; i++)
+        {
+            circuits[i]->getStateRegisters(state);
+            state += circuits[i]->getNumStateRegisters();
+        }
+    }
+
+    static void setChainState(IAudioSignalProcessor* const* circuits, int numCircuits, const double* state)
+    {
+        for (int i = 0; i < numCircuits; i++)
+        {
+            circuits[i]->setStateRegisters(state);
+            state += circuits[i]->getNumStateRegisters();
+        }
+    }
+
+    static double processChain(IAudioSignalProcessor* const* circuits, int numCircuits, double input)
+    {
+        for (int i = 0; i < numCircuits; i++)
+            input = circuits[i]->processAudioSample(input);
+        return input;
+    }
+
+    /** one sample per register with that register set to 1 gives a column of A and an entry of C;
+        one sample from rest with a unit input gives B and D */
+    void probe(IAudioSignalProcessor* const* circuits, int numCircuits, int n)
+    {
+        for (int j = 0; j <= n; j++)
+        {
+            std::fill(registers.begin(), registers.begin() + n, 0.0);
+            if (j < n)
+                registers[j] = 1.0;
+
+            setChainState(circuits, numCircuits, registers.data());
+            double output = processChain(circuits, numCircuits, j < n ? 0.0 : 1.0);
+            getChainState(circuits, numCircuits, registers.data());
+
+            if (j < n)
+            {
+                C[j] = output;
+                for (int i = 0; i < n; i++)
+                    A[(size_t)i * n + j] = registers[i];
+            }
+            else
+            {
+                D = output;
+                for (int i = 0; i < n; i++)
+                    B[i] = registers[i];
+            }
+        }
+    }
+
+    /** orthonormal basis (columns of basis, stride n) of span{v, M v, M^2 v, ...} with M = matrix
+        or its transpose; returns the dimension */
+    int krylovBasis(const double* matrix, int n, const double* start, bool transpose)
+    {
+        double scale = 0.0;
+        for (int i = 0; i < n; i++)
+            scale = std::max(scale, std::fabs(start[i]));
+        for (int i = 0; i < n * n; i++)
+            scale = std::max(scale, std::fabs(matrix[i]));
+
+        const double tolerance = 1.0e-10 * (scale > 0.0 ? scale : 1.0);
+        std::copy(start, start + n, registers.begin());
+
+        int dimension = 0;
+        while (dimension < n)
+        {
+            // --- modified Gram-Schmidt, twice for stability
+            for (int pass = 0; pass < 2; pass++)
+            {
+                for (int k = 0; k < dimension; k++)
+                {
+                    double dot = 0.0;
+                    for (int i = 0; i < n; i++)
+                        dot += basis[(size_t)i * n + k] * registers[i];
+                    for (int i = 0; i < n; i++)
+                        registers[i] -= dot * basis[(size_t)i * n + k];
+                }
+            }
+
+            double norm = 0.0;
+            for (int i = 0; i < n; i++)
+                norm += registers[i] * registers[i];
+            norm = std::sqrt(norm);
+
+            if (norm <= tolerance)
+                break;
+
+            for (int i = 0; i < n; i++)
+                basis[(size_t)i * n + dimension] = registers[i] / norm;
+            dimension++;
+
+            // --- next Krylov vector from the newest basis vector
+            for (int i = 0; i < n; i++)
+            {
+                double sum = 0.0;
+                for (int j = 0; j < n; j++)
+                    sum += (transpose ? matrix[(size_t)j * n + i] : matrix[(size_t)i * n + j]) * basis[(size_t)j * n + dimension - 1];
+                registers[i] = sum;
+            }
+        }
+        return dimension;
+    }
+
+    /** reduced (m x m, stride m) = Q^T matrix Q for the first m basis columns (stride n) */
+    void project(const double* matrix, int n, int m)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            for (int k = 0; k < m; k++)
+            {
+                double sum = 0.0;
+                for (int j = 0; j < n; j++)
+                    sum += matrix[(size_t)i * n + j] * basis[(size_t)j * n + k];
+                product[(size_t)i * m + k] = sum;
+            }
+        }
+
+        for (int l = 0; l < m; l++)
+        {
+            for (int k = 0; k < m; k++)
+            {
+                double sum = 0.0;
+                for (int i = 0; i < n; i++)
+                    sum += basis[(size_t)i * n + l] * product[(size_t)i * m + k];
+                reduced[(size_t)l * m + k] = sum;
+            }
+        }
+    }
+
+    /** spectral radius from ||M^k||^(1/k) with k = 2^40, by repeated squaring with renormalisation;
+        works for complex and repeated poles alike. Overwrites matrix. */
+    double spectralRadius(double* matrix, int m)
+    {
+        double logNorm = 0.0;
+        double power = 1.0;
+
+        for (int step = 0; step <= 40; step++)
+        {
+            double norm = 0.0;
+            for (int i = 0; i < m * m; i++)
+                norm += matrix[i] * matrix[i];
+            norm = std::sqrt(norm);
+
+            if (norm == 0.0)
+                return 0.0;     // nilpotent: finite impulse response
+
+            for (int i = 0; i < m * m; i++)
+                matrix[i] /= norm;
+            logNorm += std::log(norm);
+
+            if (step == 40)
+                break;
+
+            // --- matrix = matrix * matrix
+            for (int i = 0; i < m; i++)
+            {
+                for (int k = 0; k < m; k++)
+                {
+                    double sum = 0.0;
+                    for (int j = 0; j < m; j++)
+                        sum += matrix[(size_t)i * m + j] * matrix[(size_t)j * m + k];
+                    product[(size_t)i * m + k] = sum;
+                }
+            }
+            std::copy(product.begin(), product.begin() + m * m, matrix);
+
+            logNorm *= 2.0;
+            power *= 2.0;
+        }
+
+        return std::exp(logNorm / power);
+    }
+
+    int maxStateRegisters = 0;
+
+    std::vector<double> savedState;
+    std::vector<double> registers;
+    std::vector<double> A;
+    std::vector<double> B;
+    std::vector<double> C;
+    std::vector<double> basis;
+    std::vector<double> reduced;
+    std::vector<double> product;
+    std::vector<double> observation;
+    std::vector<double> reducedB;
+    std::vector<double> reducedC;
+    double D = 0.0;
+    double outputGain = 0.0;
+};
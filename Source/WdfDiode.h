@@ -0,0 +1,418 @@
+/*
+  ==============================================================================
+
+    WdfDiode.h
+    Created: 18 Oct 2026 10:14:31pm
+    Author:  Richie Haynes
+
+    Wave-domain diode as the root of an adaptor tree. A diode to ground,
+    I = Is (e^(V / nD Vt) - 1), seen through a port of resistance R has the
+    explicit reflected wave
+
+        b = a + 2 R Is - 2 nD Vt w(x),  x = (a + R Is) / (nD Vt) + ln(R Is / (nD Vt))
+
+    where w is the Wright omega function (w + ln w = x). R enters only as a
+    shift of x, so one table of w over x serves every port resistance and
+    every diode parameter set exactly: the "2D" table b(a, R) reduces to a
+    1D table with an affine map per port that is recomputed in initialize( ).
+
+    WdfDiodeTable holds w and w' at evenly spaced nodes and interpolates with
+    cubic Hermite polynomials. It is built once per process, on first use,
+    and is read-only afterwards, so any number of diodes on any thread share
+    it. Its measured interpolation error is available for error budgets.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+#include "FilterObjects.h"
+
+/**
+\class WdfWrightOmega
+\ingroup WDF-Objects
+\brief
+Wright omega function w(x), the solution of w + ln w = x, to full double precision.
+*/
+class WdfWrightOmega
+{
+public:
+    /** w(x); two Fritsch iterations from a log1p(e^x) / x - ln x starting point */
+    static double evaluate(double x)
+    {
+        if (x < -745.0)
+            return 0.0;     // e^x underflows, and w(x) ~ e^x there
+
+        double w = x > 1.0 ? x - std::log(x) : std::log1p(std::exp(x));
+        for (int i = 0; i < 2; i++)
+        {
+            const double r = x - w - std::log(w);
+            const double q = 2.0 * (1.0 + w) * (1.0 + w + 2.0 * r / 3.0);
+            w *= 1.0 + r / (1.0 + w) * (q - r) / (q - 2.0 * r);
+        }
+        return w;
+    }
+
+    /** w'(x) given w = w(x) */
+    static double derivative(double w) { return w / (1.0 + w); }
+};
+
+/**
+\class WdfDiodeTable
+\ingroup WDF-Objects
+\brief
+Process-wide cubic Hermite table of the Wright omega function for the diode roots.
+
+Below minimumX, w(x) < 4.3e-18 and the table returns 0; above maximumX a single Fritsch step
+from x - ln x is already accurate to rounding. The error of both is measured when the table is built.
+*/
+class WdfDiodeTable
+{
+public:
+    static constexpr double minimumX = -40.0;
+    static constexpr double maximumX = 60.0;
+    static constexpr int nodesPerUnit = 16;
+    static constexpr int numNodes = (int)((maximumX - minimumX) * nodesPerUnit) + 1;
+    static constexpr size_t memoryBudget = 32 * 1024;      ///< bytes
+
+    /** the shared table; the first call builds it, so make that call off the audio thread */
+    static const WdfDiodeTable& get()
+    {
+        static const WdfDiodeTable table;
+        return table;
+    }
+
+    /** interpolated w(x) */
+    double evaluate(double x) const
+    {
+        if (x < minimumX)
+            return 0.0;
+        if (x >= maximumX)
+            return asymptotic(x);
+
+        const double position = (x - minimumX) * nodesPerUnit;
+        const int index = (int)position;
+        const double t = position - (double)index;
+        const Node& n0 = nodes[index];
+        const Node& n1 = nodes[index + 1];
+
+        // --- cubic Hermite on [0, 1] with the slopes scaled to the node spacing
+        const double delta = n1.value - n0.value;
+        const double c2 = 3.0 * delta - 2.0 * n0.slope - n1.slope;
+        const double c3 = n0.slope + n1.slope - 2.0 * delta;
+        return n0.value + t * (n0.slope + t * (c2 + t * c3));
+    }
+
+    /** largest |table - exact| of w found over the table's range when it was built */
+    double getMaxError() const { return maxError; }
+
+    /** bytes of node data */
+    static constexpr size_t getMemorySize() { return sizeof(Node) * (size_t)numNodes; }
+
+private:
+    /** w(x) for x >= maximumX */
+    static double asymptotic(double x)
+    {
+        const double w = x - std::log(x);
+        const double r = x - w - std::log(w);
+        const double q = 2.0 * (1.0 + w) * (1.0 + w + 2.0 * r / 3.0);
+        return w * (1.0 + r / (1.0 + w) * (q - r) / (q - 2.0 * r));
+    }
+
+    struct Node
+    {
+        double value;   ///< w at the node
+        double slope;   ///< w' at the node times the node spacing
+    };
+
+    static_assert(sizeof(Node) * (size_t)numNodes <= memoryBudget, "diode table exceeds its memory budget");
+
+    WdfDiodeTable()
+    {
+        const double spacing = 1.0 / nodesPerUnit;
+        for (int i = 0; i < numNodes; i++)
+        {
+            const double w = WdfWrightOmega::evaluate(minimumX + i * spacing);
+            nodes[i].value = w;
+            nodes[i].slope = WdfWrightOmega::derivative(w) * spacing;
+        }
+
+        // --- the Hermite error peaks inside each interval; probe at quarter points
+        for (int i = 0; i + 1 < numNodes; i++)
+        {
+            for (int k = 1; k < 4; k++)
+            {
+                const double x = minimumX + (i + 0.25 * k) * spacing;
+                maxError = std::fmax(maxError, std::fabs(evaluate(x) - WdfWrightOmega::evaluate(x)));
+            }
+        }
+
+        for (double x = maximumX; x < 1.0e6; x *= 1.01)
+            maxError = std::fmax(maxError, std::fabs(asymptotic(x) - WdfWrightOmega::evaluate(x)));
+    }
+
+    Node nodes[numNodes];
+    double maxError = 0.0;
+};
+
+/**
+\struct WdfDiodeParameters
+\ingroup WDF-Objects
+\brief
+Shockley diode parameters; the defaults are the GZ34 set of WdfGZ34Diode.
+*/
+struct WdfDiodeParameters
+{
+    double Is = 4.35e-9;    ///< reverse saturation current
+    double Vt = 0.7;        ///< thermal voltage
+    double nD = 1.906;      ///< ideality factor
+
+    /** a small-signal silicon diode (1N4148) */
+    static WdfDiodeParameters silicon()
+    {
+        WdfDiodeParameters parameters;
+        parameters.Is = 2.52e-9;
+        parameters.Vt = 25.85e-3;
+        parameters.nD = 1.752;
+        return parameters;
+    }
+};
+
+/**
+\class WdfDiodeRoot
+\ingroup WDF-Objects
+\brief
+Diode to ground terminating an adaptor tree. Connect it downstream of the last reflection-free
+adaptor with WdfAdaptorBase::connectAdaptors( ); initialize( ) receives that adaptor's port 2
+resistance. Each sample the incident wave arrives through setInput1( ), the reflected wave is
+sent back upstream through setInput2( ) and getOutput2( ) returns the diode voltage.
+
+The wave is solved exactly with WdfWrightOmega, or with WdfDiodeTable after setUseTable(true).
+*/
+class WdfDiodeRoot : public WdfAdaptorBase
+{
+public:
+    WdfDiodeRoot() {}
+    explicit WdfDiodeRoot(const WdfDiodeParameters& _parameters) : parameters(_parameters) {}
+    virtual ~WdfDiodeRoot() {}
+
+    /** change the diode; takes effect at the next initialize( ) */
+    void setParameters(const WdfDiodeParameters& _parameters) { parameters = _parameters; }
+
+    /** interpolate w from the shared table instead of solving it; builds the table on first use */
+    void setUseTable(bool _useTable)
+    {
+        table = _useTable ? &WdfDiodeTable::get() : nullptr;
+    }
+
+    /** true if the table is in use */
+    bool isUsingTable() const { return table != nullptr; }
+
+    /** bound on |b - b exact| with the table, in volts */
+    double getTableErrorBound() const
+    {
+        return table != nullptr ? 2.0 * parameters.nD * parameters.Vt * table->getMaxError() : 0.0;
+    }
+
+    /** the root has no port 2; R2 is the port resistance it was initialized with */
+    virtual double getR2() { return R1; }
+
+    /** port resistance of the upstream adaptor */
+    virtual void initialize(double _R1)
+    {
+        R1 = _R1;
+        R2 = R1;
+
+        const double nVt = parameters.nD * parameters.Vt;
+        const double RIs = R1 * parameters.Is;
+        twoNVt = 2.0 * nVt;
+        twoRIs = 2.0 * RIs;
+        inverseNVt = 1.0 / nVt;
+        omegaOffset = RIs / nVt + std::log(RIs / nVt);
+    }
+
+    /** incident wave from the tree; reflects it back upstream */
+    virtual void setInput1(double _in1)
+    {
+        in1 = _in1;
+
+        out1 = in1 + twoRIs - twoNVt * omega(in1 * inverseNVt + omegaOffset);
+        out2 = 0.5 * (in1 + out1);
+
+        if (getPort1_CompAdaptor())
+            getPort1_CompAdaptor()->setInput2(out1);
+    }
+
+    /** not used: nothing is connected below the root */
+    virtual void setInput2(double _in2) {}
+
+    /** not used: the root has no component */
+    virtual void setInput3(double _in3) {}
+
+    /** reflected wave */
+    virtual double getOutput1() { return out1; }
+
+    /** diode voltage */
+    virtual double getOutput2() { return out2; }
+
+    /** not used */
+    virtual double getOutput3() { return out3; }
+
+protected:
+    /** scattering coefficients: the wave map constants */
+    virtual int getNumScatteringCoefficients() { return 4; }
+
+    /** copy the scattering coefficients out */
+    virtual void getScatteringCoefficients(double* coefficients)
+    {
+        coefficients[0] = twoNVt; coefficients[1] = twoRIs; coefficients[2] = inverseNVt; coefficients[3] = omegaOffset;
+    }
+
+    /** install the scattering coefficients */
+    virtual void setScatteringCoefficients(const double* coefficients)
+    {
+        twoNVt = coefficients[0]; twoRIs = coefficients[1]; inverseNVt = coefficients[2]; omegaOffset = coefficients[3];
+    }
+
+    /** w(x) from the table or the solver */
+    double omega(double x) const { return table != nullptr ? table->evaluate(x) : WdfWrightOmega::evaluate(x); }
+
+    WdfDiodeParameters parameters;
+    const WdfDiodeTable* table = nullptr;
+
+    double twoNVt = 0.0;        ///< 2 nD Vt
+    double twoRIs = 0.0;        ///< 2 R Is
+    double inverseNVt = 0.0;    ///< 1 / (nD Vt)
+    double omegaOffset = 0.0;   ///< R Is / (nD Vt) + ln(R Is / (nD Vt))
+};
+
+/**
+\class WdfDiodePairRoot
+\ingroup WDF-Objects
+\brief
+Antiparallel pair of identical diodes to ground (a symmetric clipper) terminating an adaptor tree;
+connected and driven like WdfDiodeRoot. The reflected wave is the explicit approximation
+
+    b = a + 2 s (R Is - nD Vt w((|a| + R Is) / (nD Vt) + ln(R Is / (nD Vt)))),  s = sign(a)
+
+which solves the forward-biased diode exactly and neglects the reverse-biased one's current
+(at most Is, so |b - b exact| <= 2 R Is). It is continuous and odd, b(0) = 0, and needs no iteration.
+*/
+class WdfDiodePairRoot : public WdfDiodeRoot
+{
+public:
+    WdfDiodePairRoot() { parameters = WdfDiodeParameters::silicon(); }
+    explicit WdfDiodePairRoot(const WdfDiodeParameters& _parameters) : WdfDiodeRoot(_parameters) {}
+    virtual ~WdfDiodePairRoot() {}
+
+    /** incident wave from the tree; reflects it back upstream */
+    virtual void setInput1(double _in1)
+    {
+        in1 = _in1;
+        out1 = reflect(in1);
+        out2 = 0.5 * (in1 + out1);
+
+        if (getPort1_CompAdaptor())
+            getPort1_CompAdaptor()->setInput2(out1);
+    }
+
+private:
+    double reflect(double a) const
+    {
+        const double sign = std::copysign(1.0, a);
+        return a + sign * (twoRIs - twoNVt * omega(std::fabs(a) * inverseNVt + omegaOffset));
+    }
+};
+
+/**
+\class WDFDiodeClipperCircuit
+\ingroup WDF-Objects
+\brief
+Diode clipping stage: input resistor into a capacitor and an antiparallel silicon diode pair to
+ground, with a drive gain in front. Solved explicitly at the diode root, so it costs a fixed
+amount per sample and can sit between WDFPreGainDistortionCircuit and WDFPostGainDistortionCircuit.
+Output is the voltage across the diodes.
+*/
+class WDFDiodeClipperCircuit : public IAudioSignalProcessor
+{
+public:
+    WDFDiodeClipperCircuit(void) { createWDF(); }    /* C-TOR */
+    ~WDFDiodeClipperCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        // --- rest WDF components (flush state registers)
+        seriesAdaptor_R.reset(_sampleRate);
+        parallelAdaptor_C.reset(_sampleRate);
+
+        // --- intialize the chain of adapters
+        seriesAdaptor_R.initializeAdaptorChain();
+        return true;
+    }
+
+    virtual bool canProcessAudioFrame() { return false; }
+
+    virtual double processAudioSample(double xn)
+    {
+        seriesAdaptor_R.setInput1(drive * xn);
+
+        // --- output is the voltage across the diodes; the series adaptor's port 2 is inverted
+        return -diodes.getOutput2();
+    }
+
+    /** input gain in dB */
+    void setDrive(double decibels) { drive = std::pow(10.0, decibels / 20.0); }
+
+    /** interpolate the diodes' wave solution from WdfDiodeTable */
+    void setUseTable(bool useTable) { diodes.setUseTable(useTable); }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** precomputed coefficients of every adaptor and component in the tree */
+    virtual int getNumCoefficients() { return WdfAdaptorBase::getNumCoefficients(adaptors, numAdaptors); }
+
+    /** capture the tree's coefficients after reset( )/initializeAdaptorChain( ) */
+    virtual void getCoefficients(double* coefficients) { WdfAdaptorBase::getCoefficients(adaptors, numAdaptors, coefficients); }
+
+    /** install coefficients captured from an identically built circuit; no chain initialisation */
+    virtual void setCoefficients(const double* coefficients) { WdfAdaptorBase::setCoefficients(adaptors, numAdaptors, coefficients); }
+
+    void createWDF()
+    {
+        // --- actual component values fc = 7.2kHz
+        double R_value = 2200.0;
+        double C_value = 10e-9;
+
+        // --- set adapter components
+        seriesAdaptor_R.setComponent(wdfComponent::R, R_value);
+        parallelAdaptor_C.setComponent(wdfComponent::C, C_value);
+
+        // --- connect adapters; the diode pair terminates the tree
+        WdfAdaptorBase::connectAdaptors(&seriesAdaptor_R, &parallelAdaptor_C);
+        WdfAdaptorBase::connectAdaptors(&parallelAdaptor_C, &diodes);
+
+        seriesAdaptor_R.setSourceResistance(sourceResistance);
+    }
+
+protected:
+    double sourceResistance = 100.0;
+    double drive = 1.0;
+
+    WdfSeriesAdaptor seriesAdaptor_R;
+    WdfParallelAdaptor parallelAdaptor_C;
+    WdfDiodePairRoot diodes;
+
+    static const int numAdaptors = 3;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_R, &parallelAdaptor_C, &diodes };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_R", "parallelAdaptor_C", "diodes" };   ///< for profiling reports
+};
@@ -0,0 +1,302 @@
+/*
+  ==============================================================================
+
+    WdfFrequencyResponse.h
+    Created: 18 Oct 2026 6:52:31pm
+    Author:  Richie Haynes
+
+    Transfer function of a linear WDF chain evaluated directly from its
+    state-space realisation (WdfAnalysis::realise( )):
+
+        H(z) = D + C (zI - A)^-1 B,     z = exp(j 2 pi f / fs)
+
+    No test signal is run. setModel( ) reduces A to upper Hessenberg form
+    once per parameter change (Householder reflections, applied to B and C as
+    well), after which each frequency costs one O(order^2) Hessenberg solve.
+    The solve is laid out with the frequency points as the innermost loop
+    over fixed-width lanes, pivoting with selects instead of branches, so
+    the compiler vectorises it across points.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "WdfAnalysis.h"
+
+/**
+\class WdfFrequencyResponse
+\brief
+Magnitude and phase of a WdfStateSpace model at a vector of frequencies.
+*/
+class WdfFrequencyResponse
+{
+public:
+    static const int numLanes = 8;  ///< frequency points solved together
+
+    /** take a realisation; allocates, so call off the audio thread */
+    void setModel(const WdfStateSpace& model)
+    {
+        order = model.order;
+        D = model.D;
+        H = model.A;
+        B = model.B;
+        C = model.C;
+        toHessenberg();
+
+        const size_t m = (size_t)order;
+        workReal.assign(m * m * numLanes, 0.0);
+        workImag.assign(m * m * numLanes, 0.0);
+        rhsReal.assign(m * numLanes, 0.0);
+        rhsImag.assign(m * numLanes, 0.0);
+    }
+
+    /** order of the current model */
+    int getOrder() const { return order; }
+
+    /** evaluate H at numPoints frequencies (Hz); writes the magnitude in dB and the phase in
+        radians (either output may be nullptr) */
+    void evaluate(const double* frequencies, int numPoints, double sampleRate, double* magnitudeDb, double* phase)
+    {
+        for (int first = 0; first < numPoints; first += numLanes)
+        {
+            double real[numLanes];
+            double imag[numLanes];
+            double zReal[numLanes];
+            double zImag[numLanes];
+
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                // --- spare lanes of the last chunk repeat its last point
+                double frequency = frequencies[std::min(first + lane, numPoints - 1)];
+                double omega = 2.0 * kPi * frequency / sampleRate;
+                zReal[lane] = std::cos(omega);
+                zImag[lane] = std::sin(omega);
+            }
+
+            solve(zReal, zImag, real, imag);
+
+            const int count = std::min(numLanes, numPoints - first);
+            for (int lane = 0; lane < count; lane++)
+            {
+                double power = real[lane] * real[lane] + imag[lane] * imag[lane];
+                if (magnitudeDb != nullptr)
+                    magnitudeDb[first + lane] = 10.0 * std::log10(std::max(power, 1.0e-20));
+                if (phase != nullptr)
+                    phase[first + lane] = std::atan2(imag[lane], real[lane]);
+            }
+        }
+    }
+
+private:
+    /** H(z) for one chunk of lanes: solve (zI - H) x = B by Gaussian elimination down the single
+        subdiagonal, swapping adjacent rows where that gives the larger pivot, then D + C x. The
+        subdiagonal stays upper Hessenberg through the swaps, so each step touches two rows. */
+    void solve(const double* zReal, const double* zImag, double* outReal, double* outImag)
+    {
+        const int m = order;
+        double* aR = workReal.data();
+        double* aI = workImag.data();
+        double* bR = rhsReal.data();
+        double* bI = rhsImag.data();
+
+        auto at = [m](int row, int column) { return ((size_t)row * m + column) * numLanes; };
+
+        for (int row = 0; row < m; row++)
+        {
+            for (int column = 0; column < m; column++)
+            {
+                const double h = H[(size_t)row * m + column];
+                double* r = aR + at(row, column);
+                double* i = aI + at(row, column);
+                for (int lane = 0; lane < numLanes; lane++)
+                {
+                    r[lane] = (row == column ? zReal[lane] : 0.0) - h;
+                    i[lane] = row == column ? zImag[lane] : 0.0;
+                }
+            }
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                bR[(size_t)row * numLanes + lane] = B[row];
+                bI[(size_t)row * numLanes + lane] = 0.0;
+            }
+        }
+
+        // --- forward elimination: only row k + 1 has an entry below the diagonal of column k
+        for (int k = 0; k + 1 < m; k++)
+        {
+            double* dR = aR + at(k, k);
+            double* dI = aI + at(k, k);
+            double* sR = aR + at(k + 1, k);
+            double* sI = aI + at(k + 1, k);
+            bool swap[numLanes];
+            double factorR[numLanes];
+            double factorI[numLanes];
+
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                swap[lane] = sR[lane] * sR[lane] + sI[lane] * sI[lane] > dR[lane] * dR[lane] + dI[lane] * dI[lane];
+                const double pivotR = swap[lane] ? sR[lane] : dR[lane];
+                const double pivotI = swap[lane] ? sI[lane] : dI[lane];
+                const double belowR = swap[lane] ? dR[lane] : sR[lane];
+                const double belowI = swap[lane] ? dI[lane] : sI[lane];
+
+                // --- factor = below / pivot
+                const double norm = pivotR * pivotR + pivotI * pivotI;
+                factorR[lane] = (belowR * pivotR + belowI * pivotI) / norm;
+                factorI[lane] = (belowI * pivotR - belowR * pivotI) / norm;
+
+                dR[lane] = pivotR;
+                dI[lane] = pivotI;
+                sR[lane] = 0.0;
+                sI[lane] = 0.0;
+            }
+
+            // --- remaining columns of rows k and k + 1, then the right-hand side (column m)
+            for (int column = k + 1; column <= m; column++)
+            {
+                double* uR = column < m ? aR + at(k, column) : bR + (size_t)k * numLanes;
+                double* uI = column < m ? aI + at(k, column) : bI + (size_t)k * numLanes;
+                double* vR = column < m ? aR + at(k + 1, column) : bR + (size_t)(k + 1) * numLanes;
+                double* vI = column < m ? aI + at(k + 1, column) : bI + (size_t)(k + 1) * numLanes;
+
+                for (int lane = 0; lane < numLanes; lane++)
+                {
+                    const double topR = swap[lane] ? vR[lane] : uR[lane];
+                    const double topI = swap[lane] ? vI[lane] : uI[lane];
+                    const double bottomR = swap[lane] ? uR[lane] : vR[lane];
+                    const double bottomI = swap[lane] ? uI[lane] : vI[lane];
+
+                    uR[lane] = topR;
+                    uI[lane] = topI;
+                    vR[lane] = bottomR - (factorR[lane] * topR - factorI[lane] * topI);
+                    vI[lane] = bottomI - (factorR[lane] * topI + factorI[lane] * topR);
+                }
+            }
+        }
+
+        // --- back substitution, then y = D + C x
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            outReal[lane] = D;
+            outImag[lane] = 0.0;
+        }
+
+        for (int row = m - 1; row >= 0; row--)
+        {
+            double* xR = bR + (size_t)row * numLanes;
+            double* xI = bI + (size_t)row * numLanes;
+            for (int column = row + 1; column < m; column++)
+            {
+                const double* uR = aR + at(row, column);
+                const double* uI = aI + at(row, column);
+                const double* yR = bR + (size_t)column * numLanes;
+                const double* yI = bI + (size_t)column * numLanes;
+                for (int lane = 0; lane < numLanes; lane++)
+                {
+                    xR[lane] -= uR[lane] * yR[lane] - uI[lane] * yI[lane];
+                    xI[lane] -= uR[lane] * yI[lane] + uI[lane] * yR[lane];
+                }
+            }
+
+            const double* dR = aR + at(row, row);
+            const double* dI = aI + at(row, row);
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                const double norm = dR[lane] * dR[lane] + dI[lane] * dI[lane];
+                const double r = (xR[lane] * dR[lane] + xI[lane] * dI[lane]) / norm;
+                const double i = (xI[lane] * dR[lane] - xR[lane] * dI[lane]) / norm;
+                xR[lane] = r;
+                xI[lane] = i;
+
+                outReal[lane] += C[row] * r;
+                outImag[lane] += C[row] * i;
+            }
+        }
+    }
+
+    /** H = Q^T A Q upper Hessenberg by Householder reflections; B = Q^T B, C = C Q */
+    void toHessenberg()
+    {
+        const int m = order;
+        std::vector<double> v((size_t)m);
+
+        for (int k = 0; k + 2 < m; k++)
+        {
+            double norm = 0.0;
+            for (int i = k + 1; i < m; i++)
+                norm += H[(size_t)i * m + k] * H[(size_t)i * m + k];
+            norm = std::sqrt(norm);
+            if (norm == 0.0)
+                continue;
+
+            // --- v = x + sign(x0) |x| e0, reflect with I - 2 v v^T / v^T v
+            const double x0 = H[(size_t)(k + 1) * m + k];
+            const double alpha = x0 >= 0.0 ? -norm : norm;
+            double vv = 0.0;
+            for (int i = k + 1; i < m; i++)
+            {
+                v[i] = H[(size_t)i * m + k] - (i == k + 1 ? alpha : 0.0);
+                vv += v[i] * v[i];
+            }
+            if (vv == 0.0)
+                continue;
+
+            // --- from the left: rows k+1..m-1 of H and B
+            for (int column = 0; column < m; column++)
+            {
+                double dot = 0.0;
+                for (int i = k + 1; i < m; i++)
+                    dot += v[i] * H[(size_t)i * m + column];
+                dot *= 2.0 / vv;
+                for (int i = k + 1; i < m; i++)
+                    H[(size_t)i * m + column] -= dot * v[i];
+            }
+
+            double dot = 0.0;
+            for (int i = k + 1; i < m; i++)
+                dot += v[i] * B[i];
+            dot *= 2.0 / vv;
+            for (int i = k + 1; i < m; i++)
+                B[i] -= dot * v[i];
+
+            // --- from the right: columns k+1..m-1 of H and C
+            for (int row = 0; row < m; row++)
+            {
+                double sum = 0.0;
+                for (int i = k + 1; i < m; i++)
+                    sum += H[(size_t)row * m + i] * v[i];
+                sum *= 2.0 / vv;
+                for (int i = k + 1; i < m; i++)
+                    H[(size_t)row * m + i] -= sum * v[i];
+            }
+
+            dot = 0.0;
+            for (int i = k + 1; i < m; i++)
+                dot += C[i] * v[i];
+            dot *= 2.0 / vv;
+            for (int i = k + 1; i < m; i++)
+                C[i] -= dot * v[i];
+
+            for (int i = k + 2; i < m; i++)
+                H[(size_t)i * m + k] = 0.0;
+        }
+    }
+
+    static constexpr double kPi = 3.14159265358979323846;
+
+    int order = 0;
+    double D = 0.0;
+    std::vector<double> H;
+    std::vector<double> B;
+    std::vector<double> C;
+
+    // --- per-chunk workspace, lane index innermost
+    std::vector<double> workReal;
+    std::vector<double> workImag;
+    std::vector<double> rhsReal;
+    std::vector<double> rhsImag;
+};
@@ -0,0 +1,740 @@
+/*
+  ==============================================================================
+
+    WdfHysteresis.h
+    Created: 19 Oct 2026 3:05:52am
+    Author:  Richie Haynes
+
+    Hysteretic inductor: a winding of N turns on a core of area A and path
+    length l, whose magnetisation M follows the Jiles-Atherton model
+
+        Man = Ms L((H + alpha M) / a),   L(x) = coth(x) - 1/x (Langevin)
+        dM/dH = ((1 - c) dM' (Man - M) / ((1 - c) delta k - alpha (Man - M))
+                 + c (Ms / a) L'(Q)) / (1 - c alpha (Ms / a) L'(Q))
+
+    with delta = sign(dH), dM' = 1 while the magnetisation moves towards the
+    anhysteretic curve and 0 otherwise. The winding current sets
+    H = N i / l and the flux linkage is lambda = N A mu0 (H + M).
+
+    WdfJilesAtherton integrates M over a step in H with a fixed-step RK2 or
+    RK4 scheme. The Langevin function is computed through std::exp, or with
+    setFastLangevin(true) through WdfLangevin::fast, a rational
+    approximation with no exp and one division. step( ) runs over a fixed
+    number of lanes for callers that keep several cores side by side;
+    Tools/WdfHysteresisBench.cpp times both Langevin functions.
+
+    WdfHysteresisWinding solves the winding. Each sample the winding
+    current is predicted with the trapezoidal rule using the inductance of
+    the previous step, M is integrated to the new H, and the inductance is
+    corrected to the secant of the step for a fixed number of passes. The
+    cost per sample is fixed. WdfHysteresisInductorRoot puts one winding at
+    the root of a tree. WdfHysteresisInductorStereoRoot terminates two trees
+    and solves both windings in one step<2>, which the bench measures
+    against two single roots.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+#include "FilterObjects.h"
+
+/**
+\class WdfLangevin
+\ingroup WDF-Objects
+\brief
+Langevin function L(x) = coth(x) - 1/x and its derivative. exact( ) goes through std::exp;
+fast( ) is a rational approximation with no exp, within 4e-8 of exact( ) in L and 7e-8 in L'.
+*/
+class WdfLangevin
+{
+public:
+    /** below this |x| exact( ) uses the odd series, which avoids the cancellation in coth(x) - 1/x */
+    static constexpr double seriesLimit = 0.3;
+
+    /** L(x) and L'(x) through std::exp */
+    static double exact(double x, double& derivative) { return evaluate(x, derivative, std::exp(-2.0 * std::fmax(std::fabs(x), seriesLimit))); }
+
+    /** L(x) and L'(x) as x P(|x|) / Q(|x|), degrees 7 and 8, so L saturates like 1 - 1/|x|. L'
+        follows from the identity L' = 1 - L^2 - 2 L / x, so there is one division and no branch. */
+    static double fast(double x, double& derivative)
+    {
+        // --- Estrin's scheme: the powers of |x| in parallel instead of one chain of depth 8
+        const double s = std::fabs(x);
+        const double s2 = s * s;
+        const double s4 = s2 * s2;
+        const double P = (numerator[0] + s * numerator[1]) + s2 * (numerator[2] + s * numerator[3])
+                       + s4 * ((numerator[4] + s * numerator[5]) + s2 * (numerator[6] + s * numerator[7]));
+        const double Q = (denominator[0] + s * denominator[1]) + s2 * (denominator[2] + s * denominator[3])
+                       + s4 * ((denominator[4] + s * denominator[5]) + s2 * (denominator[6] + s * denominator[7]) + s4 * denominator[8]);
+
+        const double ratio = P / Q;     // L(x) / x
+        derivative = 1.0 - ratio * (s2 * ratio + 2.0);
+        return x * ratio;
+    }
+
+private:
+    /** e = e^(-2 max(|x|, seriesLimit)) */
+    static double evaluate(double x, double& derivative, double e)
+    {
+        const double ax = std::fmax(std::fabs(x), seriesLimit);
+        const double sign = x < 0.0 ? -1.0 : 1.0;
+        const double oneMinusE = 1.0 - e;
+
+        // --- coth form for |x| >= seriesLimit
+        const double inverse = 1.0 / ax;
+        const double large = sign * ((1.0 + e) / oneMinusE - inverse);
+        const double largeDerivative = inverse * inverse - 4.0 * e / (oneMinusE * oneMinusE);
+
+        // --- x/3 - x^3/45 + 2x^5/945 - x^7/4725
+        const double x2 = x * x;
+        const double small = x * (1.0 / 3.0 + x2 * (-1.0 / 45.0 + x2 * (2.0 / 945.0 + x2 * (-1.0 / 4725.0))));
+        const double smallDerivative = 1.0 / 3.0 + x2 * (-1.0 / 15.0 + x2 * (2.0 / 189.0 + x2 * (-1.0 / 675.0)));
+
+        const bool useSeries = std::fabs(x) < seriesLimit;
+        derivative = useSeries ? smallDerivative : largeDerivative;
+        return useSeries ? small : large;
+    }
+
+    // --- fast( ): near-minimax fit of L(x) / x over 0 <= x <= 400, with P(0) = 1/3 exactly so L'(0) is exact
+    static constexpr double numerator[8] = { 1.0 / 3.0, 0.14608504827778254, 0.057882684531248375, 0.015658410449073991,
+                                             0.0033232727745293252, 0.00059170119040660599, 6.2719748560153527e-05, 1.2108628937888311e-05 };
+    static constexpr double denominator[9] = { 1.0, 0.43825419961652662, 0.24032479606139076, 0.07615377186315038, 0.019715954764389716,
+                                               0.0039878775263492913, 0.00066655853877417169, 7.4828183280738008e-05, 1.2108629333616368e-05 };
+};
+
+/**
+\struct WdfJilesAthertonParameters
+\ingroup WDF-Objects
+\brief
+Jiles-Atherton core parameters; the defaults are a grain-oriented transformer steel.
+*/
+struct WdfJilesAthertonParameters
+{
+    double Ms = 1.6e6;      ///< saturation magnetisation, A/m
+    double a = 1100.0;      ///< anhysteretic shape, A/m
+    double alpha = 1.6e-3;  ///< inter-domain coupling
+    double k = 400.0;       ///< pinning (loop width), A/m
+    double c = 0.2;         ///< reversibility
+
+    /** magnetic tape */
+    static WdfJilesAthertonParameters tape()
+    {
+        WdfJilesAthertonParameters parameters;
+        parameters.Ms = 3.5e5;
+        parameters.a = 2.2e4;
+        parameters.alpha = 1.6e-3;
+        parameters.k = 2.7e4;
+        parameters.c = 0.17;
+        return parameters;
+    }
+};
+
+/**
+\class WdfJilesAtherton
+\ingroup WDF-Objects
+\brief
+Fixed-step integration of the Jiles-Atherton dM/dH over a step in H, for any number of lanes.
+*/
+class WdfJilesAtherton
+{
+public:
+    enum class Solver { rk2, rk4 };
+
+    explicit WdfJilesAtherton(const WdfJilesAthertonParameters& _parameters = WdfJilesAthertonParameters()) { setParameters(_parameters); }
+
+    void setParameters(const WdfJilesAthertonParameters& _parameters)
+    {
+        parameters = _parameters;
+        MsOverA = parameters.Ms / parameters.a;
+        pinning = (1.0 - parameters.c) * parameters.k;
+    }
+
+    const WdfJilesAthertonParameters& getParameters() const { return parameters; }
+
+    void setSolver(Solver _solver) { solver = _solver; }
+
+    /** WdfLangevin::fast instead of exact; off by default */
+    void setFastLangevin(bool _fastLangevin) { fastLangevin = _fastLangevin; }
+
+    /** dM/dH at (H, M) for a field moving in direction delta (+1 or -1) */
+    double slope(double H, double M, double delta) const
+    {
+        const double Q = (H + parameters.alpha * M) / parameters.a;
+        double derivative;
+        const double L = fastLangevin ? WdfLangevin::fast(Q, derivative) : WdfLangevin::exact(Q, derivative);
+        const double difference = parameters.Ms * L - M;
+
+        // --- irreversible part only while M moves towards the anhysteretic curve; its denominator
+        //     is floored so the susceptibility stays positive
+        const double towards = delta * difference > 0.0 ? 1.0 : 0.0;
+        const double denominator = std::fmax(pinning - parameters.alpha * delta * difference, 0.01 * pinning);
+        const double irreversible = towards * (1.0 - parameters.c) * delta * difference / denominator;
+        const double reversible = parameters.c * MsOverA * derivative;
+
+        return (irreversible + reversible) / (1.0 - parameters.c * parameters.alpha * MsOverA * derivative);
+    }
+
+    /** move every lane from H0 to H1, updating M in place */
+    template <int numLanes>
+    void step(const double* H0, const double* H1, double* M) const
+    {
+        if (solver == Solver::rk4)
+        {
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                const double h = H1[lane] - H0[lane];
+                const double delta = h < 0.0 ? -1.0 : 1.0;
+                const double k1 = slope(H0[lane], M[lane], delta);
+                const double k2 = slope(H0[lane] + 0.5 * h, M[lane] + 0.5 * h * k1, delta);
+                const double k3 = slope(H0[lane] + 0.5 * h, M[lane] + 0.5 * h * k2, delta);
+                const double k4 = slope(H1[lane], M[lane] + h * k3, delta);
+                M[lane] += h * (k1 + 2.0 * (k2 + k3) + k4) / 6.0;
+            }
+        }
+        else
+        {
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                const double h = H1[lane] - H0[lane];
+                const double delta = h < 0.0 ? -1.0 : 1.0;
+                const double k1 = slope(H0[lane], M[lane], delta);
+                const double k2 = slope(H0[lane] + 0.5 * h, M[lane] + 0.5 * h * k1, delta);
+                M[lane] += h * k2;
+            }
+        }
+    }
+
+private:
+    WdfJilesAthertonParameters parameters;
+    double MsOverA = 0.0;
+    double pinning = 0.0;       ///< (1 - c) k
+    Solver solver = Solver::rk2;
+    bool fastLangevin = false;
+};
+
+/**
+\struct WdfCoreGeometry
+\ingroup WDF-Objects
+\brief
+Winding and core dimensions of a hysteretic inductor; the defaults give about 2.3 mH unsaturated.
+*/
+struct WdfCoreGeometry
+{
+    double turns = 200.0;
+    double area = 2.0e-5;       ///< m^2
+    double pathLength = 0.05;   ///< m
+};
+
+/**
+\class WdfHysteresisWinding
+\ingroup WDF-Objects
+\brief
+Winding on a Jiles-Atherton core, solved for any number of lanes at once: the integrator and
+geometry are shared, the field, magnetisation, voltage and susceptibility are per lane. Used by
+the hysteretic inductor roots.
+*/
+class WdfHysteresisWinding
+{
+public:
+    static constexpr double mu0 = 1.25663706212e-6;
+
+    WdfHysteresisWinding() { setCore(WdfJilesAthertonParameters(), WdfCoreGeometry()); }
+
+    /** core material and dimensions */
+    void setCore(const WdfJilesAthertonParameters& _parameters, const WdfCoreGeometry& _geometry)
+    {
+        core.setParameters(_parameters);
+        geometry = _geometry;
+        fieldPerAmp = geometry.turns / geometry.pathLength;
+        linkagePerField = geometry.turns * geometry.area * mu0;
+    }
+
+    WdfJilesAtherton& getCore() { return core; }
+
+    /** secant corrections of the inductance after the predictor, per sample */
+    void setCorrections(int _corrections) { corrections = std::max(0, _corrections); }
+
+    void setSampleRate(double _sampleRate) { twoFs = 2.0 * _sampleRate; }
+
+    /** susceptibility of the demagnetised core, the predictor's first guess */
+    double getInitialSusceptibility() const { return core.slope(0.0, 0.0, 1.0); }
+
+    double getFieldPerAmp() const { return fieldPerAmp; }
+
+    /** one sample for every lane: the incident wave a and port resistance R in, the state of the
+        previous sample (H, M, voltage, susceptibility) advanced in place */
+    template <int numLanes>
+    void solve(const double* a, const double* R, double* H, double* M, double* voltage, double* susceptibility)
+    {
+        // --- trapezoidal rule with inductance Ld: v = 2 fs Ld (i - i[n-1]) - v[n-1], and v = a - R i
+        double current[numLanes], linkage[numLanes], inductance[numLanes];
+        double newCurrent[numLanes], newH[numLanes], newM[numLanes];
+
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            current[lane] = H[lane] / fieldPerAmp;
+            linkage[lane] = linkagePerField * (H[lane] + M[lane]);
+            inductance[lane] = linkagePerField * fieldPerAmp * (1.0 + susceptibility[lane]);
+            newH[lane] = H[lane];
+            newM[lane] = M[lane];
+        }
+
+        for (int pass = 0; pass <= corrections; pass++)
+        {
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                const double g = twoFs * inductance[lane];
+                newCurrent[lane] = (a[lane] + voltage[lane] + g * current[lane]) / (R[lane] + g);
+                newH[lane] = newCurrent[lane] * fieldPerAmp;
+                newM[lane] = M[lane];
+            }
+
+            core.step<numLanes>(H, newH, newM);
+
+            // --- the secant inductance of this step for the next pass
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                const double change = newCurrent[lane] - current[lane];
+                if (std::fabs(change) > 1.0e-15)
+                    inductance[lane] = std::fmax((linkagePerField * (newH[lane] + newM[lane]) - linkage[lane]) / change,
+                                                 linkagePerField * fieldPerAmp);
+            }
+        }
+
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            if (std::fabs(newH[lane] - H[lane]) > 1.0e-12)
+                susceptibility[lane] = std::fmax((newM[lane] - M[lane]) / (newH[lane] - H[lane]), 0.0);
+
+            H[lane] = guardState(newH[lane]);
+            M[lane] = newM[lane];
+            voltage[lane] = guardVoltage(a[lane] - R[lane] * H[lane] / fieldPerAmp);
+        }
+    }
+
+private:
+    WdfJilesAtherton core;
+    WdfCoreGeometry geometry;
+    int corrections = 1;
+
+    double fieldPerAmp = 0.0;       ///< N / l
+    double linkagePerField = 0.0;   ///< N A mu0
+    double twoFs = 0.0;
+    WdfDenormalGuard guardState;
+    WdfDenormalGuard guardVoltage;
+};
+
+/**
+\class WdfHysteresisInductorRoot
+\ingroup WDF-Objects
+\brief
+Inductor on a hysteretic Jiles-Atherton core terminating an adaptor tree; connected and driven
+like WdfDiodeRoot. Call reset( ) with the sample rate before use, it clears the magnetisation.
+getOutput2( ) is the winding voltage.
+
+Single lane: each sample solves the winding with solve<1>, since the tree above delivers one
+incident wave at a time. WdfHysteresisInductorStereoRoot solves two trees together.
+*/
+class WdfHysteresisInductorRoot : public WdfAdaptorBase
+{
+public:
+    static constexpr double mu0 = WdfHysteresisWinding::mu0;
+
+    WdfHysteresisInductorRoot() {}
+    virtual ~WdfHysteresisInductorRoot() {}
+
+    /** core material and dimensions; call reset( ) afterwards */
+    void setCore(const WdfJilesAthertonParameters& _parameters, const WdfCoreGeometry& _geometry) { winding.setCore(_parameters, _geometry); }
+
+    /** the integrator, for the solver and Langevin settings */
+    WdfJilesAtherton& getCore() { return winding.getCore(); }
+
+    /** secant corrections of the inductance after the predictor, per sample */
+    void setCorrections(int _corrections) { winding.setCorrections(_corrections); }
+
+    /** demagnetised core, no current */
+    virtual void reset(double _sampleRate)
+    {
+        winding.setSampleRate(_sampleRate);
+        H = M = voltage = 0.0;
+        susceptibility = winding.getInitialSusceptibility();
+    }
+
+    /** the root has no port 2; R2 is the port resistance */
+    virtual double getR2() { return R1; }
+
+    /** port resistance of the upstream adaptor */
+    virtual void initialize(double _R1)
+    {
+        R1 = _R1;
+        R2 = R1;
+    }
+
+    /** incident wave from the tree; reflects it back upstream */
+    virtual void setInput1(double _in1)
+    {
+        in1 = _in1;
+        winding.solve<1>(&in1, &R1, &H, &M, &voltage, &susceptibility);
+
+        out1 = 2.0 * voltage - in1;
+        out2 = voltage;
+
+        if (getPort1_CompAdaptor())
+            getPort1_CompAdaptor()->setInput2(out1);
+    }
+
+    /** not used: nothing is connected below the root */
+    virtual void setInput2(double _in2) {}
+
+    /** not used: the root has no component */
+    virtual void setInput3(double _in3) {}
+
+    /** reflected wave */
+    virtual double getOutput1() { return out1; }
+
+    /** winding voltage */
+    virtual double getOutput2() { return out2; }
+
+    /** not used */
+    virtual double getOutput3() { return out3; }
+
+    /** winding current, magnetisation and flux density */
+    double getCurrent() const { return H / winding.getFieldPerAmp(); }
+    double getMagnetization() const { return M; }
+    double getFluxDensity() const { return mu0 * (H + M); }
+
+    /** field, magnetisation, winding voltage and the predictor's susceptibility */
+    virtual int getNumStateRegisters() { return 4; }
+
+    /** copy state registers into registers[0 .. getNumStateRegisters( )) */
+    virtual void getStateRegisters(double* registers) { registers[0] = H; registers[1] = M; registers[2] = voltage; registers[3] = susceptibility; }
+
+    /** restore state registers captured with getStateRegisters( ) */
+    virtual void setStateRegisters(const double* registers) { H = registers[0]; M = registers[1]; voltage = registers[2]; susceptibility = registers[3]; }
+
+protected:
+    WdfHysteresisWinding winding;
+
+    double H = 0.0;                 ///< field of the last sample
+    double M = 0.0;                 ///< magnetisation of the last sample
+    double voltage = 0.0;           ///< winding voltage of the last sample
+    double susceptibility = 0.0;    ///< dM/dH of the last step, for the predictor
+};
+
+/**
+\class WdfHysteresisInductorStereoRoot
+\ingroup WDF-Objects
+\brief
+Two hysteretic inductors with the same core, terminating two adaptor trees and solved together
+with solve<2>. Connect each tree to getLane( ); a lane's setInput1( ) only stores the incident
+wave, and reflect( ), called once both trees have been driven, solves both windings and sends
+the reflected waves up both trees. Each lane's getOutput2( ) is its winding voltage, and each
+lane carries its own state registers. Call reset( ) on both lanes before use.
+*/
+class WdfHysteresisInductorStereoRoot
+{
+public:
+    static constexpr int numLanes = 2;
+
+    /** one channel's termination, connected like WdfHysteresisInductorRoot */
+    class Lane : public WdfAdaptorBase
+    {
+    public:
+        /** demagnetised core, no current; sets the sample rate for both lanes */
+        virtual void reset(double _sampleRate)
+        {
+            owner->winding.setSampleRate(_sampleRate);
+            owner->H[index] = owner->M[index] = owner->voltage[index] = 0.0;
+            owner->susceptibility[index] = owner->winding.getInitialSusceptibility();
+        }
+
+        /** the root has no port 2; R2 is the port resistance */
+        virtual double getR2() { return R1; }
+
+        /** port resistance of the upstream adaptor */
+        virtual void initialize(double _R1)
+        {
+            R1 = _R1;
+            R2 = R1;
+        }
+
+        /** incident wave from the tree, held until reflect( ) */
+        virtual void setInput1(double _in1) { in1 = _in1; }
+
+        /** not used: nothing is connected below the root */
+        virtual void setInput2(double _in2) {}
+
+        /** not used: the root has no component */
+        virtual void setInput3(double _in3) {}
+
+        /** reflected wave */
+        virtual double getOutput1() { return out1; }
+
+        /** winding voltage */
+        virtual double getOutput2() { return out2; }
+
+        /** not used */
+        virtual double getOutput3() { return out3; }
+
+        /** this lane's field, magnetisation, winding voltage and susceptibility */
+        virtual int getNumStateRegisters() { return 4; }
+
+        /** copy state registers into registers[0 .. getNumStateRegisters( )) */
+        virtual void getStateRegisters(double* registers)
+        {
+            registers[0] = owner->H[index]; registers[1] = owner->M[index];
+            registers[2] = owner->voltage[index]; registers[3] = owner->susceptibility[index];
+        }
+
+        /** restore state registers captured with getStateRegisters( ) */
+        virtual void setStateRegisters(const double* registers)
+        {
+            owner->H[index] = registers[0]; owner->M[index] = registers[1];
+            owner->voltage[index] = registers[2]; owner->susceptibility[index] = registers[3];
+        }
+
+    private:
+        friend class WdfHysteresisInductorStereoRoot;
+        WdfHysteresisInductorStereoRoot* owner = nullptr;
+        int index = 0;
+    };
+
+    WdfHysteresisInductorStereoRoot()
+    {
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            lanes[lane].owner = this;
+            lanes[lane].index = lane;
+        }
+    }
+
+    /** the lanes hold a pointer to this object */
+    WdfHysteresisInductorStereoRoot(const WdfHysteresisInductorStereoRoot&) = delete;
+    WdfHysteresisInductorStereoRoot& operator=(const WdfHysteresisInductorStereoRoot&) = delete;
+
+    /** core material and dimensions of both inductors; reset the lanes afterwards */
+    void setCore(const WdfJilesAthertonParameters& _parameters, const WdfCoreGeometry& _geometry) { winding.setCore(_parameters, _geometry); }
+
+    /** the integrator, for the solver and Langevin settings */
+    WdfJilesAtherton& getCore() { return winding.getCore(); }
+
+    /** secant corrections of the inductance after the predictor, per sample */
+    void setCorrections(int _corrections) { winding.setCorrections(_corrections); }
+
+    Lane& getLane(int lane) { return lanes[lane]; }
+
+    /** solve both windings for the waves stored by the lanes and reflect them back upstream */
+    void reflect()
+    {
+        double a[numLanes], R[numLanes];
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            a[lane] = lanes[lane].in1;
+            R[lane] = lanes[lane].R1;
+        }
+
+        winding.solve<numLanes>(a, R, H, M, voltage, susceptibility);
+
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            Lane& root = lanes[lane];
+            root.out1 = 2.0 * voltage[lane] - root.in1;
+            root.out2 = voltage[lane];
+
+            if (root.getPort1_CompAdaptor())
+                root.getPort1_CompAdaptor()->setInput2(root.out1);
+        }
+    }
+
+private:
+    WdfHysteresisWinding winding;
+    Lane lanes[numLanes];
+
+    double H[numLanes] = {};                ///< field of the last sample
+    double M[numLanes] = {};                ///< magnetisation of the last sample
+    double voltage[numLanes] = {};          ///< winding voltage of the last sample
+    double susceptibility[numLanes] = {};   ///< dM/dH of the last step, for the predictor
+};
+
+/**
+\class WDFHysteresisInductorCircuit
+\ingroup WDF-Objects
+\brief
+Saturating, hysteretic inductor driven from a voltage source through a series resistor, with a
+drive gain in front. Output is the voltage across the inductor.
+*/
+class WDFHysteresisInductorCircuit : public IAudioSignalProcessor
+{
+public:
+    WDFHysteresisInductorCircuit(void) { createWDF(); }    /* C-TOR */
+    ~WDFHysteresisInductorCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        // --- rest WDF components (flush state registers)
+        seriesAdaptor_R.reset(_sampleRate);
+        inductor.reset(_sampleRate);
+
+        // --- intialize the chain of adapters
+        seriesAdaptor_R.initializeAdaptorChain();
+        return true;
+    }
+
+    virtual bool canProcessAudioFrame() { return false; }
+
+    virtual double processAudioSample(double xn)
+    {
+        seriesAdaptor_R.setInput1(drive * xn);
+
+        // --- output is the voltage across the inductor; the series adaptor's port 2 is inverted
+        return -inductor.getOutput2();
+    }
+
+    /** input gain in dB */
+    void setDrive(double decibels) { drive = std::pow(10.0, decibels / 20.0); }
+
+    /** the inductor, for core and solver settings */
+    WdfHysteresisInductorRoot& getInductor() { return inductor; }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    void createWDF()
+    {
+        double R_value = 10.0;
+
+        seriesAdaptor_R.setComponent(wdfComponent::R, R_value);
+        seriesAdaptor_R.setSourceResistance(0.0);
+
+        WdfAdaptorBase::connectAdaptors(&seriesAdaptor_R, &inductor);
+    }
+
+protected:
+    double drive = 1.0;
+
+    WdfSeriesAdaptor seriesAdaptor_R;
+    WdfHysteresisInductorRoot inductor;
+
+    static const int numAdaptors = 2;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_R, &inductor };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_R", "inductor" };   ///< for profiling reports
+};
+
+/**
+\class WDFStereoHysteresisInductorCircuit
+\ingroup WDF-Objects
+\brief
+WDFHysteresisInductorCircuit for two channels, one series resistor per channel terminated by the
+two lanes of a WdfHysteresisInductorStereoRoot, so both cores are stepped in one call. Each channel
+matches a WDFHysteresisInductorCircuit bit for bit. processAudioFrame( ) runs both channels;
+processAudioSample( ) feeds xn to both and returns channel 0.
+*/
+class WDFStereoHysteresisInductorCircuit : public IAudioSignalProcessor
+{
+public:
+    static constexpr int numChannels = WdfHysteresisInductorStereoRoot::numLanes;
+
+    WDFStereoHysteresisInductorCircuit(void) { createWDF(); }    /* C-TOR */
+    ~WDFStereoHysteresisInductorCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            // --- rest WDF components (flush state registers)
+            seriesAdaptor_R[channel].reset(_sampleRate);
+            inductor.getLane(channel).reset(_sampleRate);
+
+            // --- intialize the chain of adapters
+            seriesAdaptor_R[channel].initializeAdaptorChain();
+        }
+        return true;
+    }
+
+    virtual bool canProcessAudioFrame() { return true; }
+
+    virtual double processAudioSample(double xn)
+    {
+        const double xns[numChannels] = { xn, xn };
+        double yns[numChannels];
+        process(xns, yns);
+        return yns[0];
+    }
+
+    /** one frame of up to two channels; a mono input feeds both */
+    virtual bool processAudioFrame(const float* inputFrame, float* outputFrame, uint32_t inputChannels, uint32_t outputChannels)
+    {
+        if (inputChannels == 0 || outputChannels == 0)
+            return false;
+
+        const double xns[numChannels] = { inputFrame[0], inputFrame[inputChannels > 1 ? 1 : 0] };
+        double yns[numChannels];
+        process(xns, yns);
+
+        for (uint32_t channel = 0; channel < outputChannels && channel < (uint32_t)numChannels; channel++)
+            outputFrame[channel] = (float)yns[channel];
+        return true;
+    }
+
+    /** input gain in dB */
+    void setDrive(double decibels) { drive = std::pow(10.0, decibels / 20.0); }
+
+    /** both inductors, for core and solver settings */
+    WdfHysteresisInductorStereoRoot& getInductor() { return inductor; }
+
+    /** state of every adaptor and component in both trees */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the trees' registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    void createWDF()
+    {
+        double R_value = 10.0;
+
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            seriesAdaptor_R[channel].setComponent(wdfComponent::R, R_value);
+            seriesAdaptor_R[channel].setSourceResistance(0.0);
+
+            WdfAdaptorBase::connectAdaptors(&seriesAdaptor_R[channel], &inductor.getLane(channel));
+        }
+    }
+
+protected:
+    /** drive both trees, solve both windings together, read both winding voltages */
+    void process(const double* xns, double* yns)
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+            seriesAdaptor_R[channel].setInput1(drive * xns[channel]);
+
+        inductor.reflect();
+
+        // --- output is the voltage across each inductor; the series adaptor's port 2 is inverted
+        for (int channel = 0; channel < numChannels; channel++)
+            yns[channel] = -inductor.getLane(channel).getOutput2();
+    }
+
+    double drive = 1.0;
+
+    WdfSeriesAdaptor seriesAdaptor_R[numChannels];
+    WdfHysteresisInductorStereoRoot inductor;
+
+    static const int numAdaptors = 4;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_R[0], &inductor.getLane(0), &seriesAdaptor_R[1], &inductor.getLane(1) };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_R[0]", "inductor[0]", "seriesAdaptor_R[1]", "inductor[1]" };   ///< for profiling reports
+};
@@ -0,0 +1,769 @@
+/*
+  ==============================================================================
+
+    WdfNewtonRoot.h
+    Created: 18 Oct 2026 10:58:20pm
+    Author:  Richie Haynes
+
+    Root for trees with more than one nonlinear element. The one-directional
+    setInput1( )/setInput2( ) flow can only resolve a single nonlinearity at
+    the root, so here the root is a small nodal network instead: each linear
+    subtree attaches through a WdfRootPort between two nodes (it looks like a
+    voltage source a behind its port resistance R), resistors can be stamped
+    between nodes, and nonlinear elements connect to nodes by terminal. Each
+    sample the subtrees deliver their incident waves, solve( ) finds the node
+    voltages by damped Newton-Raphson from the previous sample's solution and
+    sends b = 2 v - a back down every subtree.
+
+    The Jacobian is either rebuilt every iteration or carried across samples
+    as an inverse with Broyden rank-1 updates and rebuilt only when the solve
+    slows down. Iterations are capped and counted, so the worst-case cost is
+    fixed. Everything is sized at compile time; nothing allocates.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "WdfDiode.h"
+
+/**
+\class IWdfNonlinearElement
+\ingroup Interfaces
+\brief
+Memoryless nonlinear device with up to WdfNewtonRoot::maxTerminals terminals.
+*/
+class IWdfNonlinearElement
+{
+public:
+    virtual ~IWdfNonlinearElement() {}
+
+    /** number of terminals */
+    virtual int getNumTerminals() const = 0;
+
+    /** currents flowing into the device at each terminal for the terminal voltages; if jacobian is
+        not null also d current[i] / d voltage[j] at jacobian[i * getNumTerminals( ) + j] */
+    virtual void evaluate(const double* voltages, double* currents, double* jacobian) = 0;
+};
+
+/**
+\class WdfExponential
+\ingroup WDF-Objects
+\brief
+e^x continued linearly above a limit, so Newton steps far from the solution cannot overflow.
+*/
+struct WdfExponential
+{
+    static constexpr double limit = 40.0;
+
+    /** e^x and its slope */
+    static double evaluate(double x, double& slope)
+    {
+        if (x <= limit)
+        {
+            slope = std::exp(x);
+            return slope;
+        }
+        slope = std::exp(limit);
+        return slope * (1.0 + x - limit);
+    }
+};
+
+/**
+\class WdfShockleyDiodeElement
+\ingroup WDF-Objects
+\brief
+Diode for WdfNewtonRoot; terminal 0 is the anode, terminal 1 the cathode.
+*/
+class WdfShockleyDiodeElement : public IWdfNonlinearElement
+{
+public:
+    explicit WdfShockleyDiodeElement(const WdfDiodeParameters& _parameters = WdfDiodeParameters::silicon())
+        : parameters(_parameters) {}
+
+    virtual int getNumTerminals() const { return 2; }
+
+    virtual void evaluate(const double* voltages, double* currents, double* jacobian)
+    {
+        const double nVt = parameters.nD * parameters.Vt;
+        double slope;
+        const double current = parameters.Is * (WdfExponential::evaluate((voltages[0] - voltages[1]) / nVt, slope) - 1.0);
+
+        currents[0] = current;
+        currents[1] = -current;
+
+        if (jacobian != nullptr)
+        {
+            const double conductance = parameters.Is * slope / nVt;
+            jacobian[0] = conductance;  jacobian[1] = -conductance;
+            jacobian[2] = -conductance; jacobian[3] = conductance;
+        }
+    }
+
+private:
+    WdfDiodeParameters parameters;
+};
+
+/**
+\class WdfDiodePairElement
+\ingroup WDF-Objects
+\brief
+Antiparallel pair of identical diodes for WdfNewtonRoot, I = 2 Is sinh(V / nD Vt); exact, unlike
+the explicit WdfDiodePairRoot.
+*/
+class WdfDiodePairElement : public IWdfNonlinearElement
+{
+public:
+    explicit WdfDiodePairElement(const WdfDiodeParameters& _parameters = WdfDiodeParameters::silicon())
+        : parameters(_parameters) {}
+
+    virtual int getNumTerminals() const { return 2; }
+
+    virtual void evaluate(const double* voltages, double* currents, double* jacobian)
+    {
+        const double nVt = parameters.nD * parameters.Vt;
+        const double x = (voltages[0] - voltages[1]) / nVt;
+        double forwardSlope, reverseSlope;
+        const double current = parameters.Is * (WdfExponential::evaluate(x, forwardSlope) - WdfExponential::evaluate(-x, reverseSlope));
+
+        currents[0] = current;
+        currents[1] = -current;
+
+        if (jacobian != nullptr)
+        {
+            const double conductance = parameters.Is * (forwardSlope + reverseSlope) / nVt;
+            jacobian[0] = conductance;  jacobian[1] = -conductance;
+            jacobian[2] = -conductance; jacobian[3] = conductance;
+        }
+    }
+
+private:
+    WdfDiodeParameters parameters;
+};
+
+/**
+\class IWdfRootNetwork
+\ingroup Interfaces
+\brief
+A root that terminates several subtrees through WdfRootPorts.
+*/
+class IWdfRootNetwork
+{
+public:
+    virtual ~IWdfRootNetwork() {}
+
+    /** a subtree changed the resistance of one of the root's ports */
+    virtual void portResistanceChanged(int port) = 0;
+};
+
+class WdfNewtonRoot;
+class WdfRTypeAdaptor;
+
+/**
+\class WdfRootPort
+\ingroup WDF-Objects
+\brief
+One port of a WdfNewtonRoot or WdfRTypeAdaptor. Connect a subtree to it with
+WdfAdaptorBase::connectAdaptors( ) as if it were the next adaptor; it collects the incident wave and
+returns the reflected one once the root has solved. getOutput2( ) is the port voltage.
+*/
+class WdfRootPort : public WdfAdaptorBase
+{
+public:
+    WdfRootPort() {}
+    virtual ~WdfRootPort() {}
+
+    /** port resistance of the subtree */
+    virtual void initialize(double _R1);
+
+    /** the root has no port 2; R2 is the port resistance */
+    virtual double getR2() { return R1; }
+
+    /** incident wave; held until the root solves */
+    virtual void setInput1(double _in1) { in1 = _in1; }
+
+    /** not used */
+    virtual void setInput2(double _in2) {}
+
+    /** not used */
+    virtual void setInput3(double _in3) {}
+
+    /** reflected wave */
+    virtual double getOutput1() { return out1; }
+
+    /** port voltage */
+    virtual double getOutput2() { return out2; }
+
+    /** not used */
+    virtual double getOutput3() { return out3; }
+
+private:
+    friend class WdfNewtonRoot;
+    friend class WdfRTypeAdaptor;
+
+    /** send the reflected wave for port voltage v back down the subtree */
+    void reflect(double voltage)
+    {
+        out2 = voltage;
+        out1 = 2.0 * voltage - in1;
+
+        if (getPort1_CompAdaptor())
+            getPort1_CompAdaptor()->setInput2(out1);
+    }
+
+    /** send reflected wave b back down the subtree */
+    void reflectWave(double b)
+    {
+        out1 = b;
+        out2 = 0.5 * (in1 + b);
+
+        if (getPort1_CompAdaptor())
+            getPort1_CompAdaptor()->setInput2(out1);
+    }
+
+    IWdfRootNetwork* root = nullptr;
+    int index = 0;
+    int nodePlus = -1;
+    int nodeMinus = -1;
+};
+
+/**
+\class WdfNewtonRoot
+\ingroup WDF-Objects
+\brief
+Nodal root solving several nonlinear elements jointly with damped Newton-Raphson. Node -1 is
+ground. Build it (setNumNodes( ), addPort( ), addResistor( ), addElement( )) off the audio
+thread, before the subtrees are initialised; per sample, drive every subtree's setInput1( ) and
+then call solve( ).
+*/
+class WdfNewtonRoot : public IWdfRootNetwork
+{
+public:
+    static constexpr int maxNodes = 8;
+    static constexpr int maxPorts = 8;
+    static constexpr int maxResistors = 8;
+    static constexpr int maxElements = 8;
+    static constexpr int maxTerminals = 4;
+
+    /** how the Jacobian is obtained */
+    enum class JacobianUpdate
+    {
+        everyIteration,     ///< evaluated and inverted at every Newton iteration
+        broyden             ///< inverse kept across samples, rank-1 updated, rebuilt when convergence slows
+    };
+
+    /** solver counters since the last resetStatistics( ) */
+    struct Statistics
+    {
+        uint64_t solves = 0;
+        uint64_t iterations = 0;
+        uint64_t jacobianEvaluations = 0;
+        uint64_t failures = 0;          ///< solves that hit the iteration cap or a singular Jacobian
+        int maxIterationsUsed = 0;
+    };
+
+    WdfNewtonRoot() {}
+    WdfNewtonRoot(const WdfNewtonRoot&) = delete;
+    WdfNewtonRoot& operator=(const WdfNewtonRoot&) = delete;
+
+    /** remove every port, resistor and element */
+    void clear()
+    {
+        numNodes = numPorts = numResistors = numElements = 0;
+        conductanceValid = false;
+        inverseValid = false;
+    }
+
+    /** number of non-ground nodes */
+    void setNumNodes(int _numNodes) { numNodes = std::min(std::max(_numNodes, 0), maxNodes); }
+
+    /** a port between two nodes, positive at nodePlus, with subtree connected to it; false (and
+        nothing connected) if the root already has maxPorts ports */
+    bool addPort(WdfAdaptorBase* subtree, int nodePlus, int nodeMinus)
+    {
+        if (numPorts == maxPorts)
+            return false;
+
+        WdfRootPort& port = ports[numPorts];
+        port.root = this;
+        port.index = numPorts++;
+        port.nodePlus = nodePlus;
+        port.nodeMinus = nodeMinus;
+        WdfAdaptorBase::connectAdaptors(subtree, &port);
+        conductanceValid = false;
+        return true;
+    }
+
+    /** a fixed resistor between two nodes; false if the root already has maxResistors */
+    bool addResistor(int node1, int node2, double resistance)
+    {
+        if (numResistors == maxResistors)
+            return false;
+        resistors[numResistors++] = { node1, node2, 1.0 / resistance };
+        conductanceValid = false;
+        return true;
+    }
+
+    /** a nonlinear element; nodes[t] is the node of terminal t. The root does not own the element.
+        False if the root already has maxElements or the element has more than maxTerminals. */
+    bool addElement(IWdfNonlinearElement* element, const int* nodes)
+    {
+        if (numElements == maxElements || element->getNumTerminals() > maxTerminals)
+            return false;
+
+        Element& entry = elements[numElements++];
+        entry.element = element;
+        entry.numTerminals = element->getNumTerminals();
+        for (int t = 0; t < entry.numTerminals; t++)
+            entry.nodes[t] = nodes[t];
+        return true;
+    }
+
+    /** iteration cap per sample */
+    void setMaxIterations(int _maxIterations) { maxIterations = std::max(1, _maxIterations); }
+
+    /** converged once no node voltage moves by more than this, in volts */
+    void setTolerance(double _tolerance) { tolerance = _tolerance; }
+
+    void setJacobianUpdate(JacobianUpdate _jacobianUpdate)
+    {
+        jacobianUpdate = _jacobianUpdate;
+        inverseValid = false;
+    }
+
+    /** clear the warm start and the kept Jacobian */
+    void reset()
+    {
+        std::fill(voltages, voltages + maxNodes, 0.0);
+        inverseValid = false;
+    }
+
+    /** solve for the node voltages from the ports' incident waves and reflect into every subtree */
+    void solve()
+    {
+        if (!conductanceValid)
+            buildConductance();
+
+        // --- Thevenin sources of the subtrees
+        std::fill(sources, sources + numNodes, 0.0);
+        for (int p = 0; p < numPorts; p++)
+        {
+            const double current = ports[p].in1 / ports[p].R1;
+            addAt(sources, ports[p].nodePlus, current);
+            addAt(sources, ports[p].nodeMinus, -current);
+        }
+
+        statistics.solves++;
+        bool converged = false;
+        int iteration = 0;
+
+        // --- F(v) = G v - s + i(v), warm-started from the last sample
+        double residual[maxNodes];
+        double residualNorm = evaluateResidual(voltages, residual, nullptr);
+
+        while (iteration < maxIterations)
+        {
+            // --- a kept inverse is replaced once it stops converging fast
+            const bool rebuild = jacobianUpdate == JacobianUpdate::everyIteration || !inverseValid;
+            if (rebuild)
+            {
+                evaluateResidual(voltages, residual, jacobian);
+                statistics.jacobianEvaluations++;
+                if (!invert(jacobian, inverse))
+                {
+                    inverseValid = false;
+                    break;
+                }
+                inverseValid = true;
+            }
+
+            double step[maxNodes];
+            multiply(inverse, residual, step);
+
+            // --- damping: halve the step until the residual does not grow
+            double trial[maxNodes];
+            double trialResidual[maxNodes];
+            double trialNorm = 0.0;
+            double scale = 1.0;
+            for (int halvings = 0; ; halvings++)
+            {
+                for (int n = 0; n < numNodes; n++)
+                    trial[n] = voltages[n] - scale * step[n];
+                trialNorm = evaluateResidual(trial, trialResidual, nullptr);
+                if (trialNorm <= residualNorm || halvings == maxHalvings)
+                    break;
+                scale *= 0.5;
+            }
+
+            double largestMove = 0.0;
+            for (int n = 0; n < numNodes; n++)
+                largestMove = std::max(largestMove, std::fabs(scale * step[n]));
+
+            if (jacobianUpdate == JacobianUpdate::broyden)
+            {
+                // --- a secant step that did not at least halve the residual asks for the true Jacobian
+                if (trialNorm > 0.5 * residualNorm && !rebuild)
+                    inverseValid = false;
+                else
+                    updateInverse(trial, trialResidual, residual);
+            }
+
+            std::copy(trial, trial + numNodes, voltages);
+            std::copy(trialResidual, trialResidual + numNodes, residual);
+            residualNorm = trialNorm;
+            iteration++;
+
+            if (largestMove < tolerance)
+            {
+                converged = true;
+                break;
+            }
+        }
+
+        statistics.iterations += (uint64_t)iteration;
+        statistics.maxIterationsUsed = std::max(statistics.maxIterationsUsed, iteration);
+        if (!converged)
+            statistics.failures++;
+
+        for (int p = 0; p < numPorts; p++)
+            ports[p].reflect(voltageAt(ports[p].nodePlus) - voltageAt(ports[p].nodeMinus));
+    }
+
+    /** voltage of a node after solve( ); 0 for ground */
+    double getVoltage(int node) const { return voltageAt(node); }
+
+    /** the port conductances are restamped at the next solve( ) */
+    virtual void portResistanceChanged(int port) { conductanceValid = false; }
+
+    /** counters; read on the solving thread */
+    const Statistics& getStatistics() const { return statistics; }
+    void resetStatistics() { statistics = Statistics(); }
+
+private:
+    static const int maxHalvings = 4;
+
+    struct Resistor
+    {
+        int node1;
+        int node2;
+        double conductance;
+    };
+
+    struct Element
+    {
+        IWdfNonlinearElement* element = nullptr;
+        int numTerminals = 0;
+        int nodes[maxTerminals] = {};
+    };
+
+    double voltageAt(int node) const { return node >= 0 ? voltages[node] : 0.0; }
+
+    static void addAt(double* vector, int node, double value)
+    {
+        if (node >= 0)
+            vector[node] += value;
+    }
+
+    /** stamp conductance g between two nodes into a numNodes x numNodes matrix */
+    void stamp(double* matrix, int node1, int node2, double g) const
+    {
+        if (node1 >= 0) matrix[node1 * maxNodes + node1] += g;
+        if (node2 >= 0) matrix[node2 * maxNodes + node2] += g;
+        if (node1 >= 0 && node2 >= 0)
+        {
+            matrix[node1 * maxNodes + node2] -= g;
+            matrix[node2 * maxNodes + node1] -= g;
+        }
+    }
+
+    void buildConductance()
+    {
+        std::fill(conductance, conductance + maxNodes * maxNodes, 0.0);
+        for (int p = 0; p < numPorts; p++)
+            stamp(conductance, ports[p].nodePlus, ports[p].nodeMinus, 1.0 / ports[p].R1);
+        for (int r = 0; r < numResistors; r++)
+            stamp(conductance, resistors[r].node1, resistors[r].node2, resistors[r].conductance);
+
+        conductanceValid = true;
+        inverseValid = false;
+    }
+
+    /** F(v) into residual and, if matrix is not null, its Jacobian; returns max |F| */
+    double evaluateResidual(const double* v, double* residual, double* matrix)
+    {
+        for (int i = 0; i < numNodes; i++)
+        {
+            double sum = -sources[i];
+            for (int j = 0; j < numNodes; j++)
+                sum += conductance[i * maxNodes + j] * v[j];
+            residual[i] = sum;
+        }
+
+        if (matrix != nullptr)
+            std::copy(conductance, conductance + maxNodes * maxNodes, matrix);
+
+        for (int e = 0; e < numElements; e++)
+        {
+            Element& entry = elements[e];
+            double terminalVoltages[maxTerminals];
+            double currents[maxTerminals];
+            double elementJacobian[maxTerminals * maxTerminals];
+
+            for (int t = 0; t < entry.numTerminals; t++)
+                terminalVoltages[t] = entry.nodes[t] >= 0 ? v[entry.nodes[t]] : 0.0;
+
+            entry.element->evaluate(terminalVoltages, currents, matrix != nullptr ? elementJacobian : nullptr);
+
+            for (int t = 0; t < entry.numTerminals; t++)
+            {
+                const int row = entry.nodes[t];
+                if (row < 0)
+                    continue;
+
+                residual[row] += currents[t];
+                if (matrix == nullptr)
+                    continue;
+
+                for (int u = 0; u < entry.numTerminals; u++)
+                    if (entry.nodes[u] >= 0)
+                        matrix[row * maxNodes + entry.nodes[u]] += elementJacobian[t * entry.numTerminals + u];
+            }
+        }
+
+        double norm = 0.0;
+        for (int i = 0; i < numNodes; i++)
+            norm = std::max(norm, std::fabs(residual[i]));
+        return norm;
+    }
+
+    /** Gauss-Jordan with partial pivoting; false if singular */
+    bool invert(const double* matrix, double* result) const
+    {
+        double work[maxNodes * maxNodes];
+        std::copy(matrix, matrix + maxNodes * maxNodes, work);
+        for (int i = 0; i < numNodes; i++)
+            for (int j = 0; j < numNodes; j++)
+                result[i * maxNodes + j] = i == j ? 1.0 : 0.0;
+
+        for (int column = 0; column < numNodes; column++)
+        {
+            int pivot = column;
+            for (int row = column + 1; row < numNodes; row++)
+                if (std::fabs(work[row * maxNodes + column]) > std::fabs(work[pivot * maxNodes + column]))
+                    pivot = row;
+
+            if (work[pivot * maxNodes + column] == 0.0)
+                return false;
+
+            if (pivot != column)
+            {
+                for (int j = 0; j < numNodes; j++)
+                {
+                    std::swap(work[pivot * maxNodes + j], work[column * maxNodes + j]);
+                    std::swap(result[pivot * maxNodes + j], result[column * maxNodes + j]);
+                }
+            }
+
+            const double scale = 1.0 / work[column * maxNodes + column];
+            for (int j = 0; j < numNodes; j++)
+            {
+                work[column * maxNodes + j] *= scale;
+                result[column * maxNodes + j] *= scale;
+            }
+
+            for (int row = 0; row < numNodes; row++)
+            {
+                const double factor = work[row * maxNodes + column];
+                if (row == column || factor == 0.0)
+                    continue;
+                for (int j = 0; j < numNodes; j++)
+                {
+                    work[row * maxNodes + j] -= factor * work[column * maxNodes + j];
+                    result[row * maxNodes + j] -= factor * result[column * maxNodes + j];
+                }
+            }
+        }
+        return true;
+    }
+
+    void multiply(const double* matrix, const double* vector, double* result) const
+    {
+        for (int i = 0; i < numNodes; i++)
+        {
+            double sum = 0.0;
+            for (int j = 0; j < numNodes; j++)
+                sum += matrix[i * maxNodes + j] * vector[j];
+            result[i] = sum;
+        }
+    }
+
+    /** good Broyden update of the inverse: H += (dv - H dF) dv^T H / (dv^T H dF) */
+    void updateInverse(const double* trial, const double* trialResidual, const double* residual)
+    {
+        double dv[maxNodes], dF[maxNodes], HdF[maxNodes], vH[maxNodes];
+        for (int n = 0; n < numNodes; n++)
+        {
+            dv[n] = trial[n] - voltages[n];
+            dF[n] = trialResidual[n] - residual[n];
+        }
+
+        multiply(inverse, dF, HdF);
+
+        double denominator = 0.0;
+        for (int n = 0; n < numNodes; n++)
+            denominator += dv[n] * HdF[n];
+        if (std::fabs(denominator) < 1.0e-300)
+            return;
+
+        for (int j = 0; j < numNodes; j++)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < numNodes; i++)
+                sum += dv[i] * inverse[i * maxNodes + j];
+            vH[j] = sum;
+        }
+
+        for (int i = 0; i < numNodes; i++)
+        {
+            const double factor = (dv[i] - HdF[i]) / denominator;
+            for (int j = 0; j < numNodes; j++)
+                inverse[i * maxNodes + j] += factor * vH[j];
+        }
+    }
+
+    WdfRootPort ports[maxPorts];
+    Resistor resistors[maxResistors] = {};
+    Element elements[maxElements];
+    int numNodes = 0;
+    int numPorts = 0;
+    int numResistors = 0;
+    int numElements = 0;
+
+    int maxIterations = 16;
+    double tolerance = 1.0e-9;
+    JacobianUpdate jacobianUpdate = JacobianUpdate::broyden;
+
+    double conductance[maxNodes * maxNodes] = {};  ///< ports and resistors
+    double jacobian[maxNodes * maxNodes] = {};
+    double inverse[maxNodes * maxNodes] = {};      ///< kept across samples in Broyden mode
+    double sources[maxNodes] = {};
+    double voltages[maxNodes] = {};                ///< the solution, and the next warm start
+    bool conductanceValid = false;
+    bool inverseValid = false;
+
+    Statistics statistics;
+};
+
+inline void WdfRootPort::initialize(double _R1)
+{
+    R1 = _R1;
+    R2 = R1;
+    if (root != nullptr)
+        root->portResistanceChanged(index);
+}
+
+/**
+\class WDFCascadedClipperCircuit
+\ingroup WDF-Objects
+\brief
+Two RC diode-pair clipping stages in cascade, the second loading the first: input through R1 into
+node 0 (C1 and a diode pair to ground), R2 to node 1 (C2 and a second pair). Both pairs are solved
+jointly at a WdfNewtonRoot. Output is the voltage at node 1.
+*/
+class WDFCascadedClipperCircuit : public IAudioSignalProcessor
+{
+public:
+    WDFCascadedClipperCircuit(void) { createWDF(); }    /* C-TOR */
+    ~WDFCascadedClipperCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        // --- rest WDF components (flush state registers)
+        seriesAdaptor_R1.reset(_sampleRate);
+        seriesAdaptor_C1.reset(_sampleRate);
+        seriesAdaptor_C2.reset(_sampleRate);
+
+        // --- intialize every subtree into its root port
+        seriesAdaptor_R1.initializeAdaptorChain();
+        seriesAdaptor_C1.initializeAdaptorChain();
+        seriesAdaptor_C2.initializeAdaptorChain();
+        root.reset();
+        return true;
+    }
+
+    virtual bool canProcessAudioFrame() { return false; }
+
+    virtual double processAudioSample(double xn)
+    {
+        // --- every subtree delivers its incident wave, then the root solves and reflects
+        seriesAdaptor_R1.setInput1(drive * xn);
+        seriesAdaptor_C1.setInput1(0.0);
+        seriesAdaptor_C2.setInput1(0.0);
+        root.solve();
+
+        return root.getVoltage(1);
+    }
+
+    /** input gain in dB */
+    void setDrive(double decibels) { drive = std::pow(10.0, decibels / 20.0); }
+
+    /** the root, for solver settings and statistics */
+    WdfNewtonRoot& getRoot() { return root; }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    void createWDF()
+    {
+        double R1_value = 2200.0;
+        double C1_value = 10e-9;
+        double R2_value = 2200.0;
+        double C2_value = 10e-9;
+
+        // --- subtrees: the driven input resistor and the two capacitors (0 ohm, 0 V sources)
+        seriesAdaptor_R1.setComponent(wdfComponent::R, R1_value);
+        seriesAdaptor_C1.setComponent(wdfComponent::C, C1_value);
+        seriesAdaptor_C2.setComponent(wdfComponent::C, C2_value);
+        seriesAdaptor_R1.setSourceResistance(sourceResistance);
+        seriesAdaptor_C1.setSourceResistance(0.0);
+        seriesAdaptor_C2.setSourceResistance(0.0);
+
+        // --- the series adaptors' port 2 is inverted, so their ports run from ground to the node
+        root.clear();
+        root.setNumNodes(2);
+        root.addPort(&seriesAdaptor_R1, -1, 0);
+        root.addPort(&seriesAdaptor_C1, -1, 0);
+        root.addPort(&seriesAdaptor_C2, -1, 1);
+        root.addResistor(0, 1, R2_value);
+
+        const int node0[] = { 0, -1 };
+        const int node1[] = { 1, -1 };
+        root.addElement(&diodes1, node0);
+        root.addElement(&diodes2, node1);
+    }
+
+protected:
+    double sourceResistance = 100.0;
+    double drive = 1.0;
+
+    WdfSeriesAdaptor seriesAdaptor_R1;
+    WdfSeriesAdaptor seriesAdaptor_C1;
+    WdfSeriesAdaptor seriesAdaptor_C2;
+    WdfDiodePairElement diodes1;
+    WdfDiodePairElement diodes2;
+    WdfNewtonRoot root;
+
+    static const int numAdaptors = 3;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_R1, &seriesAdaptor_C1, &seriesAdaptor_C2 };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_R1", "seriesAdaptor_C1", "seriesAdaptor_C2" };   ///< for profiling reports
+};
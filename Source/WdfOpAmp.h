@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    WdfOpAmp.h
+    Created: 19 Oct 2026 1:34:05am
+    Author:  Richie Haynes
+
+    Op-amps for WdfRTypeAdaptor. Two models:
+
+    - ideal: a nullor. The output supplies whatever current holds the inputs
+      at the same voltage, with no output resistance.
+    - single pole: a macro-model with finite open-loop gain A0 and
+      gain-bandwidth product GBW. The differential input drives a
+      transconductance gm into an internal node loaded by Rp and Cp, which
+      gives A0 = gm Rp and a pole at GBW / A0. The output follows the
+      internal node through the output resistance Ro. Cp is a WDF capacitor
+      that the op-amp owns; the root attaches it to one of its own ports.
+
+    In both models the output is limited to the rails. The root keeps one
+    scattering matrix per combination of saturated op-amps; an op-amp that
+    hits a rail is held there by an ideal source, so clipping costs a second
+    matrix-vector product rather than a nonlinear solve. While the rails are
+    not reached, each sample is the linear scattering plus one comparison per
+    op-amp.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <cmath>
+
+#include "FilterObjects.h"
+
+/**
+\struct WdfOpAmpParameters
+\ingroup WDF-Objects
+\brief
+Op-amp model and rails; the defaults are a JRC4558 in a 9 V pedal biased at half supply.
+*/
+struct WdfOpAmpParameters
+{
+    enum class Model { ideal, singlePole };
+
+    Model model = Model::singlePole;
+    double openLoopGain = 1.0e5;        ///< A0
+    double gainBandwidth = 3.0e6;       ///< GBW, Hz
+    double outputResistance = 75.0;     ///< Ro, ohms
+    double railLow = -3.5;              ///< output swing limits, volts
+    double railHigh = 3.5;
+
+    /** a nullor with the default rails */
+    static WdfOpAmpParameters idealNullor()
+    {
+        WdfOpAmpParameters parameters;
+        parameters.model = Model::ideal;
+        return parameters;
+    }
+
+    /** TL072 on +/-15 V */
+    static WdfOpAmpParameters tl072()
+    {
+        WdfOpAmpParameters parameters;
+        parameters.openLoopGain = 2.0e5;
+        parameters.gainBandwidth = 3.0e6;
+        parameters.outputResistance = 100.0;
+        parameters.railLow = -13.5;
+        parameters.railHigh = 13.5;
+        return parameters;
+    }
+};
+
+/**
+\class WdfOpAmp
+\ingroup WDF-Objects
+\brief
+An op-amp to be added to a WdfRTypeAdaptor with addOpAmp( ). Call reset( ) with the circuit's
+other adaptors; the single-pole model's capacitor lives here.
+*/
+class WdfOpAmp
+{
+public:
+    static constexpr double poleResistance = 1.0e6;    ///< Rp of the single-pole model
+    static constexpr double kPi = 3.14159265358979323846;
+
+    explicit WdfOpAmp(const WdfOpAmpParameters& _parameters = WdfOpAmpParameters()) : parameters(_parameters)
+    {
+        poleAdaptor.setComponent(wdfComponent::C, getPoleCapacitance());
+        poleAdaptor.setSourceResistance(0.0);
+    }
+
+    WdfOpAmp(const WdfOpAmp&) = delete;
+    WdfOpAmp& operator=(const WdfOpAmp&) = delete;
+
+    /** flush the pole capacitor and set its port resistance for the sample rate */
+    void reset(double _sampleRate)
+    {
+        poleAdaptor.reset(_sampleRate);
+        poleAdaptor.initializeAdaptorChain();
+    }
+
+    const WdfOpAmpParameters& getParameters() const { return parameters; }
+
+    bool isIdeal() const { return parameters.model == WdfOpAmpParameters::Model::ideal; }
+
+    /** gm = A0 / Rp */
+    double getTransconductance() const { return parameters.openLoopGain / poleResistance; }
+
+    /** Cp for a pole at GBW / A0 */
+    double getPoleCapacitance() const { return parameters.openLoopGain / (2.0 * kPi * parameters.gainBandwidth * poleResistance); }
+
+    /** the pole capacitor's subtree; the root connects and drives it */
+    WdfSeriesAdaptor& getPoleAdaptor() { return poleAdaptor; }
+
+private:
+    WdfOpAmpParameters parameters;
+    WdfSeriesAdaptor poleAdaptor;
+};
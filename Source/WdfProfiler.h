@@ -0,0 +1,510 @@
+/*
+  ==============================================================================
+
+    WdfProfiler.h
+    Created: 18 Oct 2026 8:31:50pm
+    Author:  Richie Haynes
+
+    Opt-in per-node profiling of a WDF tree. WdfProfiledCircuit<Circuit,
+    Policy> wraps one of the circuit classes and, when the policy is enabled,
+    splices a forwarding proxy in front of every adaptor and every
+    component (by re-pointing the port connections). Each proxy times the
+    wave calls that pass through it (setInput1/2/3, setInput, getOutput*),
+    so the recursive adaptor traffic of one sample becomes a calling-context
+    tree: time and call counts per adaptor/component and method, in the
+    context it was called from.
+
+    Results come out as a table sorted by self time (getReport( )) or as
+    collapsed stacks (writeCollapsedStacks( )), one "a;b;c value" line per
+    context, which flamegraph.pl, speedscope and inferno read directly.
+
+    With WdfNoProfiling nothing is spliced in and processAudioSample( )
+    forwards straight to the circuit, so the disabled case costs nothing.
+    The circuits the plug-in runs are never wrapped.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #if defined(_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+ #define WDF_PROFILER_HAS_CYCLE_COUNTER 1
+#else
+ #define WDF_PROFILER_HAS_CYCLE_COUNTER 0
+#endif
+
+#include "FilterObjects.h"
+
+/** profiling disabled: no proxies, no timing */
+struct WdfNoProfiling
+{
+    static constexpr bool enabled = false;
+    static uint64_t now() { return 0; }
+    static const char* getUnit() { return ""; }
+};
+
+/** nanoseconds from the steady clock; portable */
+struct WdfSteadyClockProfiling
+{
+    static constexpr bool enabled = true;
+    static uint64_t now() { return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+    static const char* getUnit() { return "ns"; }
+};
+
+#if WDF_PROFILER_HAS_CYCLE_COUNTER
+/** time-stamp counter ticks; much cheaper to read than the clock, x86 only */
+struct WdfCycleCountProfiling
+{
+    static constexpr bool enabled = true;
+    static uint64_t now() { return (uint64_t)__rdtsc(); }
+    static const char* getUnit() { return "cycles"; }
+};
+#endif
+
+template <typename Policy> class WdfProfilingAdaptor;
+
+/**
+\class WdfProfiler
+\brief
+Calling-context tree of timed WDF node calls, plus the proxies that feed it.
+*/
+template <typename Policy>
+class WdfProfiler
+{
+public:
+    static const int maxContexts = 1024;
+    static const int maxDepth = 64;
+
+    /** the methods a proxy times */
+    enum Method { setInput1, setInput2, setInput3, setInput, getOutput, getOutput1, getOutput2, getOutput3, numMethods };
+
+    explicit WdfProfiler(const std::string& rootName = "circuit")
+    {
+        contexts.reserve(maxContexts);
+        rootNode = addNode(rootName);
+        calibrate();
+        clear();
+    }
+
+    ~WdfProfiler() { detach(); }
+
+    /** splice proxies in front of adaptors[0 .. numAdaptors) and their port-3 components; any
+        previous proxies are removed first. Call again after the circuit re-creates its tree. */
+    void attach(WdfAdaptorBase* const* _adaptors, const char* const* names, int numAdaptors)
+    {
+        detach();
+        adaptors.assign(_adaptors, _adaptors + numAdaptors);
+
+        for (int i = 0; i < numAdaptors; i++)
+        {
+            addProxy(adaptors[i], names[i]);
+            if (IComponentAdaptor* component = adaptors[i]->getPort3_CompAdaptor())
+                addProxy(component, std::string(names[i]) + "/component");
+        }
+
+        for (WdfAdaptorBase* adaptor : adaptors)
+        {
+            adaptor->setPort1_CompAdaptor(findProxy(adaptor->getPort1_CompAdaptor()));
+            adaptor->setPort2_CompAdaptor(findProxy(adaptor->getPort2_CompAdaptor()));
+            adaptor->setPort3_CompAdaptor(findProxy(adaptor->getPort3_CompAdaptor()));
+        }
+    }
+
+    /** restore the original connections and drop the proxies */
+    void detach()
+    {
+        for (WdfAdaptorBase* adaptor : adaptors)
+        {
+            adaptor->setPort1_CompAdaptor(findTarget(adaptor->getPort1_CompAdaptor()));
+            adaptor->setPort2_CompAdaptor(findTarget(adaptor->getPort2_CompAdaptor()));
+            adaptor->setPort3_CompAdaptor(findTarget(adaptor->getPort3_CompAdaptor()));
+        }
+        adaptors.clear();
+        proxies.clear();
+    }
+
+    /** forget everything measured so far (nodes and proxies stay) */
+    void clear()
+    {
+        contexts.clear();
+        contexts.push_back(Context());
+        contexts[0].node = rootNode;
+        depth = 0;
+        droppedCalls = 0;
+    }
+
+    /** root of the tree: the circuit's processAudioSample( ) */
+    int getRootNode() const { return rootNode; }
+
+    /** start timing a call of node from the current context */
+    void enter(int node)
+    {
+        if (depth >= maxDepth)
+        {
+            droppedCalls++;
+            depth++;
+            return;
+        }
+
+        const int parent = depth > 0 ? stack[depth - 1] : -1;
+        int context = 0;
+        if (parent >= 0)
+        {
+            context = findChild(parent, node);
+            if (context < 0)
+            {
+                droppedCalls++;
+                stack[depth] = -1;
+                start[depth++] = Policy::now();
+                return;
+            }
+        }
+
+        stack[depth] = context;
+        start[depth++] = Policy::now();
+    }
+
+    /** stop timing the innermost call */
+    void exit()
+    {
+        const uint64_t end = Policy::now();
+        if (--depth >= maxDepth)
+            return;
+
+        const int context = stack[depth];
+        const uint64_t elapsed = end - start[depth];
+        if (context < 0)
+            return;
+
+        contexts[(size_t)context].total += elapsed;
+        contexts[(size_t)context].calls++;
+        if (depth > 0 && stack[depth - 1] >= 0)
+            contexts[(size_t)stack[depth - 1]].children += elapsed;
+    }
+
+    /** per-node table sorted by self time (inclusive time is not summed per node: the wave flow
+        re-enters adaptors, so it would count time twice) */
+    std::string getReport() const
+    {
+        const std::vector<uint64_t> childCalls = getChildCalls();
+        std::vector<uint64_t> self(names.size(), 0);
+        std::vector<uint64_t> calls(names.size(), 0);
+        uint64_t totalSelf = 0;
+        for (size_t i = 0; i < contexts.size(); i++)
+        {
+            const uint64_t contextSelf = getSelf(contexts[i], childCalls[i]);
+            self[(size_t)contexts[i].node] += contextSelf;
+            calls[(size_t)contexts[i].node] += contexts[i].calls;
+            totalSelf += contextSelf;
+        }
+
+        std::vector<int> order(names.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = (int)i;
+        std::sort(order.begin(), order.end(), [&](int a, int b) { return self[(size_t)a] > self[(size_t)b]; });
+
+        std::ostringstream report;
+        char header[160];
+        std::snprintf(header, sizeof(header), "%-48s %10s %16s %11s %8s\n", "node", "calls",
+                      (std::string("self (") + Policy::getUnit() + ")").c_str(), "per call", "self %");
+        report << header;
+        for (int node : order)
+        {
+            if (calls[(size_t)node] == 0)
+                continue;
+
+            char line[160];
+            std::snprintf(line, sizeof(line), "%-48s %10llu %16llu %11.2f %7.2f%%\n", names[(size_t)node].c_str(),
+                          (unsigned long long)calls[(size_t)node], (unsigned long long)self[(size_t)node],
+                          (double)self[(size_t)node] / (double)calls[(size_t)node],
+                          totalSelf > 0 ? 100.0 * (double)self[(size_t)node] / (double)totalSelf : 0.0);
+            report << line;
+        }
+
+        report << "timer overhead (" << overheadInside << " + " << overheadOutside << " " << Policy::getUnit() << " per call) already subtracted";
+        if (droppedCalls > 0)
+            report << "; " << droppedCalls << " calls beyond the context/depth limits not attributed";
+        report << "\n";
+        return report.str();
+    }
+
+    /** one "root;node;node self" line per calling context, for flame graph tools */
+    void writeCollapsedStacks(std::ostream& stream) const
+    {
+        const std::vector<uint64_t> childCalls = getChildCalls();
+        for (size_t i = 0; i < contexts.size(); i++)
+        {
+            const uint64_t self = getSelf(contexts[i], childCalls[i]);
+            if (self == 0)
+                continue;
+
+            std::string path = names[(size_t)contexts[i].node];
+            for (int parent = contexts[i].parent; parent >= 0; parent = contexts[(size_t)parent].parent)
+                path = names[(size_t)contexts[(size_t)parent].node] + ";" + path;
+
+            stream << path << " " << self << "\n";
+        }
+    }
+
+private:
+    friend class WdfProfilingAdaptor<Policy>;
+
+    struct Context
+    {
+        int node = 0;
+        int parent = -1;
+        int firstChild = -1;
+        int nextSibling = -1;
+        uint64_t total = 0;     ///< inclusive time
+        uint64_t children = 0;  ///< inclusive time of the calls made from here
+        uint64_t calls = 0;
+    };
+
+    /** exclusive time less the timer overhead: each call carries the inside part of its own
+        enter/exit pair and the outside part of every call it makes */
+    uint64_t getSelf(const Context& context, uint64_t childCalls) const
+    {
+        const uint64_t overhead = context.calls * overheadInside + childCalls * overheadOutside;
+        const uint64_t self = context.total > context.children ? context.total - context.children : 0;
+        return self > overhead ? self - overhead : 0;
+    }
+
+    /** calls made from each context */
+    std::vector<uint64_t> getChildCalls() const
+    {
+        std::vector<uint64_t> childCalls(contexts.size(), 0);
+        for (const Context& context : contexts)
+            if (context.parent >= 0)
+                childCalls[(size_t)context.parent] += context.calls;
+        return childCalls;
+    }
+
+    int addNode(const std::string& name)
+    {
+        names.push_back(name);
+        return (int)names.size() - 1;
+    }
+
+    /** the child context of parent for node, created on first use; -1 when full */
+    int findChild(int parent, int node)
+    {
+        int* link = &contexts[(size_t)parent].firstChild;
+        while (*link >= 0)
+        {
+            if (contexts[(size_t)*link].node == node)
+                return *link;
+            link = &contexts[(size_t)*link].nextSibling;
+        }
+
+        if ((int)contexts.size() >= maxContexts)
+            return -1;
+
+        // --- capacity was reserved up front, so this never reallocates while timing
+        Context context;
+        context.node = node;
+        context.parent = parent;
+        contexts.push_back(context);
+        *link = (int)contexts.size() - 1;
+        return *link;
+    }
+
+    /** time an empty call many times: what the callee measures is the inside overhead, what the
+        caller is left with is the outside overhead */
+    void calibrate()
+    {
+        if (!Policy::enabled)
+            return;
+
+        const int probe = addNode("calibration");
+        const int iterations = 20000;
+
+        clear();
+        enter(rootNode);
+        for (int i = 0; i < iterations; i++)
+        {
+            enter(probe);
+            exit();
+        }
+        exit();
+
+        const Context& root = contexts[0];
+        const Context& empty = contexts[1];
+        overheadInside = empty.total / (uint64_t)iterations;
+        overheadOutside = (root.total > root.children ? root.total - root.children : 0) / (uint64_t)iterations;
+    }
+
+    void addProxy(IComponentAdaptor* target, const std::string& name)
+    {
+        int nodes[numMethods];
+        static const char* const methodNames[numMethods] = { "setInput1", "setInput2", "setInput3", "setInput",
+                                                             "getOutput", "getOutput1", "getOutput2", "getOutput3" };
+        for (int method = 0; method < numMethods; method++)
+        {
+            const std::string nodeName = name + "." + methodNames[method];
+            auto found = std::find(names.begin(), names.end(), nodeName);
+            nodes[method] = found != names.end() ? (int)(found - names.begin()) : addNode(nodeName);
+        }
+
+        proxies.push_back(std::make_unique<WdfProfilingAdaptor<Policy>>(*this, *target, nodes));
+    }
+
+    IComponentAdaptor* findProxy(IComponentAdaptor* target)
+    {
+        for (auto& proxy : proxies)
+            if (&proxy->target == target)
+                return proxy.get();
+        return target;
+    }
+
+    IComponentAdaptor* findTarget(IComponentAdaptor* connection)
+    {
+        for (auto& proxy : proxies)
+            if (proxy.get() == connection)
+                return &proxy->target;
+        return connection;
+    }
+
+    std::vector<std::string> names;
+    std::vector<Context> contexts;
+    int rootNode = 0;
+    uint64_t overheadInside = 0;
+    uint64_t overheadOutside = 0;
+    uint64_t droppedCalls = 0;
+
+    int stack[maxDepth];
+    uint64_t start[maxDepth];
+    int depth = 0;
+
+    std::vector<WdfAdaptorBase*> adaptors;
+    std::vector<std::unique_ptr<WdfProfilingAdaptor<Policy>>> proxies;
+};
+
+/**
+\class WdfProfilingAdaptor
+\brief
+Forwards every IComponentAdaptor call to the wrapped adaptor or component, timing the wave calls.
+*/
+template <typename Policy>
+class WdfProfilingAdaptor : public IComponentAdaptor
+{
+public:
+    using Profiler = WdfProfiler<Policy>;
+
+    WdfProfilingAdaptor(Profiler& _profiler, IComponentAdaptor& _target, const int* _nodes)
+        : profiler(_profiler), target(_target)
+    {
+        std::copy(_nodes, _nodes + Profiler::numMethods, nodes);
+    }
+
+    // --- timed wave flow
+    virtual void setInput1(double _in1) { profiler.enter(nodes[Profiler::setInput1]); target.setInput1(_in1); profiler.exit(); }
+    virtual void setInput2(double _in2) { profiler.enter(nodes[Profiler::setInput2]); target.setInput2(_in2); profiler.exit(); }
+    virtual void setInput3(double _in3) { profiler.enter(nodes[Profiler::setInput3]); target.setInput3(_in3); profiler.exit(); }
+    virtual void setInput(double _in) { profiler.enter(nodes[Profiler::setInput]); target.setInput(_in); profiler.exit(); }
+    virtual double getOutput() { return timed(Profiler::getOutput, &IComponentAdaptor::getOutput); }
+    virtual double getOutput1() { return timed(Profiler::getOutput1, &IComponentAdaptor::getOutput1); }
+    virtual double getOutput2() { return timed(Profiler::getOutput2, &IComponentAdaptor::getOutput2); }
+    virtual double getOutput3() { return timed(Profiler::getOutput3, &IComponentAdaptor::getOutput3); }
+
+    // --- untimed set-up and state calls
+    virtual void initialize(double _R1) { target.initialize(_R1); }
+    virtual void initializeAdaptorChain() { target.initializeAdaptorChain(); }
+    virtual void reset(double _sampleRate) { target.reset(_sampleRate); }
+    virtual double getComponentResistance() { return target.getComponentResistance(); }
+    virtual double getComponentConductance() { return target.getComponentConductance(); }
+    virtual void updateComponentResistance() { target.updateComponentResistance(); }
+    virtual void setComponentValue(double _componentValue) { target.setComponentValue(_componentValue); }
+    virtual void setComponentValue_LC(double componentValue_L, double componentValue_C) { target.setComponentValue_LC(componentValue_L, componentValue_C); }
+    virtual void setComponentValue_RL(double componentValue_R, double componentValue_L) { target.setComponentValue_RL(componentValue_R, componentValue_L); }
+    virtual void setComponentValue_RC(double componentValue_R, double componentValue_C) { target.setComponentValue_RC(componentValue_R, componentValue_C); }
+    virtual double getComponentValue() { return target.getComponentValue(); }
+    virtual int getNumStateRegisters() { return target.getNumStateRegisters(); }
+    virtual void getStateRegisters(double* registers) { target.getStateRegisters(registers); }
+    virtual void setStateRegisters(const double* registers) { target.setStateRegisters(registers); }
+    virtual int getNumCoefficients() { return target.getNumCoefficients(); }
+    virtual void getCoefficients(double* coefficients) { target.getCoefficients(coefficients); }
+    virtual void setCoefficients(const double* coefficients) { target.setCoefficients(coefficients); }
+
+private:
+    friend class WdfProfiler<Policy>;
+
+    double timed(int method, double (IComponentAdaptor::*output)())
+    {
+        profiler.enter(nodes[method]);
+        const double value = (target.*output)();
+        profiler.exit();
+        return value;
+    }
+
+    Profiler& profiler;
+    IComponentAdaptor& target;
+    int nodes[Profiler::numMethods];
+};
+
+/**
+\class WdfProfiledCircuit
+\brief
+A circuit class (WDFPreGainDistortionCircuit, WDFPostGainDistortionCircuit) with its tree
+instrumented per node. Use createWDF( ) through this type so the proxies follow a rebuild.
+*/
+template <typename Circuit, typename Policy = WdfSteadyClockProfiling>
+class WdfProfiledCircuit : public Circuit
+{
+public:
+    explicit WdfProfiledCircuit(const std::string& name = "circuit") : profiler(name) { attach(); }
+
+    WdfProfiledCircuit(const WdfProfiledCircuit&) = delete;
+    WdfProfiledCircuit& operator=(const WdfProfiledCircuit&) = delete;
+
+    /** rebuild the tree and re-splice the proxies */
+    void createWDF()
+    {
+        if constexpr (Policy::enabled)
+            profiler.detach();
+
+        Circuit::createWDF();
+        attach();
+    }
+
+    virtual double processAudioSample(double xn)
+    {
+        if constexpr (!Policy::enabled)
+        {
+            return Circuit::processAudioSample(xn);
+        }
+        else
+        {
+            // --- the input adaptor's setInput1 is called directly by the circuit, so its own work
+            //     counts as the root's self time
+            profiler.enter(profiler.getRootNode());
+            const double yn = Circuit::processAudioSample(xn);
+            profiler.exit();
+            return yn;
+        }
+    }
+
+    WdfProfiler<Policy>& getProfiler() { return profiler; }
+
+private:
+    void attach()
+    {
+        if constexpr (Policy::enabled)
+            profiler.attach(this->adaptors, Circuit::adaptorNames, Circuit::numAdaptors);
+    }
+
+    WdfProfiler<Policy> profiler;
+};
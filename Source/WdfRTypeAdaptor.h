@@ -0,0 +1,908 @@
+/*
+  ==============================================================================
+
+    WdfRTypeAdaptor.h
+    Created: 18 Oct 2026 11:36:12pm
+    Author:  Richie Haynes
+
+    Linear root for topologies that do not decompose into series and parallel
+    adaptors (bridged-T networks, bridges, feedback around a node). Subtrees
+    attach through WdfRootPorts between nodes of a small nodal network, as at
+    WdfNewtonRoot, and fixed resistors can be stamped between nodes. Since the
+    network is linear the reflected waves are b = S a for a scattering matrix
+    S that depends only on the resistances, so S is derived once by modified
+    nodal analysis and each sample costs one matrix-vector product.
+
+    With M the MNA matrix (node conductances plus one row and column per
+    op-amp and transformer), H = M^-1 and E the node-to-port incidence
+    matrix, the port voltages are E^T H E diag(1 / R) a and
+    S = 2 E^T H E diag(1 / R) - I. When one port resistance changes (a pot,
+    or a capacitor at a new sample rate) M changes by a rank-1 term and H is
+    updated with Sherman-Morrison in O(unknowns^2) instead of being
+    refactored; after refreshInterval such updates everything is rebuilt
+    from scratch to stop rounding error from accumulating. Nothing
+    allocates.
+
+    Op-amps (WdfOpAmp.h) keep the network piecewise linear: one matrix set is
+    kept per combination of op-amps held at a rail, and each sample picks the
+    combination consistent with the incident waves. Transformers
+    (WdfTransformer.h) are linear and only add columns to S.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "WdfNewtonRoot.h"
+#include "WdfOpAmp.h"
+#include "WdfTransformer.h"
+
+/**
+\class WdfRTypeAdaptor
+\ingroup WDF-Objects
+\brief
+R-type adaptor at the root of a tree: an arbitrary linear resistive network, optionally with
+op-amps and transformers, joining several subtrees. Node -1 is ground. Build it (setNumNodes( ),
+addPort( ), addResistor( ), addOpAmp( ), addTransformer( )) before the subtrees are initialised;
+per sample, drive every subtree's setInput1( ) and then call scatter( ).
+*/
+class WdfRTypeAdaptor : public IWdfRootNetwork
+{
+public:
+    static constexpr int maxNodes = 8;
+    static constexpr int maxPorts = 12;
+    static constexpr int maxResistors = 8;
+    static constexpr int maxOpAmps = 2;
+    static constexpr int maxTransformers = 2;
+    static constexpr int refreshInterval = 64;     ///< rank-1 updates between full rebuilds
+
+    WdfRTypeAdaptor() {}
+    WdfRTypeAdaptor(const WdfRTypeAdaptor&) = delete;
+    WdfRTypeAdaptor& operator=(const WdfRTypeAdaptor&) = delete;
+
+    /** remove every port, resistor, op-amp and transformer */
+    void clear()
+    {
+        numNodes = numPorts = numResistors = numOpAmps = numTransformers = 0;
+        matricesValid = false;
+    }
+
+    /** number of non-ground nodes */
+    void setNumNodes(int _numNodes) { numNodes = std::min(std::max(_numNodes, 0), maxNodes); }
+
+    /** a port between two nodes, positive at nodePlus, with subtree connected to it; false (and
+        nothing connected) if the root already has maxPorts ports */
+    bool addPort(WdfAdaptorBase* subtree, int nodePlus, int nodeMinus)
+    {
+        if (numPorts == maxPorts)
+            return false;
+
+        WdfRootPort& port = ports[numPorts];
+        port.root = this;
+        port.index = numPorts++;
+        port.nodePlus = nodePlus;
+        port.nodeMinus = nodeMinus;
+        WdfAdaptorBase::connectAdaptors(subtree, &port);
+        matricesValid = false;
+        return true;
+    }
+
+    /** a fixed resistor between two nodes; false if the root already has maxResistors */
+    bool addResistor(int node1, int node2, double resistance)
+    {
+        if (numResistors == maxResistors)
+            return false;
+        resistors[numResistors++] = { node1, node2, 1.0 / resistance };
+        matricesValid = false;
+        return true;
+    }
+
+    /** an op-amp; the single-pole model adds an internal node and a port for its capacitor, so call
+        setNumNodes( ) first. The root does not own the op-amp. False if there is no room for it. */
+    bool addOpAmp(WdfOpAmp* opAmp, int inPlus, int inMinus, int out)
+    {
+        if (numOpAmps == maxOpAmps || (!opAmp->isIdeal() && (numNodes == maxNodes || numPorts == maxPorts)))
+            return false;
+
+        OpAmp& entry = opAmps[numOpAmps++];
+        entry.opAmp = opAmp;
+        entry.inPlus = inPlus;
+        entry.inMinus = inMinus;
+        entry.out = out;
+        entry.control = out;
+
+        // --- the single-pole model saturates at its internal node, behind the output resistance
+        if (!opAmp->isIdeal())
+        {
+            entry.control = numNodes++;
+            addPort(&opAmp->getPoleAdaptor(), -1, entry.control);
+        }
+        matricesValid = false;
+        return true;
+    }
+
+    /** a transformer from the primary to the secondary winding; adds two internal nodes and three
+        ports for its inductances, so call setNumNodes( ) first. The root does not own the transformer.
+        False if there is no room for it. */
+    bool addTransformer(WdfTransformer* transformer, int primaryPlus, int primaryMinus, int secondaryPlus, int secondaryMinus)
+    {
+        if (numTransformers == maxTransformers || numNodes + 2 > maxNodes || numPorts + WdfTransformer::numAdaptors > maxPorts)
+            return false;
+
+        Transformer& entry = transformers[numTransformers++];
+        entry.transformer = transformer;
+        entry.primaryPlus = numNodes++;
+        entry.primaryMinus = primaryMinus;
+        entry.secondaryPlus = numNodes++;
+        entry.secondaryMinus = secondaryMinus;
+
+        // --- leakage and winding resistance in series with each winding, Lm across the ideal primary
+        addPort(transformer->getAdaptor(0), primaryPlus, entry.primaryPlus);
+        addPort(transformer->getAdaptor(1), secondaryPlus, entry.secondaryPlus);
+        addPort(transformer->getAdaptor(2), entry.primaryPlus, primaryMinus);
+        matricesValid = false;
+        return true;
+    }
+
+    /** reflect b = S a into every subtree from the ports' incident waves */
+    void scatter()
+    {
+        if (!matricesValid)
+            rebuild();
+
+        for (int k = 0; k < numOpAmps; k++)
+            if (!opAmps[k].opAmp->isIdeal())
+                opAmps[k].opAmp->getPoleAdaptor().setInput1(0.0);
+        for (int t = 0; t < numTransformers; t++)
+            for (int i = 0; i < WdfTransformer::numAdaptors; i++)
+                transformers[t].transformer->getAdaptor(i)->setInput1(0.0);
+
+        for (int j = 0; j < numPorts; j++)
+            incident[j] = ports[j].in1;
+
+        // --- the linear configuration unless an op-amp reaches a rail
+        activeMask = numOpAmps > 0 ? findConfiguration() : 0;
+        const Configuration& configuration = configurations[activeMask];
+
+        // --- b = S a, four rows at a time: S is column-major with a padded stride, so each block
+        //     is a sum of aligned four-wide column slices held in registers (SSE2/AVX/NEON lanes)
+        alignas(32) double b[stride];
+        const int rows = (numPorts + 3) & ~3;
+        for (int i = 0; i < rows; i += 4)
+        {
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0, b3 = 0.0;
+            for (int j = 0; j < numPorts; j++)
+            {
+                const double aj = incident[j];
+                const double* slice = configuration.scattering + j * stride + i;
+                b0 += slice[0] * aj;
+                b1 += slice[1] * aj;
+                b2 += slice[2] * aj;
+                b3 += slice[3] * aj;
+            }
+            b[i] = b0;
+            b[i + 1] = b1;
+            b[i + 2] = b2;
+            b[i + 3] = b3;
+        }
+
+        // --- op-amps held at a rail act as fixed sources
+        if (activeMask != 0)
+        {
+            numSaturatedSamples++;
+            for (int k = 0; k < numOpAmps; k++)
+            {
+                if ((activeMask & (1 << k)) == 0)
+                    continue;
+                const double* offset = configuration.waveOffset + k * stride;
+                for (int i = 0; i < rows; i++)
+                    b[i] += railVoltage[k] * offset[i];
+            }
+        }
+
+        for (int p = 0; p < numPorts; p++)
+            ports[p].reflectWave(b[p]);
+    }
+
+    /** voltage of a node after scatter( ); 0 for ground */
+    double getVoltage(int node) const
+    {
+        if (node < 0 || !matricesValid)
+            return 0.0;
+        return nodeVoltage(configurations[activeMask], activeMask, node);
+    }
+
+    /** entry (row, column) of the linear configuration's scattering matrix */
+    double getScattering(int row, int column) const { return configurations[0].scattering[column * stride + row]; }
+
+    /** false if the network is singular (a node with no path to ground); every port is then shorted */
+    bool isValid() const { return networkValid; }
+
+    /** full rebuilds and Sherman-Morrison updates since construction */
+    int getNumRebuilds() const { return numRebuilds; }
+    int getNumUpdates() const { return numUpdates; }
+
+    /** samples on which at least one op-amp was held at a rail */
+    uint64_t getNumSaturatedSamples() const { return numSaturatedSamples; }
+
+    /** derive every configuration from scratch for the current port resistances; false if the
+        linear configuration is singular */
+    bool rebuild()
+    {
+        numRebuilds++;
+        matricesValid = true;
+        updatesSinceRebuild = 0;
+        activeMask = 0;
+
+        for (int p = 0; p < numPorts; p++)
+            portConductance[p] = 1.0 / ports[p].R1;
+
+        for (int mask = 0; mask < (1 << numOpAmps); mask++)
+        {
+            Configuration& configuration = configurations[mask];
+            double system[maxUnknowns * maxUnknowns];
+            buildSystem(mask, system);
+
+            configuration.valid = invert(system, configuration.inverse);
+            if (configuration.valid)
+                derive(configuration);
+        }
+
+        networkValid = configurations[0].valid;
+        if (!networkValid)
+        {
+            Configuration& linear = configurations[0];
+            std::fill(linear.scattering, linear.scattering + stride * stride, 0.0);
+            for (int p = 0; p < numPorts; p++)
+                linear.scattering[p * stride + p] = -1.0;
+            std::fill(linear.nodeTransfer, linear.nodeTransfer + maxPorts * maxNodes, 0.0);
+        }
+        return networkValid;
+    }
+
+    /** a port resistance changed: Sherman-Morrison update of every configuration, or a rebuild when due */
+    virtual void portResistanceChanged(int port)
+    {
+        if (!matricesValid || !networkValid || port >= numPorts || updatesSinceRebuild >= refreshInterval)
+        {
+            matricesValid = false;
+            return;
+        }
+
+        const double change = 1.0 / ports[port].R1 - portConductance[port];
+        if (change == 0.0)
+            return;
+
+        const int plus = ports[port].nodePlus;
+        const int minus = ports[port].nodeMinus;
+        const int numUnknowns = getNumUnknowns();
+
+        for (int mask = 0; mask < (1 << numOpAmps); mask++)
+        {
+            Configuration& configuration = configurations[mask];
+            if (!configuration.valid)
+                continue;
+
+            // --- M' = M + change e e^T: H' = H - change (H e)(e^T H) / (1 + change e^T H e)
+            double* H = configuration.inverse;
+            double column[maxUnknowns], row[maxUnknowns];
+            for (int u = 0; u < numUnknowns; u++)
+            {
+                column[u] = at(H, u, plus) - at(H, u, minus);
+                row[u] = at(H, plus, u) - at(H, minus, u);
+            }
+
+            const double denominator = 1.0 + change * ((plus >= 0 ? column[plus] : 0.0) - (minus >= 0 ? column[minus] : 0.0));
+            if (std::fabs(denominator) < 1.0e-12)
+            {
+                matricesValid = false;
+                return;
+            }
+
+            const double factor = change / denominator;
+            for (int i = 0; i < numUnknowns; i++)
+                for (int j = 0; j < numUnknowns; j++)
+                    H[i * maxUnknowns + j] -= factor * column[i] * row[j];
+        }
+
+        portConductance[port] += change;
+        for (int mask = 0; mask < (1 << numOpAmps); mask++)
+            if (configurations[mask].valid)
+                derive(configurations[mask]);
+
+        numUpdates++;
+        updatesSinceRebuild++;
+    }
+
+private:
+    static const int stride = (maxPorts + 3) & ~3;     ///< column stride of S, a multiple of four
+    static const int maxUnknowns = maxNodes + maxOpAmps + maxTransformers;
+
+    struct Resistor
+    {
+        int node1;
+        int node2;
+        double conductance;
+    };
+
+    struct OpAmp
+    {
+        WdfOpAmp* opAmp = nullptr;
+        int inPlus = -1;
+        int inMinus = -1;
+        int out = -1;
+        int control = -1;   ///< the node held at a rail: the output, or the single-pole model's internal node
+    };
+
+    struct Transformer
+    {
+        WdfTransformer* transformer = nullptr;
+        int primaryPlus = -1;       ///< the ideal transformer's terminals, inside the leakages
+        int primaryMinus = -1;
+        int secondaryPlus = -1;
+        int secondaryMinus = -1;
+    };
+
+    /** the matrices for one combination of saturated op-amps */
+    struct Configuration
+    {
+        double inverse[maxUnknowns * maxUnknowns] = {};    ///< H, kept for the rank-1 updates
+        alignas(32) double scattering[stride * stride] = {};   ///< S, column-major
+        alignas(32) double waveOffset[maxOpAmps * stride] = {};    ///< b per volt at each clamped op-amp
+        double nodeTransfer[maxPorts * maxNodes] = {};     ///< node voltages per unit incident wave, one row per port
+        double nodeOffset[maxOpAmps * maxNodes] = {};      ///< node voltages per volt at each clamped op-amp
+        bool valid = false;
+    };
+
+    int getNumUnknowns() const { return numNodes + numOpAmps + numTransformers; }
+
+    /** H[row][column], 0 for the ground node */
+    static double at(const double* matrix, int row, int column)
+    {
+        return row >= 0 && column >= 0 ? matrix[row * maxUnknowns + column] : 0.0;
+    }
+
+    static void add(double* matrix, int row, int column, double value)
+    {
+        if (row >= 0 && column >= 0)
+            matrix[row * maxUnknowns + column] += value;
+    }
+
+    /** stamp conductance g between two nodes */
+    static void stamp(double* matrix, int node1, int node2, double g)
+    {
+        add(matrix, node1, node1, g);
+        add(matrix, node2, node2, g);
+        add(matrix, node1, node2, -g);
+        add(matrix, node2, node1, -g);
+    }
+
+    /** MNA matrix with the op-amps in mask held at a rail */
+    void buildSystem(int mask, double* system) const
+    {
+        std::fill(system, system + maxUnknowns * maxUnknowns, 0.0);
+        for (int p = 0; p < numPorts; p++)
+            stamp(system, ports[p].nodePlus, ports[p].nodeMinus, portConductance[p]);
+        for (int r = 0; r < numResistors; r++)
+            stamp(system, resistors[r].node1, resistors[r].node2, resistors[r].conductance);
+
+        for (int k = 0; k < numOpAmps; k++)
+        {
+            const OpAmp& entry = opAmps[k];
+            const int extra = numNodes + k;
+            const bool clamped = (mask & (1 << k)) != 0;
+
+            if (entry.opAmp->isIdeal())
+            {
+                // --- output current is the extra unknown; nullator v+ = v-, or the output at the rail
+                add(system, entry.out, extra, -1.0);
+                if (clamped)
+                    add(system, extra, entry.out, 1.0);
+                else
+                {
+                    add(system, extra, entry.inPlus, 1.0);
+                    add(system, extra, entry.inMinus, -1.0);
+                }
+            }
+            else
+            {
+                // --- gm (v+ - v-) into Rp at the internal node, followed through Ro without loading it
+                const int x = entry.control;
+                const double gm = entry.opAmp->getTransconductance();
+                const double Go = 1.0 / entry.opAmp->getParameters().outputResistance;
+                add(system, x, x, 1.0 / WdfOpAmp::poleResistance);
+                add(system, x, entry.inPlus, -gm);
+                add(system, x, entry.inMinus, gm);
+                add(system, entry.out, entry.out, Go);
+                add(system, entry.out, x, -Go);
+
+                // --- the extra unknown is the clamp current, zero while linear
+                if (clamped)
+                {
+                    add(system, x, extra, -1.0);
+                    add(system, extra, x, 1.0);
+                }
+                else
+                    add(system, extra, extra, 1.0);
+            }
+        }
+
+        // --- ideal transformer: the primary current is the extra unknown, n times it leaves the
+        //     secondary, and Vprimary = n Vsecondary
+        for (int t = 0; t < numTransformers; t++)
+        {
+            const Transformer& entry = transformers[t];
+            const int extra = numNodes + numOpAmps + t;
+            const double n = entry.transformer->getParameters().turnsRatio;
+
+            add(system, entry.primaryPlus, extra, 1.0);
+            add(system, entry.primaryMinus, extra, -1.0);
+            add(system, entry.secondaryPlus, extra, -n);
+            add(system, entry.secondaryMinus, extra, n);
+            add(system, extra, entry.primaryPlus, 1.0);
+            add(system, extra, entry.primaryMinus, -1.0);
+            add(system, extra, entry.secondaryPlus, -n);
+            add(system, extra, entry.secondaryMinus, n);
+        }
+    }
+
+    /** S, the node transfers and the clamp offsets from H */
+    void derive(Configuration& configuration) const
+    {
+        const double* H = configuration.inverse;
+
+        // --- node voltages per unit incident wave: H E diag(1 / R)
+        for (int p = 0; p < numPorts; p++)
+            for (int n = 0; n < numNodes; n++)
+                configuration.nodeTransfer[p * maxNodes + n] = (at(H, n, ports[p].nodePlus) - at(H, n, ports[p].nodeMinus)) * portConductance[p];
+
+        // --- S = 2 E^T (node transfer) - I
+        for (int j = 0; j < numPorts; j++)
+            for (int i = 0; i < numPorts; i++)
+                configuration.scattering[j * stride + i] = 2.0 * (transferAt(configuration, j, ports[i].nodePlus) - transferAt(configuration, j, ports[i].nodeMinus))
+                                                           - (i == j ? 1.0 : 0.0);
+
+        // --- a volt at a clamp is a unit right-hand side in its constraint row
+        for (int k = 0; k < numOpAmps; k++)
+        {
+            double* nodeOffset = configuration.nodeOffset + k * maxNodes;
+            for (int n = 0; n < numNodes; n++)
+                nodeOffset[n] = H[n * maxUnknowns + numNodes + k];
+            for (int i = 0; i < numPorts; i++)
+            {
+                const double plus = ports[i].nodePlus >= 0 ? nodeOffset[ports[i].nodePlus] : 0.0;
+                const double minus = ports[i].nodeMinus >= 0 ? nodeOffset[ports[i].nodeMinus] : 0.0;
+                configuration.waveOffset[k * stride + i] = 2.0 * (plus - minus);
+            }
+        }
+    }
+
+    static double transferAt(const Configuration& configuration, int port, int node)
+    {
+        return node >= 0 ? configuration.nodeTransfer[port * maxNodes + node] : 0.0;
+    }
+
+    double nodeVoltage(const Configuration& configuration, int mask, int node) const
+    {
+        if (node < 0)
+            return 0.0;
+
+        double sum = 0.0;
+        for (int p = 0; p < numPorts; p++)
+            sum += configuration.nodeTransfer[p * maxNodes + node] * incident[p];
+        for (int k = 0; k < numOpAmps; k++)
+            if ((mask & (1 << k)) != 0)
+                sum += railVoltage[k] * configuration.nodeOffset[k * maxNodes + node];
+        return sum;
+    }
+
+    /** the set of op-amps at a rail that is consistent with the incident waves: a linear op-amp
+        whose output would pass a rail is clamped there, a clamped one is released once its input
+        drives it back */
+    int findConfiguration()
+    {
+        int mask = 0;
+        for (int pass = 0; pass <= numOpAmps; pass++)
+        {
+            const Configuration& configuration = configurations[mask];
+            int next = mask;
+
+            for (int k = 0; k < numOpAmps; k++)
+            {
+                const OpAmp& entry = opAmps[k];
+                const WdfOpAmpParameters& parameters = entry.opAmp->getParameters();
+                const int bit = 1 << k;
+
+                if ((mask & bit) != 0)
+                {
+                    const double drive = nodeVoltage(configuration, mask, entry.inPlus) - nodeVoltage(configuration, mask, entry.inMinus);
+                    if (railVoltage[k] == parameters.railHigh ? drive < 0.0 : drive > 0.0)
+                        next &= ~bit;
+                    continue;
+                }
+
+                // --- the fast path: one dot product per op-amp while inside the rails
+                const double output = nodeVoltage(configuration, mask, entry.control);
+                if (output > parameters.railHigh || output < parameters.railLow)
+                {
+                    railVoltage[k] = output > parameters.railHigh ? parameters.railHigh : parameters.railLow;
+                    next |= bit;
+                }
+            }
+
+            if (next == mask || !configurations[next].valid)
+                break;
+            mask = next;
+        }
+        return mask;
+    }
+
+    /** Gauss-Jordan with partial pivoting over the node, op-amp and transformer unknowns; false if singular */
+    bool invert(const double* matrix, double* result) const
+    {
+        const int size = getNumUnknowns();
+        double work[maxUnknowns * maxUnknowns];
+        std::copy(matrix, matrix + maxUnknowns * maxUnknowns, work);
+        std::fill(result, result + maxUnknowns * maxUnknowns, 0.0);
+        for (int i = 0; i < size; i++)
+            result[i * maxUnknowns + i] = 1.0;
+
+        for (int column = 0; column < size; column++)
+        {
+            int pivot = column;
+            for (int row = column + 1; row < size; row++)
+                if (std::fabs(work[row * maxUnknowns + column]) > std::fabs(work[pivot * maxUnknowns + column]))
+                    pivot = row;
+
+            if (std::fabs(work[pivot * maxUnknowns + column]) < 1.0e-15)
+                return false;
+
+            if (pivot != column)
+            {
+                for (int j = 0; j < size; j++)
+                {
+                    std::swap(work[pivot * maxUnknowns + j], work[column * maxUnknowns + j]);
+                    std::swap(result[pivot * maxUnknowns + j], result[column * maxUnknowns + j]);
+                }
+            }
+
+            const double scale = 1.0 / work[column * maxUnknowns + column];
+            for (int j = 0; j < size; j++)
+            {
+                work[column * maxUnknowns + j] *= scale;
+                result[column * maxUnknowns + j] *= scale;
+            }
+
+            for (int row = 0; row < size; row++)
+            {
+                const double factor = work[row * maxUnknowns + column];
+                if (row == column || factor == 0.0)
+                    continue;
+                for (int j = 0; j < size; j++)
+                {
+                    work[row * maxUnknowns + j] -= factor * work[column * maxUnknowns + j];
+                    result[row * maxUnknowns + j] -= factor * result[column * maxUnknowns + j];
+                }
+            }
+        }
+        return true;
+    }
+
+    WdfRootPort ports[maxPorts];
+    Resistor resistors[maxResistors] = {};
+    OpAmp opAmps[maxOpAmps];
+    Transformer transformers[maxTransformers];
+    int numNodes = 0;
+    int numPorts = 0;
+    int numResistors = 0;
+    int numOpAmps = 0;
+    int numTransformers = 0;
+
+    Configuration configurations[1 << maxOpAmps];
+    double portConductance[maxPorts] = {};                 ///< 1 / R the matrices were built for
+    double incident[maxPorts] = {};                        ///< last incident waves, for getVoltage( )
+    double railVoltage[maxOpAmps] = {};                    ///< the rail each clamped op-amp is held at
+    int activeMask = 0;                                    ///< op-amps clamped on the last sample
+    bool matricesValid = false;
+    bool networkValid = false;
+    int updatesSinceRebuild = 0;
+    int numRebuilds = 0;
+    int numUpdates = 0;
+    uint64_t numSaturatedSamples = 0;
+};
+
+/**
+\class WDFBridgedTCircuit
+\ingroup WDF-Objects
+\brief
+Bridged-T notch: the input drives two series capacitors C1 and C2 to the output, their junction goes
+to ground through R2, and the Notch pot R1 bridges input to output. The output is loaded by
+R_load. No series/parallel decomposition exists, so every element hangs off a WdfRTypeAdaptor;
+moving the pot updates the scattering matrix incrementally. Notch frequency is
+1 / (2 pi C sqrt(R1 R2)) for C1 = C2 = C.
+*/
+class WDFBridgedTCircuit : public IAudioSignalProcessor
+{
+public:
+    WDFBridgedTCircuit(void) { createWDF(); }    /* C-TOR */
+    ~WDFBridgedTCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        // --- rest WDF components (flush state registers)
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->reset(_sampleRate);
+
+        // --- intialize every subtree into its root port
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->initializeAdaptorChain();
+        return rType.rebuild();
+    }
+
+    virtual bool canProcessAudioFrame() { return false; }
+
+    virtual double processAudioSample(double xn)
+    {
+        // --- every subtree delivers its incident wave, then the root scatters
+        seriesAdaptor_Rs.setInput1(xn);
+        seriesAdaptor_C1.setInput1(0.0);
+        seriesAdaptor_C2.setInput1(0.0);
+        seriesAdaptor_R1.setInput1(0.0);
+        rType.scatter();
+
+        return rType.getVoltage(outputNode);
+    }
+
+    /** bridging resistance in ohms; a single port changes, so the root updates in O(ports^2) */
+    void setNotch(double _notch)
+    {
+        seriesAdaptor_R1.setComponentValue(_notch);
+        seriesAdaptor_R1.initializeAdaptorChain();
+    }
+
+    /** the root, for inspection */
+    WdfRTypeAdaptor& getRoot() { return rType; }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    void createWDF()
+    {
+        double C1_value = 10e-9;
+        double C2_value = 10e-9;
+        double R1_value = 47000.0;
+        double R2_value = 1000.0;
+        double Rload_value = 100000.0;
+
+        // --- subtrees: the source resistance, both capacitors and the pot (0 ohm, 0 V sources)
+        seriesAdaptor_Rs.setComponent(wdfComponent::R, sourceResistance);
+        seriesAdaptor_C1.setComponent(wdfComponent::C, C1_value);
+        seriesAdaptor_C2.setComponent(wdfComponent::C, C2_value);
+        seriesAdaptor_R1.setComponent(wdfComponent::R, R1_value);
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->setSourceResistance(0.0);
+
+        // --- nodes: 0 input, 1 capacitor junction, 2 output; the series adaptors' port 2 is
+        //     inverted, so the source port runs from ground to the input node
+        rType.clear();
+        rType.setNumNodes(3);
+        rType.addPort(&seriesAdaptor_Rs, -1, 0);
+        rType.addPort(&seriesAdaptor_C1, 0, 1);
+        rType.addPort(&seriesAdaptor_C2, 1, outputNode);
+        rType.addPort(&seriesAdaptor_R1, 0, outputNode);
+        rType.addResistor(1, -1, R2_value);
+        rType.addResistor(outputNode, -1, Rload_value);
+    }
+
+protected:
+    static const int outputNode = 2;
+    double sourceResistance = 100.0;
+
+    WdfSeriesAdaptor seriesAdaptor_Rs;
+    WdfSeriesAdaptor seriesAdaptor_C1;
+    WdfSeriesAdaptor seriesAdaptor_C2;
+    WdfSeriesAdaptor seriesAdaptor_R1;
+    WdfRTypeAdaptor rType;
+
+    static const int numAdaptors = 4;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_Rs, &seriesAdaptor_C1, &seriesAdaptor_C2, &seriesAdaptor_R1 };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_Rs", "seriesAdaptor_C1", "seriesAdaptor_C2", "seriesAdaptor_R1" };   ///< for profiling reports
+};
+
+/**
+\class WDFOpAmpGainStageCircuit
+\ingroup WDF-Objects
+\brief
+Non-inverting op-amp gain stage of a drive pedal: the input drives the + input through Rs with a
+510k bias resistor, the feedback is Rf plus the Drive pot bypassed by Cf, and the - input goes to
+ground through Ri and Ci. Gain is 1 + (Rf + Drive) / Ri above the Ri Ci corner; past the rails
+the op-amp clips. Output is the op-amp output into a 10k load.
+*/
+class WDFOpAmpGainStageCircuit : public IAudioSignalProcessor
+{
+public:
+    WDFOpAmpGainStageCircuit(const WdfOpAmpParameters& _parameters = WdfOpAmpParameters()) : opAmp(_parameters) { createWDF(); }    /* C-TOR */
+    ~WDFOpAmpGainStageCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        // --- rest WDF components (flush state registers)
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->reset(_sampleRate);
+
+        // --- intialize every subtree into its root port
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->initializeAdaptorChain();
+        return rType.rebuild();
+    }
+
+    virtual bool canProcessAudioFrame() { return false; }
+
+    virtual double processAudioSample(double xn)
+    {
+        // --- every subtree delivers its incident wave, then the root scatters
+        seriesAdaptor_Rs.setInput1(xn);
+        seriesAdaptor_RiCi.setInput1(0.0);
+        seriesAdaptor_Rf.setInput1(0.0);
+        seriesAdaptor_Cf.setInput1(0.0);
+        rType.scatter();
+
+        return rType.getVoltage(outputNode);
+    }
+
+    /** Drive pot in ohms, in series with Rf */
+    void setDrive(double _drive)
+    {
+        seriesAdaptor_Rf.setComponentValue(Rf_value + _drive);
+        seriesAdaptor_Rf.initializeAdaptorChain();
+    }
+
+    /** the root, for inspection */
+    WdfRTypeAdaptor& getRoot() { return rType; }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    void createWDF()
+    {
+        double Rs_value = 1000.0;
+        double Rbias_value = 510000.0;
+        double Ri_value = 4700.0;
+        double Ci_value = 47e-9;
+        double Cf_value = 51e-12;
+        double Rload_value = 10000.0;
+
+        // --- subtrees: source resistance (driven), Ri + Ci, Rf + Drive and Cf (0 ohm, 0 V sources)
+        seriesAdaptor_Rs.setComponent(wdfComponent::R, Rs_value);
+        seriesAdaptor_RiCi.setComponent(wdfComponent::seriesRC, Ri_value, Ci_value);
+        seriesAdaptor_Rf.setComponent(wdfComponent::R, Rf_value + Drive_value);
+        seriesAdaptor_Cf.setComponent(wdfComponent::C, Cf_value);
+        for (int i = 0; i < numSubtrees; i++)
+            adaptors[i]->setSourceResistance(0.0);
+
+        // --- nodes: 0 + input, 1 - input, 2 output; the series adaptors' port 2 is inverted, so
+        //     the source port runs from ground to the + input
+        rType.clear();
+        rType.setNumNodes(3);
+        rType.addPort(&seriesAdaptor_Rs, -1, 0);
+        rType.addPort(&seriesAdaptor_RiCi, 1, -1);
+        rType.addPort(&seriesAdaptor_Rf, outputNode, 1);
+        rType.addPort(&seriesAdaptor_Cf, outputNode, 1);
+        rType.addResistor(0, -1, Rbias_value);
+        rType.addResistor(outputNode, -1, Rload_value);
+        rType.addOpAmp(&opAmp, 0, 1, outputNode);
+    }
+
+protected:
+    static const int outputNode = 2;
+    double Rf_value = 51000.0;
+    double Drive_value = 250000.0;
+
+    WdfOpAmp opAmp;
+    WdfSeriesAdaptor seriesAdaptor_Rs;
+    WdfSeriesAdaptor seriesAdaptor_RiCi;
+    WdfSeriesAdaptor seriesAdaptor_Rf;
+    WdfSeriesAdaptor seriesAdaptor_Cf;
+    WdfRTypeAdaptor rType;
+
+    static const int numSubtrees = 4;
+    static const int numAdaptors = 5;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_Rs, &seriesAdaptor_RiCi, &seriesAdaptor_Rf, &seriesAdaptor_Cf, &opAmp.getPoleAdaptor() };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_Rs", "seriesAdaptor_RiCi", "seriesAdaptor_Rf", "seriesAdaptor_Cf", "opAmp.poleAdaptor" };   ///< for profiling reports
+};
+
+/**
+\class WDFOutputTransformerCircuit
+\ingroup WDF-Objects
+\brief
+Output stage into a speaker through a WdfTransformer: the input, as the plate voltage swing, drives
+the primary through the plate resistance, and the secondary feeds an 8 ohm load. Output is the
+load voltage.
+*/
+class WDFOutputTransformerCircuit : public IAudioSignalProcessor
+{
+public:
+    WDFOutputTransformerCircuit(const WdfTransformerParameters& _parameters = WdfTransformerParameters()) : transformer(_parameters) { createWDF(); }    /* C-TOR */
+    ~WDFOutputTransformerCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        // --- rest WDF components (flush state registers)
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->reset(_sampleRate);
+
+        // --- intialize every subtree into its root port
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->initializeAdaptorChain();
+        return rType.rebuild();
+    }
+
+    virtual bool canProcessAudioFrame() { return false; }
+
+    virtual double processAudioSample(double xn)
+    {
+        // --- the source delivers its incident wave; the root drives the transformer's own subtrees
+        seriesAdaptor_Rplate.setInput1(xn);
+        rType.scatter();
+
+        return rType.getVoltage(outputNode);
+    }
+
+    /** the root, for inspection */
+    WdfRTypeAdaptor& getRoot() { return rType; }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    void createWDF()
+    {
+        double Rplate_value = 2500.0;
+        double Rload_value = 8.0;
+
+        seriesAdaptor_Rplate.setComponent(wdfComponent::R, Rplate_value);
+        seriesAdaptor_Rplate.setSourceResistance(0.0);
+
+        // --- nodes: 0 primary, 1 secondary (output); the series adaptors' port 2 is inverted, so
+        //     the source port runs from ground to the primary
+        rType.clear();
+        rType.setNumNodes(2);
+        rType.addPort(&seriesAdaptor_Rplate, -1, 0);
+        rType.addTransformer(&transformer, 0, -1, outputNode, -1);
+        rType.addResistor(outputNode, -1, Rload_value);
+    }
+
+protected:
+    static const int outputNode = 1;
+
+    WdfTransformer transformer;
+    WdfSeriesAdaptor seriesAdaptor_Rplate;
+    WdfRTypeAdaptor rType;
+
+    static const int numAdaptors = 4;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_Rplate, transformer.getAdaptor(0), transformer.getAdaptor(1), transformer.getAdaptor(2) };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_Rplate", "transformer.primary", "transformer.secondary", "transformer.magnetizing" };   ///< for profiling reports
+};
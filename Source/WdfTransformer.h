@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    WdfTransformer.h
+    Created: 19 Oct 2026 2:27:40am
+    Author:  Richie Haynes
+
+    Two-winding transformer for WdfRTypeAdaptor: an ideal transformer of
+    turns ratio n = Np / Ns with the usual T equivalent around it.
+
+        primary+ --Rp--Llp--+          +--Lls--Rs-- secondary+
+                            |          |
+                            Lm   n:1   ideal
+                            |          |
+        primary- -----------+          +----------- secondary-
+
+    The winding resistances and leakage inductances are seriesRL subtrees,
+    and the magnetising inductance Lm is an inductor subtree; the
+    transformer owns all three and the root attaches them to its own ports.
+    The ideal transformer itself is one extra unknown in the root's nodal
+    equations (the primary current) with the constraint
+    Vprimary = n Vsecondary, so once the scattering matrix is built the
+    transformer costs three more columns in the matrix-vector product and
+    nothing else. Lm gives the low-frequency roll-off and blocks DC, and the
+    leakage inductances give the high-frequency roll-off.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include "FilterObjects.h"
+
+/**
+\struct WdfTransformerParameters
+\ingroup WDF-Objects
+\brief
+Turns ratio and the T-equivalent parasitics; the defaults are a small single-ended guitar-amp
+output transformer (5k : 8 ohm).
+*/
+struct WdfTransformerParameters
+{
+    double turnsRatio = 25.0;               ///< n = Np / Ns
+    double magnetizingInductance = 10.0;    ///< Lm, henries, across the primary
+    double primaryLeakage = 10.0e-3;        ///< Llp, henries
+    double secondaryLeakage = 16.0e-6;      ///< Lls, henries
+    double primaryResistance = 250.0;       ///< Rp, ohms
+    double secondaryResistance = 0.4;       ///< Rs, ohms
+
+    /** push-pull output transformer, 6.6k plate-to-plate : 8 ohm */
+    static WdfTransformerParameters pushPullOutput()
+    {
+        WdfTransformerParameters parameters;
+        parameters.turnsRatio = 28.7;
+        parameters.magnetizingInductance = 30.0;
+        parameters.primaryLeakage = 15.0e-3;
+        parameters.secondaryLeakage = 18.0e-6;
+        parameters.primaryResistance = 150.0;
+        parameters.secondaryResistance = 0.3;
+        return parameters;
+    }
+};
+
+/**
+\class WdfTransformer
+\ingroup WDF-Objects
+\brief
+A transformer to be added to a WdfRTypeAdaptor with addTransformer( ). Call reset( ) with the
+circuit's other adaptors. The resistances and leakages must not all be zero on one side.
+*/
+class WdfTransformer
+{
+public:
+    static const int numAdaptors = 3;
+
+    explicit WdfTransformer(const WdfTransformerParameters& _parameters = WdfTransformerParameters()) : parameters(_parameters)
+    {
+        seriesAdaptor_primary.setComponent(wdfComponent::seriesRL, parameters.primaryResistance, parameters.primaryLeakage);
+        seriesAdaptor_secondary.setComponent(wdfComponent::seriesRL, parameters.secondaryResistance, parameters.secondaryLeakage);
+        seriesAdaptor_magnetizing.setComponent(wdfComponent::L, parameters.magnetizingInductance);
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->setSourceResistance(0.0);
+    }
+
+    WdfTransformer(const WdfTransformer&) = delete;
+    WdfTransformer& operator=(const WdfTransformer&) = delete;
+
+    /** flush the inductors and set their port resistances for the sample rate */
+    void reset(double _sampleRate)
+    {
+        for (int i = 0; i < numAdaptors; i++)
+        {
+            adaptors[i]->reset(_sampleRate);
+            adaptors[i]->initializeAdaptorChain();
+        }
+    }
+
+    const WdfTransformerParameters& getParameters() const { return parameters; }
+
+    /** primary leakage, secondary leakage and magnetising subtrees, in that order */
+    WdfAdaptorBase* getAdaptor(int index) { return adaptors[index]; }
+
+private:
+    WdfTransformerParameters parameters;
+    WdfSeriesAdaptor seriesAdaptor_primary;
+    WdfSeriesAdaptor seriesAdaptor_secondary;
+    WdfSeriesAdaptor seriesAdaptor_magnetizing;
+
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_primary, &seriesAdaptor_secondary, &seriesAdaptor_magnetizing };
+};
@@ -0,0 +1,407 @@
+/*
+  ==============================================================================
+
+    WdfTriode.h
+    Created: 19 Oct 2026 12:21:47am
+    Author:  Richie Haynes
+
+    Triode for WdfNewtonRoot, with Koren's plate-current model
+
+        E1 = (Vpk / kp) ln(1 + e^(kp (1 / mu + Vgk / sqrt(kvb + Vpk^2))))
+        Ip = 2 E1^ex / kg1   (E1 > 0)
+
+    and a Child-Langmuir grid current Ig = Gg (Vgk - Vg0)^1.5 above the
+    onset voltage, so an overdriven grid clamps as in a real stage.
+
+    The two transcendental pieces, softplus ln(1 + e^x) and the power E1^ex,
+    are read from cubic Hermite tables held by a WdfTriodeModel, which every
+    triode of that tube type shares; the power is tabulated against sqrt(E1)
+    to keep the table smooth at the origin. Only a square root per sample
+    remains. The tables are built, and their error measured, when the model
+    is first used; the exact functions stay available for comparison.
+
+  ==============================================================================
+*/
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "WdfNewtonRoot.h"
+
+/**
+\struct WdfTriodeParameters
+\ingroup WDF-Objects
+\brief
+Koren triode parameters and a grid-current law; the defaults are a 12AX7.
+*/
+struct WdfTriodeParameters
+{
+    double mu = 100.0;          ///< amplification factor
+    double ex = 1.4;            ///< plate-current exponent
+    double kg1 = 1060.0;
+    double kp = 600.0;
+    double kvb = 300.0;         ///< V^2
+    double gridPerveance = 6.0e-4;  ///< Gg, A / V^1.5
+    double gridOnset = 0.2;     ///< Vg0, grid-cathode voltage where grid current starts
+
+    static WdfTriodeParameters twelveAX7() { return WdfTriodeParameters(); }
+
+    static WdfTriodeParameters twelveAT7()
+    {
+        WdfTriodeParameters parameters;
+        parameters.mu = 60.0;
+        parameters.ex = 1.35;
+        parameters.kg1 = 460.0;
+        parameters.kp = 300.0;
+        parameters.kvb = 300.0;
+        return parameters;
+    }
+};
+
+/**
+\class WdfTriodeModel
+\ingroup WDF-Objects
+\brief
+A tube type: its parameters and the Hermite tables of softplus and of the plate-current power.
+Build one per tube type off the audio thread and share it between triodes; it is read-only.
+*/
+class WdfTriodeModel
+{
+public:
+    static constexpr double softplusLimit = 32.0;      ///< table range [-32, 32]; ln(1 + e^x) is 0 or x outside
+    static constexpr int softplusNodesPerUnit = 16;
+    static constexpr int numSoftplusNodes = (int)(2.0 * softplusLimit * softplusNodesPerUnit) + 1;
+    static constexpr double powerRootLimit = 8.0;      ///< sqrt(E1) range [0, 8]; std::pow above
+    static constexpr int powerNodesPerUnit = 64;
+    static constexpr int numPowerNodes = (int)(powerRootLimit * powerNodesPerUnit) + 1;
+    static constexpr size_t memoryBudget = 32 * 1024;  ///< bytes
+
+    explicit WdfTriodeModel(const WdfTriodeParameters& _parameters = WdfTriodeParameters()) : parameters(_parameters)
+    {
+        const double softplusSpacing = 1.0 / softplusNodesPerUnit;
+        for (int i = 0; i < numSoftplusNodes; i++)
+        {
+            const double x = -softplusLimit + i * softplusSpacing;
+            softplusNodes[i].value = exactSoftplus(x);
+            softplusNodes[i].slope = 1.0 / (1.0 + std::exp(-x)) * softplusSpacing;
+        }
+
+        const double powerSpacing = 1.0 / powerNodesPerUnit;
+        for (int i = 0; i < numPowerNodes; i++)
+        {
+            const double r = i * powerSpacing;
+            powerNodes[i].value = std::pow(r, 2.0 * parameters.ex);
+            powerNodes[i].slope = 2.0 * parameters.ex * std::pow(r, 2.0 * parameters.ex - 1.0) * powerSpacing;
+        }
+
+        // --- the Hermite error peaks inside each interval; probe at quarter points
+        for (int i = 0; i + 1 < numSoftplusNodes; i++)
+        {
+            for (int k = 1; k < 4; k++)
+            {
+                const double x = -softplusLimit + (i + 0.25 * k) * softplusSpacing;
+                double slope;
+                softplusError = std::fmax(softplusError, std::fabs(softplus(x, slope) - exactSoftplus(x)));
+            }
+        }
+
+        for (int i = 0; i + 1 < numPowerNodes; i++)
+        {
+            for (int k = 1; k < 4; k++)
+            {
+                const double r = (i + 0.25 * k) * powerSpacing;
+                const double e = r * r;
+                const double exact = std::pow(e, parameters.ex);
+                powerError = std::fmax(powerError, std::fabs(power(e) - exact) / std::fmax(exact, 1.0));
+            }
+        }
+    }
+
+    /** the shared 12AX7; the first call builds it, so make that call off the audio thread */
+    static const WdfTriodeModel& twelveAX7()
+    {
+        static const WdfTriodeModel model(WdfTriodeParameters::twelveAX7());
+        return model;
+    }
+
+    const WdfTriodeParameters& getParameters() const { return parameters; }
+
+    /** interpolated ln(1 + e^x) and its slope */
+    double softplus(double x, double& slope) const
+    {
+        if (x <= -softplusLimit)
+        {
+            slope = 0.0;
+            return 0.0;
+        }
+        if (x >= softplusLimit)
+        {
+            slope = 1.0;
+            return x;
+        }
+
+        const double position = (x + softplusLimit) * softplusNodesPerUnit;
+        return interpolate(softplusNodes, position, (double)softplusNodesPerUnit, slope);
+    }
+
+    /** interpolated e^ex for e >= 0 */
+    double power(double e) const
+    {
+        const double r = std::sqrt(e);
+        if (r >= powerRootLimit)
+            return std::pow(e, parameters.ex);
+
+        double slope;
+        return interpolate(powerNodes, r * powerNodesPerUnit, (double)powerNodesPerUnit, slope);
+    }
+
+    static double exactSoftplus(double x) { return x > 0.0 ? x + std::log1p(std::exp(-x)) : std::log1p(std::exp(x)); }
+
+    /** largest |table - exact| of softplus found when the tables were built */
+    double getSoftplusError() const { return softplusError; }
+
+    /** largest |table - exact| / max(exact, 1) of the power found when the tables were built */
+    double getPowerError() const { return powerError; }
+
+    /** bytes of node data */
+    static constexpr size_t getMemorySize() { return sizeof(Node) * (size_t)(numSoftplusNodes + numPowerNodes); }
+
+private:
+    struct Node
+    {
+        double value;   ///< the function at the node
+        double slope;   ///< its derivative at the node times the node spacing
+    };
+
+    static_assert(sizeof(Node) * (size_t)(numSoftplusNodes + numPowerNodes) <= memoryBudget, "triode tables exceed their memory budget");
+
+    /** cubic Hermite on the interval holding position (in node units) and its slope per unit of x */
+    static double interpolate(const Node* nodes, double position, double nodesPerUnit, double& slope)
+    {
+        const int index = (int)position;
+        const double t = position - (double)index;
+        const Node& n0 = nodes[index];
+        const Node& n1 = nodes[index + 1];
+
+        const double delta = n1.value - n0.value;
+        const double c2 = 3.0 * delta - 2.0 * n0.slope - n1.slope;
+        const double c3 = n0.slope + n1.slope - 2.0 * delta;
+        slope = (n0.slope + t * (2.0 * c2 + 3.0 * t * c3)) * nodesPerUnit;
+        return n0.value + t * (n0.slope + t * (c2 + t * c3));
+    }
+
+    WdfTriodeParameters parameters;
+    Node softplusNodes[numSoftplusNodes];
+    Node powerNodes[numPowerNodes];
+    double softplusError = 0.0;
+    double powerError = 0.0;
+};
+
+/**
+\class WdfTriodeElement
+\ingroup WDF-Objects
+\brief
+Triode for WdfNewtonRoot; terminal 0 is the plate, 1 the grid and 2 the cathode. The model is
+shared, not owned.
+*/
+class WdfTriodeElement : public IWdfNonlinearElement
+{
+public:
+    explicit WdfTriodeElement(const WdfTriodeModel& _model = WdfTriodeModel::twelveAX7()) : model(&_model) {}
+
+    virtual int getNumTerminals() const { return 3; }
+
+    /** true (default): softplus and the power from the model's tables; false: std::log1p/exp/pow */
+    void setUseTables(bool _useTables) { useTables = _useTables; }
+
+    virtual void evaluate(const double* voltages, double* currents, double* jacobian)
+    {
+        const WdfTriodeParameters& p = model->getParameters();
+        const double Vpk = voltages[0] - voltages[2];
+        const double Vgk = voltages[1] - voltages[2];
+
+        // --- plate current
+        double Ip = 0.0, dIp_dVpk = 0.0, dIp_dVgk = 0.0;
+        if (Vpk > 0.0)
+        {
+            const double root = std::sqrt(p.kvb + Vpk * Vpk);
+            const double x = p.kp * (1.0 / p.mu + Vgk / root);
+
+            double softplus, sigmoid;
+            if (useTables)
+                softplus = model->softplus(x, sigmoid);
+            else
+            {
+                softplus = WdfTriodeModel::exactSoftplus(x);
+                sigmoid = 1.0 / (1.0 + std::exp(-x));
+            }
+
+            const double E1 = Vpk / p.kp * softplus;
+            if (E1 > 0.0)
+            {
+                Ip = 2.0 / p.kg1 * (useTables ? model->power(E1) : std::pow(E1, p.ex));
+
+                // --- dIp/dE1 = ex Ip / E1; E1 through both Vpk and the softplus argument
+                const double dIp_dE1 = p.ex * Ip / E1;
+                const double dE1_dVpk = softplus / p.kp - Vpk * sigmoid * Vgk * Vpk / (root * root * root);
+                const double dE1_dVgk = Vpk * sigmoid / root;
+                dIp_dVpk = dIp_dE1 * dE1_dVpk;
+                dIp_dVgk = dIp_dE1 * dE1_dVgk;
+            }
+        }
+
+        // --- grid current once the grid goes positive
+        double Ig = 0.0, dIg_dVgk = 0.0;
+        const double overdrive = Vgk - p.gridOnset;
+        if (overdrive > 0.0)
+        {
+            const double root = std::sqrt(overdrive);
+            Ig = p.gridPerveance * overdrive * root;
+            dIg_dVgk = 1.5 * p.gridPerveance * root;
+        }
+
+        currents[0] = Ip;
+        currents[1] = Ig;
+        currents[2] = -(Ip + Ig);
+
+        if (jacobian != nullptr)
+        {
+            // --- rows: plate, grid, cathode current; columns: plate, grid, cathode voltage
+            jacobian[0] = dIp_dVpk;
+            jacobian[1] = dIp_dVgk;
+            jacobian[2] = -(dIp_dVpk + dIp_dVgk);
+            jacobian[3] = 0.0;
+            jacobian[4] = dIg_dVgk;
+            jacobian[5] = -dIg_dVgk;
+            jacobian[6] = -dIp_dVpk;
+            jacobian[7] = -(dIp_dVgk + dIg_dVgk);
+            jacobian[8] = dIp_dVpk + dIp_dVgk + dIg_dVgk;
+        }
+    }
+
+private:
+    const WdfTriodeModel* model;
+    bool useTables = true;
+};
+
+/**
+\class WDFTriodeStageCircuit
+\ingroup WDF-Objects
+\brief
+Common-cathode triode stage: the input drives the grid through Rg with a 1M grid leak, the plate
+is fed from B+ through Ra, the cathode has Rk bypassed by Ck, and the plate is AC-coupled through
+Cc into a 1M load. Output is the voltage across the load, in volts; the stage inverts.
+
+The tube is solved at a WdfNewtonRoot; reset( ) runs the stage on silence for settleTime so it
+starts at its operating point rather than with the B+ step.
+*/
+class WDFTriodeStageCircuit : public IAudioSignalProcessor
+{
+public:
+    static constexpr double settleTime = 0.25;     ///< seconds
+
+    WDFTriodeStageCircuit(void) { createWDF(); }    /* C-TOR */
+    ~WDFTriodeStageCircuit(void) {}    /* D-TOR */
+
+    /** reset members to initialized state */
+    virtual bool reset(double _sampleRate)
+    {
+        // --- rest WDF components (flush state registers)
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->reset(_sampleRate);
+
+        // --- intialize every subtree into its root port
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->initializeAdaptorChain();
+        root.reset();
+
+        // --- charge the capacitors to the operating point
+        const int settleSamples = (int)(settleTime * _sampleRate);
+        for (int n = 0; n < settleSamples; n++)
+            processAudioSample(0.0);
+        root.resetStatistics();
+        return true;
+    }
+
+    virtual bool canProcessAudioFrame() { return false; }
+
+    virtual double processAudioSample(double xn)
+    {
+        // --- every subtree delivers its incident wave, then the root solves and reflects
+        seriesAdaptor_Rg.setInput1(xn);
+        seriesAdaptor_Ra.setInput1(supplyVoltage);
+        seriesAdaptor_RkCk.setInput1(0.0);
+        seriesAdaptor_Cc.setInput1(0.0);
+        root.solve();
+
+        return root.getVoltage(outputNode);
+    }
+
+    /** B+ in volts; takes effect at the next sample, settle with reset( ) */
+    void setSupplyVoltage(double _supplyVoltage) { supplyVoltage = _supplyVoltage; }
+
+    /** the triode, e.g. to switch its tables off */
+    WdfTriodeElement& getTriode() { return triode; }
+
+    /** the root, for solver settings and statistics */
+    WdfNewtonRoot& getRoot() { return root; }
+
+    /** state of every adaptor and component in the tree */
+    virtual int getNumStateRegisters() { return WdfAdaptorBase::getNumStateRegisters(adaptors, numAdaptors); }
+
+    /** snapshot the tree's registers */
+    virtual void getStateRegisters(double* registers) { WdfAdaptorBase::getStateRegisters(adaptors, numAdaptors, registers); }
+
+    /** restore a snapshot taken from an identically configured circuit */
+    virtual void setStateRegisters(const double* registers) { WdfAdaptorBase::setStateRegisters(adaptors, numAdaptors, registers); }
+
+    void createWDF()
+    {
+        double Rg_value = 68000.0;
+        double Rgrid_leak_value = 1.0e6;
+        double Ra_value = 100000.0;
+        double Rk_value = 1500.0;
+        double Ck_value = 22e-6;
+        double Cc_value = 22e-9;
+        double Rload_value = 1.0e6;
+
+        // --- subtrees: grid resistor (driven), plate resistor (B+), bypassed cathode, coupling cap
+        seriesAdaptor_Rg.setComponent(wdfComponent::R, Rg_value);
+        seriesAdaptor_Ra.setComponent(wdfComponent::R, Ra_value);
+        seriesAdaptor_RkCk.setComponent(wdfComponent::parallelRC, Rk_value, Ck_value);
+        seriesAdaptor_Cc.setComponent(wdfComponent::C, Cc_value);
+        for (int i = 0; i < numAdaptors; i++)
+            adaptors[i]->setSourceResistance(0.0);
+
+        // --- nodes: 0 plate, 1 grid, 2 cathode, 3 output; the series adaptors' port 2 is
+        //     inverted, so the driven ports run from ground to their node
+        root.clear();
+        root.setNumNodes(4);
+        root.addPort(&seriesAdaptor_Rg, -1, 1);
+        root.addPort(&seriesAdaptor_Ra, -1, 0);
+        root.addPort(&seriesAdaptor_RkCk, -1, 2);
+        root.addPort(&seriesAdaptor_Cc, 0, outputNode);
+        root.addResistor(1, -1, Rgrid_leak_value);
+        root.addResistor(outputNode, -1, Rload_value);
+
+        const int nodes[] = { 0, 1, 2 };
+        root.addElement(&triode, nodes);
+    }
+
+protected:
+    static const int outputNode = 3;
+    double supplyVoltage = 250.0;
+
+    WdfSeriesAdaptor seriesAdaptor_Rg;
+    WdfSeriesAdaptor seriesAdaptor_Ra;
+    WdfSeriesAdaptor seriesAdaptor_RkCk;
+    WdfSeriesAdaptor seriesAdaptor_Cc;
+    WdfTriodeElement triode;
+    WdfNewtonRoot root;
+
+    static const int numAdaptors = 4;
+    WdfAdaptorBase* adaptors[numAdaptors] = { &seriesAdaptor_Rg, &seriesAdaptor_Ra, &seriesAdaptor_RkCk, &seriesAdaptor_Cc };
+    static constexpr const char* adaptorNames[numAdaptors] = { "seriesAdaptor_Rg", "seriesAdaptor_Ra", "seriesAdaptor_RkCk", "seriesAdaptor_Cc" };   ///< for profiling reports
+};
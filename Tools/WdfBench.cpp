@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    WdfBench.cpp
+    Created: 18 Oct 2026 9:52:06pm
+    Author:  Richie Haynes
+
+    Throughput of the plug-in's circuit chain with a signal and over a long
+    decaying tail. After a noise burst the chain runs on silence and is
+    timed in short windows, alongside a count of state registers that have
+    gone denormal, so the cost of a tail decaying into the denormal range is
+    visible window by window. Nothing sets FTZ/DAZ unless --ftz is given,
+    as in the command-line tools or a host without ScopedNoDenormals;
+    compare builds with -DWDF_DENORMAL_POLICY=0, 1 and 2, e.g.
+
+        c++ -std=c++17 -O2 -ISource Tools/WdfBench.cpp -o wdfbench
+        c++ -std=c++17 -O2 -ISource -DWDF_DENORMAL_POLICY=0 Tools/WdfBench.cpp -o wdfbench-none
+
+    usage: wdfbench [--seconds s] [--window s] [--rate hz] [--tone ohms]
+                    [--volume ohms] [--ftz]
+
+  ==============================================================================
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(__SSE__) || defined(_M_X64)
+ #include <xmmintrin.h>
+ #define WDF_BENCH_HAS_MXCSR 1
+#else
+ #define WDF_BENCH_HAS_MXCSR 0
+#endif
+
+#include "FilterObjects.h"
+
+static int usage()
+{
+    std::fprintf(stderr, "usage: wdfbench [--seconds s] [--window s] [--rate hz] [--tone ohms] [--volume ohms] [--ftz]\n");
+    return 2;
+}
+
+/**
+\class BenchChain
+\brief
+The plug-in's pre-gain and post-gain circuits in series, one channel.
+*/
+class BenchChain
+{
+public:
+    BenchChain(double sampleRate, double tone, double volume)
+    {
+        preGain.reset(sampleRate);
+        postGain.setTone(tone);
+        postGain.setVolume(volume);
+        postGain.createWDF();
+        postGain.reset(sampleRate);
+        registers.resize((size_t)(preGain.getNumStateRegisters() + postGain.getNumStateRegisters()));
+    }
+
+    double process(double xn) { return postGain.processAudioSample(preGain.processAudioSample(xn)); }
+
+    /** state registers that currently hold a subnormal value */
+    int countDenormalRegisters()
+    {
+        preGain.getStateRegisters(registers.data());
+        postGain.getStateRegisters(registers.data() + preGain.getNumStateRegisters());
+
+        int count = 0;
+        for (double value : registers)
+            count += std::fpclassify(value) == FP_SUBNORMAL ? 1 : 0;
+        return count;
+    }
+
+private:
+    WDFPreGainDistortionCircuit preGain;
+    WDFPostGainDistortionCircuit postGain;
+    std::vector<double> registers;
+};
+
+/** nanoseconds per sample over numSamples of input */
+template <typename Input>
+static double timeRun(BenchChain& chain, long numSamples, Input input, double& sink)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < numSamples; i++)
+        sink += chain.process(input());
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 1.0e9 * elapsed / (double)numSamples;
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 20.0;
+    double windowSeconds = 0.5;
+    double sampleRate = 48000.0;
+    double tone = 5000.0;
+    double volume = 10000.0;
+    bool ftz = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--seconds" && hasValue)
+            seconds = std::atof(argv[++i]);
+        else if (arg == "--window" && hasValue)
+            windowSeconds = std::atof(argv[++i]);
+        else if (arg == "--rate" && hasValue)
+            sampleRate = std::atof(argv[++i]);
+        else if (arg == "--tone" && hasValue)
+            tone = std::atof(argv[++i]);
+        else if (arg == "--volume" && hasValue)
+            volume = std::atof(argv[++i]);
+        else if (arg == "--ftz")
+            ftz = true;
+        else
+            return usage();
+    }
+
+    if (seconds <= 0.0 || windowSeconds <= 0.0 || sampleRate <= 0.0)
+        return usage();
+
+    if (ftz)
+    {
+#if WDF_BENCH_HAS_MXCSR
+        _mm_setcsr(_mm_getcsr() | 0x8040);     // flush-to-zero and denormals-are-zero
+#else
+        std::fprintf(stderr, "wdfbench: --ftz is only supported on x86\n");
+        return 1;
+#endif
+    }
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> noise(-0.5, 0.5);
+    auto noiseInput = [&] { return noise(generator); };
+    auto silentInput = [] { return 0.0; };
+    double sink = 0.0;
+
+    const long windowSamples = std::max(1L, (long)(windowSeconds * sampleRate));
+    const int numWindows = std::max(1, (int)(seconds / windowSeconds));
+
+    std::printf("WDF_DENORMAL_POLICY %d, FTZ/DAZ %s, %g Hz\n\n", WDF_DENORMAL_POLICY, ftz ? "on" : "off", sampleRate);
+
+    // --- steady state with signal: the reference cost
+    BenchChain chain(sampleRate, tone, volume);
+    const double signalCost = timeRun(chain, numWindows * windowSamples, noiseInput, sink);
+    std::printf("signal          %8.2f ns/sample\n\n", signalCost);
+
+    // --- decaying tail: a fresh chain, a burst, then silence timed window by window
+    BenchChain tailChain(sampleRate, tone, volume);
+    timeRun(tailChain, (long)(0.1 * sampleRate), noiseInput, sink);
+
+    std::printf("tail from (s)   ns/sample   denormal registers\n");
+    double tailSum = 0.0;
+    double tailMax = 0.0;
+    for (int window = 0; window < numWindows; window++)
+    {
+        const double cost = timeRun(tailChain, windowSamples, silentInput, sink);
+        tailSum += cost;
+        tailMax = std::max(tailMax, cost);
+        std::printf("%12.2f %11.2f %12d\n", window * windowSeconds, cost, tailChain.countDenormalRegisters());
+    }
+
+    std::printf("\ndecaying tail   %8.2f ns/sample mean, %.2f worst window (%.1fx signal)\n",
+                tailSum / numWindows, tailMax, tailMax / signalCost);
+    std::printf("(output sum %g)\n", sink);
+    return 0;
+}
@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+    WdfHysteresisBench.cpp
+    Created: 19 Oct 2026 3:41:18am
+    Author:  Richie Haynes
+
+    Per-sample cost of the Jiles-Atherton hysteretic inductor, oversampled.
+    WDFHysteresisInductorCircuit is run on a 100 Hz tone at the oversampled
+    rate for each solver (RK2, RK4) with the exact and the fast Langevin
+    function, and the cost is reported per base-rate sample, best of
+    --repeats runs. The largest difference between the two Langevin
+    functions is printed first. Two channels are then run through two
+    WDFHysteresisInductorCircuit objects and through one
+    WDFStereoHysteresisInductorCircuit, which steps both cores in one
+    call, and the cost per channel and the gain are printed. Last, the
+    core's step( ) is timed alone over 1, 2, 4 and 8 lanes, e.g.
+
+        c++ -std=c++17 -O2 -ISource Tools/WdfHysteresisBench.cpp -o wdfhysteresisbench
+        ./wdfhysteresisbench --oversample 2
+
+    usage: wdfhysteresisbench [--seconds s] [--rate hz] [--oversample n] [--drive dB]
+                              [--corrections n] [--repeats n]
+
+  ==============================================================================
+*/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "WdfHysteresis.h"
+
+static int usage()
+{
+    std::fprintf(stderr, "usage: wdfhysteresisbench [--seconds s] [--rate hz] [--oversample n] [--drive dB] [--corrections n] [--repeats n]\n");
+    return 2;
+}
+
+/** nanoseconds per base-rate sample of the circuit */
+static double timeCircuit(WdfJilesAtherton::Solver solver, bool fastLangevin, double seconds, double sampleRate,
+                          int oversample, double drive, int corrections, double& sink)
+{
+    WDFHysteresisInductorCircuit circuit;
+    circuit.getInductor().getCore().setSolver(solver);
+    circuit.getInductor().getCore().setFastLangevin(fastLangevin);
+    circuit.getInductor().setCorrections(corrections);
+    circuit.setDrive(drive);
+
+    const double circuitRate = sampleRate * oversample;
+    circuit.reset(circuitRate);
+
+    const long numSamples = (long)(seconds * sampleRate);
+    const double phaseStep = 2.0 * 3.14159265358979323846 * 100.0 / circuitRate;
+
+    const auto start = std::chrono::steady_clock::now();
+    long n = 0;
+    for (long i = 0; i < numSamples; i++)
+        for (int k = 0; k < oversample; k++, n++)
+            sink += circuit.processAudioSample(std::sin(phaseStep * (double)n));
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 1.0e9 * elapsed / (double)numSamples;
+}
+
+/** nanoseconds per base-rate sample for two channels: two mono circuits, or one stereo circuit */
+static double timeStereo(bool stereo, WdfJilesAtherton::Solver solver, bool fastLangevin, double seconds, double sampleRate,
+                         int oversample, double drive, int corrections, double& sink)
+{
+    WDFHysteresisInductorCircuit left, right;
+    WDFStereoHysteresisInductorCircuit both;
+    WdfJilesAtherton* cores[] = { &left.getInductor().getCore(), &right.getInductor().getCore(), &both.getInductor().getCore() };
+    for (WdfJilesAtherton* core : cores)
+    {
+        core->setSolver(solver);
+        core->setFastLangevin(fastLangevin);
+    }
+    left.getInductor().setCorrections(corrections);
+    right.getInductor().setCorrections(corrections);
+    both.getInductor().setCorrections(corrections);
+    left.setDrive(drive);
+    right.setDrive(drive);
+    both.setDrive(drive);
+
+    const double circuitRate = sampleRate * oversample;
+    left.reset(circuitRate);
+    right.reset(circuitRate);
+    both.reset(circuitRate);
+
+    const long numSamples = (long)(seconds * sampleRate);
+    const double phaseStep = 2.0 * 3.14159265358979323846 * 100.0 / circuitRate;
+
+    // --- the right channel is a quieter 150 Hz tone, so the two cores follow different loops
+    const auto start = std::chrono::steady_clock::now();
+    long n = 0;
+    for (long i = 0; i < numSamples; i++)
+    {
+        for (int k = 0; k < oversample; k++, n++)
+        {
+            const float input[2] = { (float)std::sin(phaseStep * (double)n), (float)(0.5 * std::sin(1.5 * phaseStep * (double)n)) };
+            float output[2];
+            if (stereo)
+                both.processAudioFrame(input, output, 2, 2);
+            else
+            {
+                output[0] = (float)left.processAudioSample(input[0]);
+                output[1] = (float)right.processAudioSample(input[1]);
+            }
+            sink += output[0] + output[1];
+        }
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return 1.0e9 * elapsed / (double)numSamples;
+}
+
+/** largest |fast - exact| of L and of L' over a dense grid and far out */
+static void compareLangevin(double& maxError, double& maxDerivativeError)
+{
+    maxError = maxDerivativeError = 0.0;
+    for (double x = -60.0; x <= 1.0e6; x = x < 60.0 ? x + 1.0e-4 : x * 1.001)
+    {
+        double exactDerivative, fastDerivative;
+        const double exact = WdfLangevin::exact(x, exactDerivative);
+        const double fast = WdfLangevin::fast(x, fastDerivative);
+        maxError = std::max(maxError, std::fabs(fast - exact));
+        maxDerivativeError = std::max(maxDerivativeError, std::fabs(fastDerivative - exactDerivative));
+    }
+}
+
+/** nanoseconds per lane per step( ) */
+template <int numLanes>
+static double timeLanes(const WdfJilesAtherton& core, long numSteps, double& sink)
+{
+    double H[numLanes], M[numLanes] = {};
+    for (int lane = 0; lane < numLanes; lane++)
+        H[lane] = 0.0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long n = 0; n < numSteps; n++)
+    {
+        double next[numLanes];
+        for (int lane = 0; lane < numLanes; lane++)
+            next[lane] = 4000.0 * std::sin(1.0e-3 * (double)n + 0.1 * lane);
+        core.step<numLanes>(H, next, M);
+        for (int lane = 0; lane < numLanes; lane++)
+            H[lane] = next[lane];
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (int lane = 0; lane < numLanes; lane++)
+        sink += M[lane];
+    return 1.0e9 * elapsed / ((double)numSteps * numLanes);
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 5.0;
+    double sampleRate = 48000.0;
+    int oversample = 2;
+    double drive = 20.0;
+    int corrections = 1;
+    int repeats = 3;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--seconds" && hasValue)
+            seconds = std::atof(argv[++i]);
+        else if (arg == "--rate" && hasValue)
+            sampleRate = std::atof(argv[++i]);
+        else if (arg == "--oversample" && hasValue)
+            oversample = std::atoi(argv[++i]);
+        else if (arg == "--drive" && hasValue)
+            drive = std::atof(argv[++i]);
+        else if (arg == "--corrections" && hasValue)
+            corrections = std::atoi(argv[++i]);
+        else if (arg == "--repeats" && hasValue)
+            repeats = std::atoi(argv[++i]);
+        else
+            return usage();
+    }
+
+    if (seconds <= 0.0 || sampleRate <= 0.0 || oversample < 1 || corrections < 0 || repeats < 1)
+        return usage();
+
+    double maxError, maxDerivativeError;
+    compareLangevin(maxError, maxDerivativeError);
+    std::printf("fast Langevin: max |error| %.2g in L, %.2g in L'\n\n", maxError, maxDerivativeError);
+
+    double sink = 0.0;
+    const double period = 1.0e9 / sampleRate;
+    std::printf("hysteretic inductor at %g Hz (%dx), drive %g dB, %d correction(s), best of %d\n\n", sampleRate * oversample, oversample, drive,
+                corrections, repeats);
+    std::printf("solver  Langevin   ns per %g Hz sample   %% of real time\n", sampleRate);
+
+    const WdfJilesAtherton::Solver solvers[] = { WdfJilesAtherton::Solver::rk2, WdfJilesAtherton::Solver::rk4 };
+    for (WdfJilesAtherton::Solver solver : solvers)
+    {
+        for (int fast = 0; fast < 2; fast++)
+        {
+            double cost = timeCircuit(solver, fast != 0, seconds, sampleRate, oversample, drive, corrections, sink);
+            for (int repeat = 1; repeat < repeats; repeat++)
+                cost = std::min(cost, timeCircuit(solver, fast != 0, seconds, sampleRate, oversample, drive, corrections, sink));
+            std::printf("%-7s %-8s %22.1f %16.2f\n", solver == WdfJilesAtherton::Solver::rk4 ? "RK4" : "RK2",
+                        fast ? "fast" : "exact", cost, 100.0 * cost / period);
+        }
+    }
+
+    // --- two channels: one root per channel against both lanes in one root
+    std::printf("\nstereo  Langevin   ns per channel: 2 mono   stereo   gain\n");
+    for (WdfJilesAtherton::Solver solver : solvers)
+    {
+        for (int fast = 0; fast < 2; fast++)
+        {
+            double mono = 1.0e300, stereo = 1.0e300;
+            for (int repeat = 0; repeat < repeats; repeat++)
+            {
+                mono = std::min(mono, timeStereo(false, solver, fast != 0, seconds, sampleRate, oversample, drive, corrections, sink));
+                stereo = std::min(stereo, timeStereo(true, solver, fast != 0, seconds, sampleRate, oversample, drive, corrections, sink));
+            }
+            std::printf("%-7s %-8s %22.1f %8.1f %5.0f%%\n", solver == WdfJilesAtherton::Solver::rk4 ? "RK4" : "RK2",
+                        fast ? "fast" : "exact", 0.5 * mono, 0.5 * stereo, 100.0 * (mono - stereo) / mono);
+        }
+    }
+
+    // --- the core alone, several channels per call
+    WdfJilesAtherton exact, fast;
+    exact.setFastLangevin(false);
+    fast.setFastLangevin(true);
+    const long numSteps = (long)(seconds * sampleRate);
+    std::printf("\nRK2 step, ns per lane   exact   fast\n");
+    std::printf("1 lane  %24.2f %6.2f\n", timeLanes<1>(exact, numSteps, sink), timeLanes<1>(fast, numSteps, sink));
+    std::printf("2 lanes %24.2f %6.2f\n", timeLanes<2>(exact, numSteps, sink), timeLanes<2>(fast, numSteps, sink));
+    std::printf("4 lanes %24.2f %6.2f\n", timeLanes<4>(exact, numSteps, sink), timeLanes<4>(fast, numSteps, sink));
+    std::printf("8 lanes %24.2f %6.2f\n", timeLanes<8>(exact, numSteps, sink), timeLanes<8>(fast, numSteps, sink));
+
+    std::printf("(output sum %g)\n", sink);
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    WdfProfile.cpp
+    Created: 18 Oct 2026 8:58:12pm
+    Author:  Richie Haynes
+
+    Per-node profile of the plug-in's circuit chain. Runs noise through
+    profiled copies of the pre-gain and post-gain circuits and prints a
+    self-time table per circuit; with --collapsed the calling contexts are
+    written as collapsed stacks for a flame graph, e.g.
+
+        c++ -std=c++17 -O2 -ISource Tools/WdfProfile.cpp -o wdfprofile
+        ./wdfprofile --collapsed wdf.folded && flamegraph.pl wdf.folded > wdf.svg
+
+    usage: wdfprofile [--seconds s] [--rate hz] [--tone ohms] [--volume ohms]
+                      [--cycles] [--collapsed file]
+
+  ==============================================================================
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+
+#include "WdfProfiler.h"
+
+static int usage()
+{
+    std::fprintf(stderr, "usage: wdfprofile [--seconds s] [--rate hz] [--tone ohms] [--volume ohms] [--cycles] [--collapsed file]\n");
+    return 2;
+}
+
+template <typename Policy>
+static int profile(double seconds, double sampleRate, double tone, double volume, const std::string& collapsedPath)
+{
+    WdfProfiledCircuit<WDFPreGainDistortionCircuit, Policy> preGain("preGain");
+    WdfProfiledCircuit<WDFPostGainDistortionCircuit, Policy> postGain("postGain");
+
+    preGain.reset(sampleRate);
+    postGain.setTone(tone);
+    postGain.setVolume(volume);
+    postGain.createWDF();
+    postGain.reset(sampleRate);
+
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<double> noise(-0.5, 0.5);
+    const long numSamples = (long)(seconds * sampleRate);
+    double sink = 0.0;
+
+    for (long i = 0; i < numSamples; i++)
+        sink += postGain.processAudioSample(preGain.processAudioSample(noise(generator)));
+
+    std::printf("%ld samples (output sum %g)\n\npre-gain\n%s\npost-gain\n%s", numSamples, sink,
+                preGain.getProfiler().getReport().c_str(), postGain.getProfiler().getReport().c_str());
+
+    if (!collapsedPath.empty())
+    {
+        std::ofstream collapsed(collapsedPath);
+        preGain.getProfiler().writeCollapsedStacks(collapsed);
+        postGain.getProfiler().writeCollapsedStacks(collapsed);
+        if (!collapsed)
+        {
+            std::fprintf(stderr, "wdfprofile: cannot write %s\n", collapsedPath.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 10.0;
+    double sampleRate = 48000.0;
+    double tone = 5000.0;
+    double volume = 10000.0;
+    bool cycles = false;
+    std::string collapsedPath;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--seconds" && hasValue)
+            seconds = std::atof(argv[++i]);
+        else if (arg == "--rate" && hasValue)
+            sampleRate = std::atof(argv[++i]);
+        else if (arg == "--tone" && hasValue)
+            tone = std::atof(argv[++i]);
+        else if (arg == "--volume" && hasValue)
+            volume = std::atof(argv[++i]);
+        else if (arg == "--collapsed" && hasValue)
+            collapsedPath = argv[++i];
+        else if (arg == "--cycles")
+            cycles = true;
+        else
+            return usage();
+    }
+
+    if (cycles)
+    {
+#if WDF_PROFILER_HAS_CYCLE_COUNTER
+        return profile<WdfCycleCountProfiling>(seconds, sampleRate, tone, volume, collapsedPath);
+#else
+        std::fprintf(stderr, "wdfprofile: no cycle counter on this architecture\n");
+        return 1;
+#endif
+    }
+
+    return profile<WdfSteadyClockProfiling>(seconds, sampleRate, tone, volume, collapsedPath);
+}
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    WdfRealtimeCheck.cpp
+    Created: 19 Oct 2026 9:40:12am
+    Author:  Richie Haynes
+
+    Real-time safety check of every WDF circuit in the tree. Each circuit is
+    constructed and configured outside the guard, then reset and run over a
+    block of noise inside WDF_REALTIME_SECTION, the way a host's
+    prepareToPlay/processBlock would drive it after a silence flush. Any
+    allocation, lock, sleep or file call is reported with the circuit's name
+    and the tool exits with status 1; status 0 means every circuit was clean.
+    It only builds with the checks on:
+
+        c++ -std=c++17 -O2 -DWDF_REALTIME_CHECKS=1 -ISource Tools/WdfRealtimeCheck.cpp \
+            Source/RealtimeGuard.cpp -ldl -o wdfrealtimecheck
+        ./wdfrealtimecheck
+
+    usage: wdfrealtimecheck [--samples n] [--rate hz] [--backtrace]
+
+  ==============================================================================
+*/
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include "RealtimeGuard.h"
+
+#if ! WDF_REALTIME_CHECKS
+ #error "build with -DWDF_REALTIME_CHECKS=1 and link Source/RealtimeGuard.cpp"
+#endif
+
+#include "FilterObjects.h"
+#include "WdfDiode.h"
+#include "WdfHysteresis.h"
+#include "WdfNewtonRoot.h"
+#include "WdfRTypeAdaptor.h"
+#include "WdfTriode.h"
+
+namespace
+{
+    const char* currentCircuit = "";
+    bool printBacktraces = false;
+    int numViolations = 0;
+
+    /** record and carry on, so one run lists every offending call */
+    void onViolation(RealtimeGuard::Violation violation, const char* call)
+    {
+        numViolations++;
+        if (printBacktraces)
+        {
+            RealtimeGuard::printReport(violation, call);
+            return;
+        }
+        std::fprintf(stderr, "  %s: %s (%s)\n", currentCircuit, RealtimeGuard::getName(violation), call);
+    }
+}
+
+static int usage()
+{
+    std::fprintf(stderr, "usage: wdfrealtimecheck [--samples n] [--rate hz] [--backtrace]\n");
+    return 2;
+}
+
+/** reset and run one configured circuit inside a real-time section; true if it was clean */
+static bool check(const char* name, IAudioSignalProcessor& circuit, const float* input, int numSamples, double sampleRate)
+{
+    currentCircuit = name;
+    const int before = numViolations;
+    double sum = 0.0;
+
+    {
+        WDF_REALTIME_SECTION (name);
+        circuit.reset(sampleRate);
+        for (int i = 0; i < numSamples; i++)
+            sum += circuit.processAudioSample(input[i]);
+    }
+
+    const int found = numViolations - before;
+    std::printf("%-28s %s  (output sum %.6g)\n", name, found == 0 ? "ok" : "FAILED", sum);
+    return found == 0;
+}
+
+int main(int argc, char** argv)
+{
+    int numSamples = 4096;
+    double sampleRate = 48000.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--samples" && hasValue)
+            numSamples = std::atoi(argv[++i]);
+        else if (arg == "--rate" && hasValue)
+            sampleRate = std::atof(argv[++i]);
+        else if (arg == "--backtrace")
+            printBacktraces = true;
+        else
+            return usage();
+    }
+
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return usage();
+
+    // --- input and circuits are allocated here, before any section opens
+    std::vector<float> input((size_t)numSamples);
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    for (float& sample : input)
+        sample = noise(random);
+
+    WDFPreGainDistortionCircuit preGain;
+    WDFPreGainDistortionCircuit preGainPickup;
+    preGainPickup.setPickup(WdfPickupParameters());
+    WDFPostGainDistortionCircuit postGain;
+    WDFPostGainDistortionCircuit postGainSpeaker;
+    postGainSpeaker.setSpeaker(WdfSpeakerParameters());
+    WDFDiodeClipperCircuit diodeClipper;
+    WDFCascadedClipperCircuit cascadedClipper;
+    WDFBridgedTCircuit bridgedT;
+    WDFOpAmpGainStageCircuit opAmpGainStage;
+    WDFOutputTransformerCircuit outputTransformer;
+    WDFTriodeStageCircuit triodeStage;
+    WDFHysteresisInductorCircuit hysteresisInductor;
+    WDFStereoHysteresisInductorCircuit stereoHysteresisInductor;
+
+    struct Entry { const char* name; IAudioSignalProcessor* circuit; };
+    const Entry circuits[] =
+    {
+        { "preGain",            &preGain },
+        { "preGain + pickup",   &preGainPickup },
+        { "postGain",           &postGain },
+        { "postGain + speaker", &postGainSpeaker },
+        { "diodeClipper",       &diodeClipper },
+        { "cascadedClipper",    &cascadedClipper },
+        { "bridgedT",           &bridgedT },
+        { "opAmpGainStage",     &opAmpGainStage },
+        { "outputTransformer",  &outputTransformer },
+        { "triodeStage",        &triodeStage },
+        { "hysteresisInductor", &hysteresisInductor },
+        { "stereoHysteresisInductor", &stereoHysteresisInductor }
+    };
+
+    RealtimeGuard::setHandler(onViolation);
+
+    int numFailed = 0;
+    for (const Entry& entry : circuits)
+    {
+        if (!check(entry.name, *entry.circuit, input.data(), numSamples, sampleRate))
+            numFailed++;
+    }
+
+    RealtimeGuard::setHandler(nullptr);
+
+    if (numFailed > 0)
+    {
+        std::printf("%d of %d circuits made %d real-time violations\n", numFailed, (int)(sizeof(circuits) / sizeof(circuits[0])), numViolations);
+        return 1;
+    }
+
+    std::printf("all %d circuits real-time safe\n", (int)(sizeof(circuits) / sizeof(circuits[0])));
+    return 0;
+}
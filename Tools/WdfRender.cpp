@@ -0,0 +1,264 @@
+/*
+  ==============================================================================
+
+    WdfRender.cpp
+    Created: 18 Oct 2026 10:05:17am
+    Author:  Richie Haynes
+
+    Command line renderer: runs the plug-in's WDF circuit chain over a WAV file
+    without a host. Plain C++ (no JUCE), build with e.g.
+
+        c++ -std=c++17 -O2 -pthread -ISource Tools/WdfRender.cpp -o wdfrender
+
+    usage: wdfrender [--tone ohms] [--volume ohms] [--block frames]
+                     [--bits 16|24|32|float] [--checkpoint file [--checkpoint-every seconds]]
+                     [--resume] [--from seconds] [--to seconds] input.wav output.wav
+
+    With --checkpoint the circuit state is saved periodically; after a crash, rerun
+    the same command with --resume to continue from the last checkpoint.
+
+    --from/--to render one chunk into a full-length output shared by several
+    concurrent invocations, e.g. one per core; each chunk pre-rolls the circuit
+    tail so the joins match a single render to within -120 dB.
+
+    service mode (keeps circuits built between jobs):
+           wdfrender --serve socket [--workers n]
+           wdfrender --submit socket [--priority p] [--wait] [render options] input.wav output.wav
+           wdfrender --stats socket
+           wdfrender --shutdown socket
+
+  ==============================================================================
+*/
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "RenderService.h"
+
+static int usage()
+{
+    std::fprintf(stderr, "usage: wdfrender [--tone ohms] [--volume ohms] [--block frames] "
+                         "[--bits 16|24|32|float] [--checkpoint file [--checkpoint-every seconds]] [--resume] "
+                         "[--from seconds] [--to seconds] input.wav output.wav\n"
+                         "       wdfrender --serve socket [--workers n]\n"
+                         "       wdfrender --submit socket [--priority p] [--wait] [options] input.wav output.wav\n"
+                         "       wdfrender --stats socket | --shutdown socket\n");
+    return 2;
+}
+
+/** send one request to a running service and print the reply fields */
+static int sendRequest(const std::string& socketPath, RenderProtocol::MessageType type, const RenderProtocol::Fields& fields)
+{
+    int fd = RenderProtocol::connectTo(socketPath);
+    if (fd < 0)
+    {
+        std::fprintf(stderr, "wdfrender: cannot connect to %s\n", socketPath.c_str());
+        return 1;
+    }
+
+    RenderProtocol::MessageType replyType;
+    RenderProtocol::Fields reply;
+    bool received = RenderProtocol::writeMessage(fd, type, fields) && RenderProtocol::readMessage(fd, replyType, reply);
+    ::close(fd);
+
+    if (!received)
+    {
+        std::fprintf(stderr, "wdfrender: no reply from %s\n", socketPath.c_str());
+        return 1;
+    }
+
+    for (auto& field : reply)
+        std::printf("%s=%s\n", field.first.c_str(), field.second.c_str());
+
+    return replyType == RenderProtocol::replyOk ? 0 : 1;
+}
+
+/** make a relative path absolute so the service resolves it like the caller would */
+static std::string absolutePath(const std::string& path)
+{
+    char resolved[PATH_MAX];
+    if (path.empty() || path[0] == '/' || getcwd(resolved, sizeof(resolved)) == nullptr)
+        return path;
+
+    return std::string(resolved) + "/" + path;
+}
+
+int main(int argc, char* argv[])
+{
+    double tone = 5000.0;
+    double volume = 10000.0;
+    int blockSize = 4096;
+    std::string bits = "float";
+    std::string inputPath, outputPath;
+    std::string serveSocket, submitSocket, statsSocket, shutdownSocket;
+    int numWorkers = 2;
+    int priority = 0;
+    bool wait = false;
+    std::string checkpointPath;
+    double checkpointSeconds = 10.0;
+    bool resume = false;
+    double fromSeconds = -1.0;
+    double toSeconds = -1.0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--tone" && hasValue)
+            tone = std::atof(argv[++i]);
+        else if (arg == "--volume" && hasValue)
+            volume = std::atof(argv[++i]);
+        else if (arg == "--block" && hasValue)
+            blockSize = std::atoi(argv[++i]);
+        else if (arg == "--bits" && hasValue)
+            bits = argv[++i];
+        else if (arg == "--serve" && hasValue)
+            serveSocket = argv[++i];
+        else if (arg == "--workers" && hasValue)
+            numWorkers = std::atoi(argv[++i]);
+        else if (arg == "--submit" && hasValue)
+            submitSocket = argv[++i];
+        else if (arg == "--priority" && hasValue)
+            priority = std::atoi(argv[++i]);
+        else if (arg == "--wait")
+            wait = true;
+        else if (arg == "--stats" && hasValue)
+            statsSocket = argv[++i];
+        else if (arg == "--shutdown" && hasValue)
+            shutdownSocket = argv[++i];
+        else if (arg == "--checkpoint" && hasValue)
+            checkpointPath = argv[++i];
+        else if (arg == "--checkpoint-every" && hasValue)
+            checkpointSeconds = std::atof(argv[++i]);
+        else if (arg == "--resume")
+            resume = true;
+        else if (arg == "--from" && hasValue)
+            fromSeconds = std::atof(argv[++i]);
+        else if (arg == "--to" && hasValue)
+            toSeconds = std::atof(argv[++i]);
+        else if (inputPath.empty())
+            inputPath = arg;
+        else if (outputPath.empty())
+            outputPath = arg;
+        else
+            return usage();
+    }
+
+    std::signal(SIGPIPE, SIG_IGN);
+
+    if (!serveSocket.empty())
+    {
+        if (numWorkers <= 0)
+            return usage();
+
+        RenderService service;
+        service.start(numWorkers);
+
+        std::string error;
+        if (!service.serve(serveSocket, error))
+        {
+            std::fprintf(stderr, "wdfrender: %s\n", error.c_str());
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!statsSocket.empty())
+        return sendRequest(statsSocket, RenderProtocol::getStats, {});
+
+    if (!shutdownSocket.empty())
+        return sendRequest(shutdownSocket, RenderProtocol::shutdown, {});
+
+    if (inputPath.empty() || outputPath.empty() || blockSize <= 0)
+        return usage();
+
+    if (!submitSocket.empty())
+        return sendRequest(submitSocket, RenderProtocol::submitJob,
+                           { { "input", absolutePath(inputPath) }, { "output", absolutePath(outputPath) },
+                             { "tone", std::to_string(tone) }, { "volume", std::to_string(volume) },
+                             { "priority", std::to_string(priority) }, { "bits", bits },
+                             { "wait", wait ? "1" : "0" } });
+
+    std::string error;
+    MappedWavReader input;
+    if (!input.open(inputPath, error))
+    {
+        std::fprintf(stderr, "wdfrender: %s\n", error.c_str());
+        return 1;
+    }
+
+    const bool asFloat = bits == "float";
+    const int bitsPerSample = asFloat ? 32 : std::atoi(bits.c_str());
+
+    // --- one chunk of a split render
+    if (fromSeconds >= 0.0 || toSeconds >= 0.0)
+    {
+        const uint64_t totalFrames = input.getNumFrames();
+        uint64_t firstFrame = std::min<uint64_t>(totalFrames, (uint64_t)(std::max(fromSeconds, 0.0) * input.getSampleRate()));
+        uint64_t endFrame = toSeconds >= 0.0 ? std::min<uint64_t>(totalFrames, (uint64_t)(toSeconds * input.getSampleRate())) : totalFrames;
+
+        MappedWavWriter output;
+        if (endFrame <= firstFrame || !output.openShared(outputPath, input.getNumChannels(), input.getSampleRate(),
+                                                         bitsPerSample, asFloat, totalFrames, error))
+        {
+            std::fprintf(stderr, "wdfrender: %s\n", endFrame <= firstFrame ? "empty range" : error.c_str());
+            return 1;
+        }
+
+        OfflineRenderer renderer;
+        renderer.setParameters(tone, volume);
+        renderer.setBlockSize(blockSize);
+        renderer.renderRange(input, output, firstFrame, endFrame - firstFrame);
+        output.close();
+        return 0;
+    }
+
+    // --- pick up an interrupted render if there is a checkpoint for this input
+    CircuitCheckpoint checkpoint;
+    bool resuming = resume && !checkpointPath.empty() && checkpoint.load(checkpointPath, error);
+    if (resuming && (checkpoint.totalFrames != input.getNumFrames() || checkpoint.sampleRate != input.getSampleRate()))
+    {
+        std::fprintf(stderr, "wdfrender: checkpoint %s belongs to a different input\n", checkpointPath.c_str());
+        return 1;
+    }
+
+    MappedWavWriter output;
+    bool opened = resuming ? output.openExisting(outputPath, input.getNumChannels(), input.getSampleRate(), bitsPerSample,
+                                                 asFloat, input.getNumFrames(), error)
+                           : output.create(outputPath, input.getNumChannels(), input.getSampleRate(), bitsPerSample,
+                                           asFloat, input.getNumFrames(), error);
+    if (!opened)
+    {
+        std::fprintf(stderr, "wdfrender: %s\n", error.c_str());
+        return 1;
+    }
+
+    OfflineRenderer renderer;
+    renderer.setParameters(tone, volume);
+    renderer.setBlockSize(blockSize);
+    if (!checkpointPath.empty())
+        renderer.setCheckpoint(checkpointPath, (uint64_t)(checkpointSeconds * input.getSampleRate()));
+
+    if (resuming)
+        std::printf("resuming at %.1f s\n", (double)checkpoint.framePosition / input.getSampleRate());
+
+    auto start = std::chrono::steady_clock::now();
+    bool checkpointsOk = renderer.render(input, output, resuming ? &checkpoint : nullptr);
+    output.close();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!checkpointsOk)
+        std::fprintf(stderr, "wdfrender: %s\n", renderer.getError().c_str());
+    else if (!checkpointPath.empty())
+        std::remove(checkpointPath.c_str());
+
+    double audioSeconds = (double)renderer.getFramesRendered() / input.getSampleRate();
+    std::printf("rendered %.1f s of audio in %.3f s (%.1fx real time)\n",
+                audioSeconds, seconds, seconds > 0.0 ? audioSeconds / seconds : 0.0);
+    return checkpointsOk ? 0 : 1;
+}
@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+    WdfTriodeBench.cpp
+    Created: 19 Oct 2026 12:58:33am
+    Author:  Richie Haynes
+
+    Cost of a three-stage 12AX7 preamp (WDFTriodeStageCircuit x 3, with an
+    interstage attenuator standing in for a volume pot) run oversampled. A
+    decaying plucked-string tone is synthesised at the oversampled rate and
+    the output is decimated by averaging, so only the circuits are timed; a
+    plug-in adds its own resampling filters. The result is reported per
+    base-rate sample against a budget, and the tool exits with status 1 when
+    the budget is exceeded, e.g.
+
+        c++ -std=c++17 -O2 -ISource Tools/WdfTriodeBench.cpp -o wdftriodebench
+        ./wdftriodebench --oversample 2 --budget 10000
+
+    usage: wdftriodebench [--seconds s] [--rate hz] [--oversample n] [--level volts]
+                          [--interstage gain] [--budget ns] [--exact] [--newton]
+
+  ==============================================================================
+*/
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include "WdfTriode.h"
+
+static int usage()
+{
+    std::fprintf(stderr, "usage: wdftriodebench [--seconds s] [--rate hz] [--oversample n] [--level volts] "
+                         "[--interstage gain] [--budget ns] [--exact] [--newton]\n");
+    return 2;
+}
+
+int main(int argc, char** argv)
+{
+    double seconds = 10.0;
+    double sampleRate = 48000.0;
+    int oversample = 2;
+    double level = 0.5;
+    double interstage = 0.05;
+    double budget = 10000.0;
+    bool exact = false;
+    bool newton = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--seconds" && hasValue)
+            seconds = std::atof(argv[++i]);
+        else if (arg == "--rate" && hasValue)
+            sampleRate = std::atof(argv[++i]);
+        else if (arg == "--oversample" && hasValue)
+            oversample = std::atoi(argv[++i]);
+        else if (arg == "--level" && hasValue)
+            level = std::atof(argv[++i]);
+        else if (arg == "--interstage" && hasValue)
+            interstage = std::atof(argv[++i]);
+        else if (arg == "--budget" && hasValue)
+            budget = std::atof(argv[++i]);
+        else if (arg == "--exact")
+            exact = true;
+        else if (arg == "--newton")
+            newton = true;
+        else
+            return usage();
+    }
+
+    if (seconds <= 0.0 || sampleRate <= 0.0 || oversample < 1)
+        return usage();
+
+    // --- the shared tube model is built here, off the timed loop
+    const WdfTriodeModel& model = WdfTriodeModel::twelveAX7();
+    std::printf("12AX7 tables: %zu bytes, softplus error %.3g, power error %.3g (relative)\n",
+                WdfTriodeModel::getMemorySize(), model.getSoftplusError(), model.getPowerError());
+
+    const int numStages = 3;
+    const double circuitRate = sampleRate * oversample;
+    WDFTriodeStageCircuit stages[numStages];
+    for (WDFTriodeStageCircuit& stage : stages)
+    {
+        stage.getTriode().setUseTables(!exact);
+        if (newton)
+            stage.getRoot().setJacobianUpdate(WdfNewtonRoot::JacobianUpdate::everyIteration);
+        stage.reset(circuitRate);
+    }
+
+    // --- a pluck every half second: a few harmonics of 110 Hz with an exponential decay
+    const long numSamples = (long)(seconds * sampleRate);
+    const long pluckPeriod = (long)(0.5 * circuitRate);
+    const double decay = std::exp(-1.0 / (0.3 * circuitRate));
+    const double phaseStep = 2.0 * M_PI * 110.0 / circuitRate;
+    double envelope = 0.0;
+    double sink = 0.0;
+    long n = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < numSamples; i++)
+    {
+        double sum = 0.0;
+        for (int k = 0; k < oversample; k++, n++)
+        {
+            envelope = n % pluckPeriod == 0 ? level : envelope * decay;
+            const double phase = phaseStep * (double)(n % pluckPeriod);
+            double xn = envelope * (std::sin(phase) + 0.5 * std::sin(2.0 * phase) + 0.25 * std::sin(3.0 * phase));
+
+            for (int s = 0; s < numStages; s++)
+                xn = stages[s].processAudioSample(xn) * (s + 1 < numStages ? interstage : 1.0);
+            sum += xn;
+        }
+        sink += sum / oversample;
+    }
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double cost = 1.0e9 * elapsed / (double)numSamples;
+
+    std::printf("%d stages at %g Hz (%dx), tables %s, %s Jacobian\n\n", numStages, circuitRate, oversample,
+                exact ? "off" : "on", newton ? "Newton" : "Broyden");
+    std::printf("stage   iterations/solve   max   Jacobians/solve   failures\n");
+    for (int s = 0; s < numStages; s++)
+    {
+        const WdfNewtonRoot::Statistics& statistics = stages[s].getRoot().getStatistics();
+        const double solves = (double)std::max<uint64_t>(1, statistics.solves);
+        std::printf("%5d %18.2f %5d %17.2f %10llu\n", s + 1, (double)statistics.iterations / solves, statistics.maxIterationsUsed,
+                    (double)statistics.jacobianEvaluations / solves, (unsigned long long)statistics.failures);
+    }
+
+    const double period = 1.0e9 / sampleRate;
+    std::printf("\n%.1f ns per %g Hz sample (%.1f%% of real time), budget %.0f ns: %s\n", cost, sampleRate,
+                100.0 * cost / period, budget, cost <= budget ? "within" : "OVER");
+    std::printf("(output sum %g)\n", sink);
+    return cost <= budget ? 0 : 1;
+}